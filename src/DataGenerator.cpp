@@ -2,9 +2,9 @@
 #include "DataGenerator.h"
 #include <random>
 
-std::vector<RTree::Point> DataGenerator::generateUniformData(int numPoints)
+std::vector<RTree::Point<2>> DataGenerator::generateUniformData(int numPoints)
 {
-    std::vector<RTree::Point> points;
+    std::vector<RTree::Point<2>> points;
 
     // 使用随机数生成器生成均匀分布的数据
     std::random_device rd;
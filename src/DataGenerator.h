@@ -9,7 +9,7 @@ class DataGenerator
 {
 public:
     // 生成均匀分布的数据
-    std::vector<RTree::Point> generateUniformData(int numPoints);
+    std::vector<RTree::Point<2>> generateUniformData(int numPoints);
     // 可扩展：生成高斯分布、聚簇数据等
 };
 
@@ -0,0 +1,188 @@
+#include "BufferPool.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace RTree
+{
+
+    BufferPool::BufferPool(const std::string &path, size_t pageSize, size_t frameCount, bool create)
+        : m_pageSize(pageSize), m_memory(nullptr), m_clockHand(0), m_pageCount(0)
+    {
+        if (frameCount == 0 || pageSize == 0)
+        {
+            throw std::invalid_argument("buffer pool needs at least one frame");
+        }
+
+        std::ios::openmode mode = std::ios::in | std::ios::out | std::ios::binary;
+        if (create)
+        {
+            mode |= std::ios::trunc;
+        }
+        m_file.open(path, mode);
+        if (!m_file)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        m_file.seekg(0, std::ios::end);
+        m_pageCount = static_cast<uint64_t>(m_file.tellg()) / m_pageSize;
+
+        // 帧按64字节对齐
+        const size_t alignment = 64;
+        m_storage.reset(new unsigned char[frameCount * m_pageSize + alignment]);
+        uintptr_t address = reinterpret_cast<uintptr_t>(m_storage.get());
+        m_memory = m_storage.get() + (alignment - address % alignment) % alignment;
+        m_frames.resize(frameCount, Frame{0, 0, false, false, false});
+    }
+
+    BufferPool::~BufferPool()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            // 析构时无法报告写回失败
+        }
+    }
+
+    unsigned char *BufferPool::pin(uint64_t pageId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_pageTable.find(pageId);
+        if (it != m_pageTable.end())
+        {
+            Frame &frame = m_frames[it->second];
+            frame.pinCount++;
+            frame.referenced = true;
+            m_stats.hits++;
+            return frameData(it->second);
+        }
+
+        if (pageId >= m_pageCount)
+        {
+            throw std::out_of_range("page id out of range");
+        }
+        size_t index = acquireFrame();
+        m_file.clear();
+        m_file.seekg(static_cast<std::streamoff>(pageId * m_pageSize));
+        m_file.read(reinterpret_cast<char *>(frameData(index)), static_cast<std::streamsize>(m_pageSize));
+        if (!m_file)
+        {
+            throw std::runtime_error("failed to read page");
+        }
+        m_stats.misses++;
+
+        Frame &frame = m_frames[index];
+        frame = Frame{pageId, 1, false, true, true};
+        m_pageTable[pageId] = index;
+        return frameData(index);
+    }
+
+    void BufferPool::unpin(uint64_t pageId, bool dirty)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_pageTable.find(pageId);
+        if (it == m_pageTable.end() || m_frames[it->second].pinCount == 0)
+        {
+            throw std::logic_error("unpin of a page that is not pinned");
+        }
+        Frame &frame = m_frames[it->second];
+        frame.pinCount--;
+        frame.dirty = frame.dirty || dirty;
+    }
+
+    unsigned char *BufferPool::allocate(uint64_t &pageId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t index = acquireFrame();
+        pageId = m_pageCount++;
+        std::memset(frameData(index), 0, m_pageSize);
+
+        Frame &frame = m_frames[index];
+        frame = Frame{pageId, 1, true, true, true};
+        m_pageTable[pageId] = index;
+        return frameData(index);
+    }
+
+    void BufferPool::flush()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < m_frames.size(); i++)
+        {
+            if (m_frames[i].valid && m_frames[i].dirty)
+            {
+                writeFrame(i);
+            }
+        }
+        m_file.flush();
+    }
+
+    uint64_t BufferPool::getPageCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pageCount;
+    }
+
+    BufferPoolStats BufferPool::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void BufferPool::resetStats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats = BufferPoolStats();
+    }
+
+    size_t BufferPool::acquireFrame()
+    {
+        // CLOCK：指针转过访问位为1的帧时清零，遇到访问位为0且未被固定的帧即淘汰。
+        // 转两圈仍找不到说明所有帧都被固定
+        for (size_t step = 0; step < 2 * m_frames.size(); step++)
+        {
+            size_t index = m_clockHand;
+            m_clockHand = (m_clockHand + 1) % m_frames.size();
+            Frame &frame = m_frames[index];
+            if (!frame.valid)
+            {
+                return index;
+            }
+            if (frame.pinCount > 0)
+            {
+                continue;
+            }
+            if (frame.referenced)
+            {
+                frame.referenced = false;
+                continue;
+            }
+
+            if (frame.dirty)
+            {
+                writeFrame(index);
+            }
+            m_pageTable.erase(frame.pageId);
+            frame.valid = false;
+            m_stats.evictions++;
+            return index;
+        }
+        throw std::runtime_error("buffer pool exhausted: all frames are pinned");
+    }
+
+    void BufferPool::writeFrame(size_t index)
+    {
+        Frame &frame = m_frames[index];
+        m_file.clear();
+        m_file.seekp(static_cast<std::streamoff>(frame.pageId * m_pageSize));
+        m_file.write(reinterpret_cast<const char *>(frameData(index)), static_cast<std::streamsize>(m_pageSize));
+        if (!m_file)
+        {
+            throw std::runtime_error("failed to write page");
+        }
+        frame.dirty = false;
+        m_stats.writes++;
+    }
+
+} // namespace RTree
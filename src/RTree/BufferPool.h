@@ -0,0 +1,106 @@
+#ifndef RTREE_BUFFER_POOL_H
+#define RTREE_BUFFER_POOL_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <unordered_map>
+#include <cstdint>
+
+namespace RTree
+{
+
+    // 缓冲池的访问统计
+    struct BufferPoolStats
+    {
+        size_t hits;       // 页已在缓冲池中
+        size_t misses;     // 需要从文件读入
+        size_t evictions;  // 为腾出帧而淘汰的页
+        size_t writes;     // 写回文件的脏页（淘汰或flush）
+
+        BufferPoolStats() : hits(0), misses(0), evictions(0), writes(0) {}
+    };
+
+    // 定长页的缓冲池 - 文件中的页按需读入有限个帧，满时用CLOCK算法淘汰未被固定(pin)的页，
+    // 脏页在淘汰或flush时写回。帧按64字节对齐，页内的SoA边界数组可以直接交给SIMD内核。
+    // 所有操作由一把锁保护；被pin的页在unpin之前不会被淘汰，调用者可以在锁外读写其内容。
+    class BufferPool
+    {
+    public:
+        // 打开已有文件（create为false）或创建/截断文件；frameCount为帧数
+        BufferPool(const std::string &path, size_t pageSize, size_t frameCount, bool create);
+        ~BufferPool();
+
+        BufferPool(const BufferPool &) = delete;
+        BufferPool &operator=(const BufferPool &) = delete;
+
+        // 固定页并返回其内容；所有帧都被固定时抛出std::runtime_error
+        unsigned char *pin(uint64_t pageId);
+        void unpin(uint64_t pageId, bool dirty);
+
+        // 在文件末尾分配一个清零的新页，返回时已被固定且标记为脏
+        unsigned char *allocate(uint64_t &pageId);
+
+        // 把所有脏页写回文件
+        void flush();
+
+        size_t getPageSize() const { return m_pageSize; }
+        size_t getFrameCount() const { return m_frames.size(); }
+        uint64_t getPageCount() const;
+        BufferPoolStats getStats() const;
+        void resetStats();
+
+    private:
+        struct Frame
+        {
+            uint64_t pageId;
+            size_t pinCount;
+            bool dirty;
+            bool referenced; // CLOCK的访问位
+            bool valid;
+        };
+
+        size_t m_pageSize;
+        std::unique_ptr<unsigned char[]> m_storage; // 全部帧的内存（含对齐余量）
+        unsigned char *m_memory;                    // 按64字节对齐的帧数组起点
+        std::vector<Frame> m_frames;
+        std::unordered_map<uint64_t, size_t> m_pageTable; // 页号 -> 帧号
+        size_t m_clockHand;
+        uint64_t m_pageCount;
+        std::fstream m_file;
+        BufferPoolStats m_stats;
+        mutable std::mutex m_mutex;
+
+        unsigned char *frameData(size_t frame) const { return m_memory + frame * m_pageSize; }
+        // 找到一个空闲帧或淘汰一页，调用者持有锁
+        size_t acquireFrame();
+        void writeFrame(size_t frame);
+    };
+
+    // 页固定的RAII守卫
+    class PageGuard
+    {
+    public:
+        PageGuard(BufferPool &pool, uint64_t pageId)
+            : m_pool(pool), m_pageId(pageId), m_data(pool.pin(pageId)), m_dirty(false) {}
+        ~PageGuard() { m_pool.unpin(m_pageId, m_dirty); }
+
+        PageGuard(const PageGuard &) = delete;
+        PageGuard &operator=(const PageGuard &) = delete;
+
+        unsigned char *data() const { return m_data; }
+        uint64_t getPageId() const { return m_pageId; }
+        void markDirty() { m_dirty = true; }
+
+    private:
+        BufferPool &m_pool;
+        uint64_t m_pageId;
+        unsigned char *m_data;
+        bool m_dirty;
+    };
+
+} // namespace RTree
+
+#endif // RTREE_BUFFER_POOL_H
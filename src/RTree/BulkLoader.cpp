@@ -0,0 +1,135 @@
+#include "BulkLoader.h"
+#include <algorithm>
+#include <cmath>
+
+namespace RTree
+{
+
+    void chunkGroups(size_t begin, size_t end, size_t capacity, size_t minEntries, std::vector<size_t> &groupEnds)
+    {
+        size_t firstGroup = groupEnds.size();
+        for (size_t pos = begin; pos < end; pos += capacity)
+        {
+            groupEnds.push_back(std::min(pos + capacity, end));
+        }
+
+        // 末组过小：与前一组合并后均分，两组都不少于minEntries
+        size_t groups = groupEnds.size() - firstGroup;
+        if (groups >= 2)
+        {
+            size_t lastEnd = groupEnds[groupEnds.size() - 1];
+            size_t prevEnd = groupEnds[groupEnds.size() - 2];
+            size_t prevBegin = prevEnd - capacity;
+            if (lastEnd - prevEnd < minEntries)
+            {
+                groupEnds[groupEnds.size() - 2] = prevBegin + (lastEnd - prevBegin + 1) / 2;
+            }
+        }
+    }
+
+    template <size_t D>
+    void STRBulkLoadStrategy<D>::partition(std::vector<Entry<D>> &entries,
+                                           size_t capacity,
+                                           size_t minEntries,
+                                           std::vector<size_t> &groupEnds)
+    {
+        groupEnds.clear();
+        if (entries.empty())
+        {
+            return;
+        }
+
+        tile(entries, 0, entries.size(), 0, entries[0].m_region.getDimension(), capacity, minEntries, groupEnds);
+    }
+
+    template <size_t D>
+    void STRBulkLoadStrategy<D>::tile(std::vector<Entry<D>> &entries, size_t begin, size_t end, size_t dim,
+                                      size_t dimension, size_t capacity, size_t minEntries,
+                                      std::vector<size_t> &groupEnds)
+    {
+        size_t count = end - begin;
+
+        // 按当前维度的中心坐标排序（low+high与中心同序，省去除法）
+        std::sort(entries.begin() + begin, entries.begin() + end,
+                  [dim](const Entry<D> &a, const Entry<D> &b)
+                  {
+                      return a.m_region.m_low[dim] + a.m_region.m_high[dim] <
+                             b.m_region.m_low[dim] + b.m_region.m_high[dim];
+                  });
+
+        // 最后一维（或剩余条目只够一个节点）：直接切成节点
+        if (dim + 1 >= dimension || count <= capacity)
+        {
+            chunkGroups(begin, end, capacity, minEntries, groupEnds);
+            return;
+        }
+
+        // P个节点分成S个切片，每片含ceil(P/S)个节点，在剩余维度上递归
+        size_t pages = (count + capacity - 1) / capacity;
+        size_t slices = static_cast<size_t>(std::ceil(std::pow(static_cast<double>(pages), 1.0 / (dimension - dim))));
+        size_t sliceSize = capacity * ((pages + slices - 1) / slices);
+
+        for (size_t pos = begin; pos < end; pos += sliceSize)
+        {
+            // 末片不足一个最小节点时并入当前片，避免产生过小的节点
+            size_t sliceEnd = std::min(pos + sliceSize, end);
+            if (end - sliceEnd < minEntries)
+            {
+                sliceEnd = end;
+            }
+            tile(entries, pos, sliceEnd, dim + 1, dimension, capacity, minEntries, groupEnds);
+            if (sliceEnd == end)
+            {
+                break;
+            }
+        }
+    }
+
+    template <size_t D>
+    void HilbertBulkLoadStrategy<D>::partition(std::vector<Entry<D>> &entries,
+                                               size_t capacity,
+                                               size_t minEntries,
+                                               std::vector<size_t> &groupEnds)
+    {
+        groupEnds.clear();
+        if (entries.empty())
+        {
+            return;
+        }
+
+        // 叶子层：计算每个条目中心的Hilbert值；上层条目已带有子树的LHV
+        if (entries[0].isLeaf)
+        {
+            HilbertCurve<D> curve = m_curve;
+            if (!curve.isValid())
+            {
+                Region<D> world;
+                for (const auto &entry : entries)
+                {
+                    world.combineRegion(entry.m_region);
+                }
+                curve = HilbertCurve<D>(world);
+            }
+
+            for (auto &entry : entries)
+            {
+                entry.m_hilbertValue = curve.value(entry.m_region);
+            }
+        }
+
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const Entry<D> &a, const Entry<D> &b)
+                         { return a.m_hilbertValue < b.m_hilbertValue; });
+
+        chunkGroups(0, entries.size(), capacity, minEntries, groupEnds);
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class STRBulkLoadStrategy<DynamicDimension>;
+    template class STRBulkLoadStrategy<2>;
+    template class STRBulkLoadStrategy<3>;
+    template class HilbertBulkLoadStrategy<DynamicDimension>;
+    template class HilbertBulkLoadStrategy<2>;
+    template class HilbertBulkLoadStrategy<3>;
+
+} // namespace RTree
@@ -0,0 +1,68 @@
+#ifndef RTREE_BULK_LOADER_H
+#define RTREE_BULK_LOADER_H
+
+#include <vector>
+#include <string>
+#include "Entry.h"
+#include "HilbertCurve.h"
+
+namespace RTree
+{
+
+    // 批量装载策略接口 - 将同一层的条目划分为若干节点
+    // partition就地重排entries，并在groupEnds中输出每组的结束下标（不含），
+    // 每组条目数不超过capacity，且除整层不足一个节点外不少于minEntries
+    template <size_t D = DynamicDimension>
+    class BulkLoadStrategy
+    {
+    public:
+        virtual ~BulkLoadStrategy() = default;
+        virtual void partition(std::vector<Entry<D>> &entries,
+                               size_t capacity,
+                               size_t minEntries,
+                               std::vector<size_t> &groupEnds) = 0;
+        virtual std::string getName() const = 0;
+    };
+
+    // Sort-Tile-Recursive装载：按中心坐标逐维排序切片，最后一维切成满节点
+    template <size_t D = DynamicDimension>
+    class STRBulkLoadStrategy : public BulkLoadStrategy<D>
+    {
+    public:
+        void partition(std::vector<Entry<D>> &entries,
+                       size_t capacity,
+                       size_t minEntries,
+                       std::vector<size_t> &groupEnds) override;
+        std::string getName() const override { return "STR"; }
+
+    private:
+        void tile(std::vector<Entry<D>> &entries, size_t begin, size_t end, size_t dim, size_t dimension,
+                  size_t capacity, size_t minEntries, std::vector<size_t> &groupEnds);
+    };
+
+    // Hilbert装载：叶子层按条目中心的Hilbert值排序后顺序打包，
+    // 上层按子树最大Hilbert值(LHV)排序，保证整棵树沿Hilbert曲线有序。
+    // 未指定曲线时以本层数据的MBR作为曲线的空间范围
+    template <size_t D = DynamicDimension>
+    class HilbertBulkLoadStrategy : public BulkLoadStrategy<D>
+    {
+    public:
+        HilbertBulkLoadStrategy() {}
+        explicit HilbertBulkLoadStrategy(const HilbertCurve<D> &curve) : m_curve(curve) {}
+
+        void partition(std::vector<Entry<D>> &entries,
+                       size_t capacity,
+                       size_t minEntries,
+                       std::vector<size_t> &groupEnds) override;
+        std::string getName() const override { return "Hilbert"; }
+
+    private:
+        HilbertCurve<D> m_curve;
+    };
+
+    // 把[begin, end)按capacity切成连续的组；末组不足minEntries时与前一组均分
+    void chunkGroups(size_t begin, size_t end, size_t capacity, size_t minEntries, std::vector<size_t> &groupEnds);
+
+} // namespace RTree
+
+#endif // RTREE_BULK_LOADER_H
@@ -0,0 +1,181 @@
+#include "DurableRTree.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace RTree
+{
+
+    template <size_t D>
+    DurableRTree<D>::DurableRTree(const std::string &basePath, size_t maxEntries, WalOptions options,
+                                  const std::function<void *(id_type)> &resolve)
+        : m_basePath(basePath), m_tree(maxEntries), m_log(basePath + ".wal", options), m_nextID(1)
+    {
+        recover(resolve);
+        m_tree.setConcurrencyMode(ConcurrencyMode::Optimistic);
+    }
+
+    template <size_t D>
+    DurableRTree<D>::~DurableRTree()
+    {
+        try
+        {
+            m_log.flush();
+        }
+        catch (...)
+        {
+            // 析构时无法报告写盘失败
+        }
+    }
+
+    template <size_t D>
+    void DurableRTree<D>::recover(const std::function<void *(id_type)> &resolve)
+    {
+        // 日志头中的序号指向对应的检查点；崩溃在检查点中途留下的更新检查点没有生效，删除即可
+        uint64_t serial = m_log.getSerial();
+        std::remove(getCheckpointPath(serial + 1).c_str());
+
+        id_type maxID = 0;
+        auto resolveAndTrack = [&](id_type id) -> void *
+        {
+            maxID = std::max(maxID, id);
+            return resolve ? resolve(id) : nullptr;
+        };
+        if (serial > 0)
+        {
+            m_tree.load(getCheckpointPath(serial), resolveAndTrack);
+        }
+
+        m_log.replay([&](const unsigned char *payload, size_t size)
+                     {
+                         if (size < 16)
+                         {
+                             throw std::runtime_error("corrupt write-ahead log record");
+                         }
+                         uint64_t id;
+                         std::memcpy(&id, payload + 8, sizeof(id));
+
+                         uint32_t dimension;
+                         std::memcpy(&dimension, payload + 1, sizeof(dimension));
+                         if (size != 16 + 2 * dimension * sizeof(double) || (D != DynamicDimension && dimension != D))
+                         {
+                             throw std::runtime_error("corrupt write-ahead log record");
+                         }
+                         std::vector<double> low(dimension), high(dimension);
+                         std::memcpy(low.data(), payload + 16, dimension * sizeof(double));
+                         std::memcpy(high.data(), payload + 16 + dimension * sizeof(double), dimension * sizeof(double));
+                         Region<D> mbr(low, high);
+
+                         if (payload[0] == InsertRecord)
+                         {
+                             m_tree.insert(static_cast<id_type>(id), resolveAndTrack(static_cast<id_type>(id)), 0, mbr);
+                         }
+                         else if (payload[0] == RemoveRecord)
+                         {
+                             m_tree.remove(static_cast<id_type>(id), mbr);
+                         }
+                         else
+                         {
+                             throw std::runtime_error("corrupt write-ahead log record");
+                         } });
+        // 检查点之前分配过、又被删除的ID只记录在日志头中
+        m_nextID = std::max(maxID + 1, static_cast<id_type>(m_log.getUserValue()));
+    }
+
+    template <size_t D>
+    uint64_t DurableRTree<D>::appendRecord(RecordType type, id_type id, const Region<D> *mbr)
+    {
+        // 布局：类型(1) 维度(4) 填充(3) ID(8) 下界 上界
+        uint32_t dimension = mbr ? static_cast<uint32_t>(mbr->getDimension()) : 0;
+        unsigned char record[16 + 2 * 64 * sizeof(double)];
+        std::vector<unsigned char> large;
+        size_t size = 16 + 2 * dimension * sizeof(double);
+        unsigned char *payload = record;
+        if (size > sizeof(record))
+        {
+            large.resize(size);
+            payload = large.data();
+        }
+
+        uint64_t value = id;
+        std::memset(payload, 0, 16);
+        payload[0] = type;
+        std::memcpy(payload + 1, &dimension, sizeof(dimension));
+        std::memcpy(payload + 8, &value, sizeof(value));
+        if (mbr)
+        {
+            std::memcpy(payload + 16, mbr->m_low.data(), dimension * sizeof(double));
+            std::memcpy(payload + 16 + dimension * sizeof(double), mbr->m_high.data(), dimension * sizeof(double));
+        }
+        return m_log.append(payload, size);
+    }
+
+    template <size_t D>
+    id_type DurableRTree<D>::insert(void *data, size_t dataSize, const Region<D> &mbr)
+    {
+        // 先提交日志再修改树：读者看到的修改都已持久化。共享锁一直持有到修改完成，
+        // 检查点不会落在“已写日志、未改树”的中间状态
+        id_type id = m_nextID++;
+        std::shared_lock<std::shared_timed_mutex> lock(m_checkpointLatch);
+        m_log.commit(appendRecord(InsertRecord, id, &mbr));
+        m_tree.insert(id, data, dataSize, mbr);
+        return id;
+    }
+
+    template <size_t D>
+    std::vector<id_type> DurableRTree<D>::insertBatch(const std::vector<std::pair<Region<D>, void *>> &items)
+    {
+        std::vector<id_type> ids(items.size());
+        if (items.empty())
+        {
+            return ids;
+        }
+
+        std::shared_lock<std::shared_timed_mutex> lock(m_checkpointLatch);
+        uint64_t lsn = 0;
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            ids[i] = m_nextID++;
+            lsn = appendRecord(InsertRecord, ids[i], &items[i].first);
+        }
+        m_log.commit(lsn);
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            m_tree.insert(ids[i], items[i].second, 0, items[i].first);
+        }
+        return ids;
+    }
+
+    template <size_t D>
+    bool DurableRTree<D>::remove(id_type id, const Region<D> &mbr)
+    {
+        // 同样先提交再修改；没有找到条目时日志中留下一条重放时无效的删除记录
+        std::shared_lock<std::shared_timed_mutex> lock(m_checkpointLatch);
+        m_log.commit(appendRecord(RemoveRecord, id, &mbr));
+        return m_tree.remove(id, mbr);
+    }
+
+    template <size_t D>
+    void DurableRTree<D>::checkpoint()
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(m_checkpointLatch);
+        // 先让已追加的记录落盘，等待中的提交者都能返回
+        m_log.flush();
+
+        uint64_t serial = m_log.getSerial() + 1;
+        std::string path = getCheckpointPath(serial);
+        m_tree.save(path);
+        WriteAheadLog::syncFile(path);
+
+        // 新日志（头中带有下一个可用ID）持久生效即检查点生效，之后旧检查点不再需要
+        m_log.reset(serial, m_nextID);
+        std::remove(getCheckpointPath(serial - 1).c_str());
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class DurableRTree<DynamicDimension>;
+    template class DurableRTree<2>;
+    template class DurableRTree<3>;
+
+} // namespace RTree
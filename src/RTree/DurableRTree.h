@@ -0,0 +1,68 @@
+#ifndef RTREE_DURABLE_RTREE_H
+#define RTREE_DURABLE_RTREE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
+#include "RTree.h"
+#include "WriteAheadLog.h"
+
+namespace RTree
+{
+
+    // 持久化的R-tree - 内存中的RTree（乐观并发模式）加预写日志。每次insert/remove先把记录写入日志并提交，
+    // 之后才修改树，因此查询看到的修改都已持久化；多个写线程的提交合并为一次sync（组提交），
+    // insertBatch让一批插入共享一次提交。崩溃后重新打开时载入最近的检查点（RTree::save格式）再重放日志。
+    // 文件为basePath.wal（日志）与basePath.ckpt<序号>（检查点）；检查点时的下一个可用ID写在新日志的文件头中，
+    // 被删除条目的ID在恢复后也不会被重新分配。
+    // 数据指针不能持久化，恢复时由resolve(id)把ID映射回数据；查询通过getTree()进行，可与写操作并发
+    template <size_t D = DynamicDimension>
+    class DurableRTree
+    {
+    public:
+        DurableRTree(const std::string &basePath, size_t maxEntries = 8, WalOptions options = WalOptions(),
+                     const std::function<void *(id_type)> &resolve = nullptr);
+        // 提交所有日志记录（不做检查点）
+        ~DurableRTree();
+
+        DurableRTree(const DurableRTree &) = delete;
+        DurableRTree &operator=(const DurableRTree &) = delete;
+
+        // 插入并返回数据的ID；日志提交后才插入树中，可以在多个线程中同时调用
+        id_type insert(void *data, size_t dataSize, const Region<D> &mbr);
+        // 批量插入：items为(MBR, 数据)，所有记录一次提交（一次写盘）后再插入树中，返回的ID与items一一对应
+        std::vector<id_type> insertBatch(const std::vector<std::pair<Region<D>, void *>> &items);
+        // 删除；日志提交后才从树中删除，返回是否找到并删除了条目
+        bool remove(id_type id, const Region<D> &mbr);
+
+        // 把当前树写为新检查点并换成空日志，之后恢复只需重放新的记录。期间写操作等待
+        void checkpoint();
+
+        const ::RTree::RTree<D> &getTree() const { return m_tree; }
+        WalStats getLogStats() const { return m_log.getStats(); }
+        std::string getCheckpointPath(uint64_t serial) const { return m_basePath + ".ckpt" + std::to_string(serial); }
+
+    private:
+        std::string m_basePath;
+        ::RTree::RTree<D> m_tree;
+        WriteAheadLog m_log;
+        std::atomic<id_type> m_nextID;
+        // 写操作持有共享锁完成“修改树 + 追加日志”，检查点持有独占锁，保证检查点与日志的分界一致
+        std::shared_timed_mutex m_checkpointLatch;
+
+        // 日志记录：类型、ID、MBR
+        enum RecordType : uint8_t
+        {
+            InsertRecord = 1,
+            RemoveRecord = 2
+        };
+        uint64_t appendRecord(RecordType type, id_type id, const Region<D> *mbr);
+        void recover(const std::function<void *(id_type)> &resolve);
+    };
+
+} // namespace RTree
+
+#endif // RTREE_DURABLE_RTREE_H
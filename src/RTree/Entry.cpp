@@ -2,15 +2,22 @@
 
 namespace RTree {
 
-double Entry::getEnlargement(const Region& r) const {
+template <size_t D>
+double Entry<D>::getEnlargement(const Region<D>& r) const {
     // 计算扩展区域后的面积增加量
-    Region combined = m_region;
+    Region<D> combined = m_region;
     combined.combineRegion(r);
     return combined.getArea() - m_region.getArea();
 }
 
-double Entry::getOverlap(const Entry& other) const {
+template <size_t D>
+double Entry<D>::getOverlap(const Entry& other) const {
     return m_region.getIntersectingArea(other.m_region);
 }
 
-} // namespace RTree 
\ No newline at end of file
+// 显式实例化：动态维度以及常用的2D/3D
+template class Entry<DynamicDimension>;
+template class Entry<2>;
+template class Entry<3>;
+
+} // namespace RTree
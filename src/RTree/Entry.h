@@ -1,43 +1,47 @@
 #ifndef RTREE_ENTRY_H
 #define RTREE_ENTRY_H
 
+#include <cstdint>
 #include "Region.h"
 
 namespace RTree
 {
 
     // 前向声明
+    template <size_t D>
     class Node;
     typedef size_t id_type;
 
     // 条目类 - 树节点的基本单元
+    template <size_t D = DynamicDimension>
     class Entry
     {
     public:
-        Region m_region; // 空间区域/MBR
-        id_type m_id;    // 唯一标识符
+        Region<D> m_region; // 空间区域/MBR
+        id_type m_id;       // 唯一标识符
 
         // 替换union，使用普通成员变量
         bool isLeaf;
-        Node *m_childNode; // 内部节点：子节点指针
-        void *m_data;      // 叶子节点：数据指针
-        size_t m_dataSize; // 叶子节点：数据大小
+        Node<D> *m_childNode;    // 内部节点：子节点指针
+        void *m_data;            // 叶子节点：数据指针
+        size_t m_dataSize;       // 叶子节点：数据大小
+        uint64_t m_hilbertValue; // Hilbert模式：叶子条目为中心的Hilbert值，内部条目为子树最大Hilbert值(LHV)
 
         // 默认构造函数
-        Entry() : m_id(0), isLeaf(false), m_childNode(nullptr), m_data(nullptr), m_dataSize(0) {}
+        Entry() : m_id(0), isLeaf(false), m_childNode(nullptr), m_data(nullptr), m_dataSize(0), m_hilbertValue(0) {}
 
         // 叶子节点的构造函数
-        Entry(const Region &region, id_type id, void *data, size_t size)
-            : m_region(region), m_id(id), isLeaf(true), m_childNode(nullptr), m_data(data), m_dataSize(size) {}
+        Entry(const Region<D> &region, id_type id, void *data, size_t size)
+            : m_region(region), m_id(id), isLeaf(true), m_childNode(nullptr), m_data(data), m_dataSize(size), m_hilbertValue(0) {}
 
         // 内部节点的构造函数
-        Entry(const Region &region, id_type id, Node *child)
-            : m_region(region), m_id(id), isLeaf(false), m_childNode(child), m_data(nullptr), m_dataSize(0) {}
+        Entry(const Region<D> &region, id_type id, Node<D> *child)
+            : m_region(region), m_id(id), isLeaf(false), m_childNode(child), m_data(nullptr), m_dataSize(0), m_hilbertValue(0) {}
 
-        double getEnlargement(const Region &r) const;
+        double getEnlargement(const Region<D> &r) const;
         double getOverlap(const Entry &other) const;
     };
 
 } // namespace RTree
 
-#endif // RTREE_ENTRY_H
\ No newline at end of file
+#endif // RTREE_ENTRY_H
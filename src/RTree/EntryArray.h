@@ -0,0 +1,130 @@
+#ifndef RTREE_ENTRY_ARRAY_H
+#define RTREE_ENTRY_ARRAY_H
+
+#include <vector>
+#include <new>
+#include <utility>
+#include <stdexcept>
+#include "Entry.h"
+
+namespace RTree
+{
+
+    // 节点的条目数组 - 容量固定，存储由节点所在的slab块提供（紧跟在节点对象之后），
+    // 本身不申请堆内存。接口与std::vector的常用部分一致；容量在创建时确定，
+    // 之后条目不会搬家（乐观并发模式下读者可能同时读取）
+    template <size_t D = DynamicDimension>
+    class EntryArray
+    {
+    public:
+        EntryArray(Entry<D> *storage, size_t capacity) : m_data(storage), m_size(0), m_capacity(capacity) {}
+        ~EntryArray() { clear(); }
+
+        EntryArray(const EntryArray &) = delete;
+        EntryArray &operator=(const EntryArray &) = delete;
+
+        size_t size() const { return m_size; }
+        size_t capacity() const { return m_capacity; }
+        bool empty() const { return m_size == 0; }
+
+        Entry<D> &operator[](size_t index) { return m_data[index]; }
+        const Entry<D> &operator[](size_t index) const { return m_data[index]; }
+        Entry<D> &back() { return m_data[m_size - 1]; }
+        Entry<D> *begin() { return m_data; }
+        Entry<D> *end() { return m_data + m_size; }
+        const Entry<D> *begin() const { return m_data; }
+        const Entry<D> *end() const { return m_data + m_size; }
+        const Entry<D> *data() const { return m_data; }
+
+        void push_back(const Entry<D> &entry)
+        {
+            checkCapacity();
+            new (m_data + m_size) Entry<D>(entry);
+            m_size++;
+        }
+
+        void push_back(Entry<D> &&entry)
+        {
+            checkCapacity();
+            new (m_data + m_size) Entry<D>(std::move(entry));
+            m_size++;
+        }
+
+        // 在index处插入，之后的条目后移一位
+        void insert(size_t index, const Entry<D> &entry)
+        {
+            if (index == m_size)
+            {
+                push_back(entry);
+                return;
+            }
+            checkCapacity();
+            new (m_data + m_size) Entry<D>(std::move(m_data[m_size - 1]));
+            for (size_t i = m_size - 1; i > index; i--)
+            {
+                m_data[i] = std::move(m_data[i - 1]);
+            }
+            m_data[index] = entry;
+            m_size++;
+        }
+
+        // 删除index处的条目，之后的条目前移一位
+        void erase(size_t index)
+        {
+            for (size_t i = index; i + 1 < m_size; i++)
+            {
+                m_data[i] = std::move(m_data[i + 1]);
+            }
+            m_data[m_size - 1].~Entry<D>();
+            m_size--;
+        }
+
+        // 只保留前count个条目
+        void truncate(size_t count)
+        {
+            while (m_size > count)
+            {
+                m_size--;
+                m_data[m_size].~Entry<D>();
+            }
+        }
+
+        void clear() { truncate(0); }
+
+    private:
+        Entry<D> *m_data;
+        size_t m_size;
+        size_t m_capacity;
+
+        void checkCapacity() const
+        {
+            if (m_size == m_capacity)
+            {
+                throw std::logic_error("node entry capacity exceeded");
+            }
+        }
+    };
+
+    // 条目序列的只读视图 - 分裂策略既要处理节点的EntryArray，也要处理调用者的std::vector
+    template <size_t D = DynamicDimension>
+    class EntrySpan
+    {
+    public:
+        EntrySpan(const Entry<D> *data, size_t size) : m_data(data), m_size(size) {}
+        EntrySpan(const std::vector<Entry<D>> &entries) : m_data(entries.data()), m_size(entries.size()) {}
+        EntrySpan(const EntryArray<D> &entries) : m_data(entries.data()), m_size(entries.size()) {}
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        const Entry<D> &operator[](size_t index) const { return m_data[index]; }
+        const Entry<D> *begin() const { return m_data; }
+        const Entry<D> *end() const { return m_data + m_size; }
+
+    private:
+        const Entry<D> *m_data;
+        size_t m_size;
+    };
+
+} // namespace RTree
+
+#endif // RTREE_ENTRY_ARRAY_H
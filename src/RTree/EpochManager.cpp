@@ -0,0 +1,100 @@
+#include "EpochManager.h"
+#include <algorithm>
+
+namespace RTree
+{
+
+    // 线程退出时归还槽位
+    struct EpochManager::RecordHolder
+    {
+        ThreadRecord *record;
+
+        RecordHolder() : record(nullptr) {}
+        ~RecordHolder()
+        {
+            if (record)
+            {
+                record->epoch.store(Inactive);
+                record->depth = 0;
+                record->inUse.store(false);
+            }
+        }
+    };
+
+    EpochManager &EpochManager::instance()
+    {
+        static EpochManager manager;
+        return manager;
+    }
+
+    EpochManager::ThreadRecord &EpochManager::localRecord()
+    {
+        static thread_local RecordHolder holder;
+        if (holder.record)
+        {
+            return *holder.record;
+        }
+
+        std::lock_guard<std::mutex> lock(m_recordsMutex);
+        for (auto &record : m_records)
+        {
+            bool expected = false;
+            if (record->inUse.compare_exchange_strong(expected, true))
+            {
+                holder.record = record.get();
+                return *holder.record;
+            }
+        }
+        m_records.emplace_back(new ThreadRecord());
+        holder.record = m_records.back().get();
+        return *holder.record;
+    }
+
+    void EpochManager::enter()
+    {
+        ThreadRecord &record = localRecord();
+        if (record.depth++ == 0)
+        {
+            // 顺序一致的写保证公布先于之后对树的读取
+            record.epoch.store(m_globalEpoch.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+        }
+    }
+
+    void EpochManager::exit()
+    {
+        ThreadRecord &record = localRecord();
+        if (--record.depth == 0)
+        {
+            record.epoch.store(Inactive, std::memory_order_release);
+        }
+    }
+
+    void EpochManager::tryAdvance()
+    {
+        uint64_t epoch = m_globalEpoch.load();
+        {
+            std::lock_guard<std::mutex> lock(m_recordsMutex);
+            for (const auto &record : m_records)
+            {
+                uint64_t announced = record->epoch.load();
+                if (announced != Inactive && announced != epoch)
+                {
+                    return;
+                }
+            }
+        }
+        m_globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    uint64_t EpochManager::safeEpoch()
+    {
+        uint64_t safe = m_globalEpoch.load();
+        std::lock_guard<std::mutex> lock(m_recordsMutex);
+        for (const auto &record : m_records)
+        {
+            safe = std::min(safe, record->epoch.load());
+        }
+        return safe;
+    }
+
+} // namespace RTree
@@ -0,0 +1,71 @@
+#ifndef RTREE_EPOCH_MANAGER_H
+#define RTREE_EPOCH_MANAGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <memory>
+
+namespace RTree
+{
+
+    // 基于epoch的内存回收（进程内共享一个epoch域）：
+    //   读者进入临界区时在本线程的槽中公布当前全局epoch，退出时清除；
+    //   写者把摘除的节点连同摘除时的全局epoch一起挂起，
+    //   所有活跃线程公布的epoch都大于该值后，就不可能再有读者持有这个节点，可以释放。
+    // 读路径上只写本线程私有的槽，不做任何共享的原子读改写。
+    class EpochManager
+    {
+    public:
+        static const uint64_t Inactive = ~uint64_t(0);
+
+        static EpochManager &instance();
+
+        // 支持嵌套：只有最外层的enter/exit会修改公布的epoch
+        void enter();
+        void exit();
+
+        uint64_t currentEpoch() const { return m_globalEpoch.load(); }
+
+        // 所有活跃线程都已观察到当前epoch时推进全局epoch
+        void tryAdvance();
+
+        // 挂起于此epoch之前（不含）的对象都可以安全释放
+        uint64_t safeEpoch();
+
+    private:
+        struct ThreadRecord
+        {
+            std::atomic<uint64_t> epoch; // 公布的epoch，Inactive表示不在临界区
+            std::atomic<bool> inUse;     // 是否已分配给某个线程
+            size_t depth;                // 嵌套深度（仅本线程访问）
+
+            ThreadRecord() : epoch(Inactive), inUse(true), depth(0) {}
+        };
+
+        struct RecordHolder;
+
+        EpochManager() : m_globalEpoch(1) {}
+
+        ThreadRecord &localRecord();
+
+        std::atomic<uint64_t> m_globalEpoch;
+        std::mutex m_recordsMutex;
+        std::vector<std::unique_ptr<ThreadRecord>> m_records; // 只增不减，线程退出后槽可被复用
+    };
+
+    // 临界区守卫
+    class EpochGuard
+    {
+    public:
+        EpochGuard() { EpochManager::instance().enter(); }
+        ~EpochGuard() { EpochManager::instance().exit(); }
+
+        EpochGuard(const EpochGuard &) = delete;
+        EpochGuard &operator=(const EpochGuard &) = delete;
+    };
+
+} // namespace RTree
+
+#endif // RTREE_EPOCH_MANAGER_H
@@ -0,0 +1,110 @@
+#include "HilbertCurve.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace RTree
+{
+
+    template <size_t D>
+    HilbertCurve<D>::HilbertCurve(const Region<D> &world)
+        : m_world(world), m_bits(0)
+    {
+        size_t dimension = world.getDimension();
+        if (dimension == 0 || dimension > MaxDimension)
+        {
+            throw std::invalid_argument("Unsupported dimension for Hilbert curve");
+        }
+        m_bits = std::min<size_t>(32, 64 / dimension);
+    }
+
+    template <size_t D>
+    uint64_t HilbertCurve<D>::value(const Point<D> &p) const
+    {
+        return encode(p.m_coords.data(), p.getDimension());
+    }
+
+    template <size_t D>
+    uint64_t HilbertCurve<D>::value(const Region<D> &r) const
+    {
+        double center[MaxDimension];
+        size_t dimension = std::min(r.getDimension(), MaxDimension);
+        for (size_t i = 0; i < dimension; i++)
+        {
+            center[i] = (r.m_low[i] + r.m_high[i]) / 2.0;
+        }
+        return encode(center, dimension);
+    }
+
+    template <size_t D>
+    uint64_t HilbertCurve<D>::encode(const double *coords, size_t dimension) const
+    {
+        if (!isValid() || dimension != m_world.getDimension())
+        {
+            return 0;
+        }
+
+        // 量化到 [0, 2^bits - 1]
+        uint32_t x[MaxDimension];
+        const double maxCell = static_cast<double>((uint64_t(1) << m_bits) - 1);
+        for (size_t i = 0; i < dimension; i++)
+        {
+            double extent = m_world.m_high[i] - m_world.m_low[i];
+            double t = extent > 0 ? (coords[i] - m_world.m_low[i]) / extent : 0.0;
+            t = std::min(1.0, std::max(0.0, t));
+            x[i] = static_cast<uint32_t>(t * maxCell);
+        }
+
+        // Skilling的AxesToTranspose：得到Hilbert值的"转置"表示
+        uint32_t m = uint32_t(1) << (m_bits - 1);
+        for (uint32_t q = m; q > 1; q >>= 1)
+        {
+            uint32_t p = q - 1;
+            for (size_t i = 0; i < dimension; i++)
+            {
+                if (x[i] & q)
+                {
+                    x[0] ^= p;
+                }
+                else
+                {
+                    uint32_t t = (x[0] ^ x[i]) & p;
+                    x[0] ^= t;
+                    x[i] ^= t;
+                }
+            }
+        }
+        for (size_t i = 1; i < dimension; i++)
+        {
+            x[i] ^= x[i - 1];
+        }
+        uint32_t t = 0;
+        for (uint32_t q = m; q > 1; q >>= 1)
+        {
+            if (x[dimension - 1] & q)
+            {
+                t ^= q - 1;
+            }
+        }
+        for (size_t i = 0; i < dimension; i++)
+        {
+            x[i] ^= t;
+        }
+
+        // 按位交错得到Hilbert值（高位在前）
+        uint64_t h = 0;
+        for (size_t bit = m_bits; bit-- > 0;)
+        {
+            for (size_t i = 0; i < dimension; i++)
+            {
+                h = (h << 1) | ((x[i] >> bit) & 1);
+            }
+        }
+        return h;
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class HilbertCurve<DynamicDimension>;
+    template class HilbertCurve<2>;
+    template class HilbertCurve<3>;
+
+} // namespace RTree
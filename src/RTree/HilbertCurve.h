@@ -0,0 +1,37 @@
+#ifndef RTREE_HILBERT_CURVE_H
+#define RTREE_HILBERT_CURVE_H
+
+#include <cstdint>
+#include "Region.h"
+
+namespace RTree
+{
+
+    // Hilbert曲线 - 把数据空间m_world内的点映射为一维Hilbert值
+    // 每维量化为 min(32, 64/维度) 位，超出m_world的坐标被截断到边界
+    template <size_t D = DynamicDimension>
+    class HilbertCurve
+    {
+    public:
+        static const size_t MaxDimension = 64;
+
+        HilbertCurve() : m_bits(0) {}
+        explicit HilbertCurve(const Region<D> &world);
+
+        bool isValid() const { return m_bits > 0; }
+        const Region<D> &getWorld() const { return m_world; }
+        size_t getBitsPerDimension() const { return m_bits; }
+
+        uint64_t value(const Point<D> &p) const;
+        uint64_t value(const Region<D> &r) const; // 区域中心的Hilbert值
+
+    private:
+        Region<D> m_world;
+        size_t m_bits;
+
+        uint64_t encode(const double *coords, size_t dimension) const;
+    };
+
+} // namespace RTree
+
+#endif // RTREE_HILBERT_CURVE_H
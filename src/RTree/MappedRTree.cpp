@@ -0,0 +1,156 @@
+#include "MappedRTree.h"
+#include <fstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace RTree
+{
+
+    template <size_t D>
+    MappedRTree<D>::MappedRTree(const std::string &path)
+        : m_base(nullptr), m_length(0), m_mapped(false)
+    {
+#ifdef __linux__
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader))
+        {
+            ::close(fd);
+            throw std::runtime_error("not an R-tree page file: " + path);
+        }
+        m_length = static_cast<size_t>(info.st_size);
+        void *memory = mmap(nullptr, m_length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED)
+        {
+            throw std::runtime_error("cannot map " + path);
+        }
+        m_base = static_cast<const unsigned char *>(memory);
+        m_mapped = true;
+#else
+        // 没有mmap时整体读入内存，边界数组按64字节对齐以满足SIMD内核的要求
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        m_length = static_cast<size_t>(in.tellg());
+        if (m_length < sizeof(FileHeader))
+        {
+            throw std::runtime_error("not an R-tree page file: " + path);
+        }
+        m_buffer.reset(new unsigned char[m_length + PageLayout::HeaderSize]);
+        unsigned char *aligned = m_buffer.get();
+        aligned += (PageLayout::HeaderSize - reinterpret_cast<uintptr_t>(aligned) % PageLayout::HeaderSize) % PageLayout::HeaderSize;
+        in.seekg(0);
+        in.read(reinterpret_cast<char *>(aligned), static_cast<std::streamsize>(m_length));
+        m_base = aligned;
+#endif
+
+        std::memcpy(&m_header, m_base, sizeof(FileHeader));
+        m_layout = PageLayout(m_header.dimension, m_header.capacity);
+        const char *error = nullptr;
+        if (!PageLayout::checkMagic(m_header.magic))
+        {
+            error = "not an R-tree page file: ";
+        }
+        else if (m_header.version != PageLayout::Version)
+        {
+            error = "unsupported page file version: ";
+        }
+        else if (D != DynamicDimension && m_header.dimension != D)
+        {
+            error = "page file dimension does not match the tree: ";
+        }
+        else if (m_layout.getCapacity() != m_header.capacity || m_layout.getPageSize() != m_header.pageSize ||
+                 m_header.pageCount * m_header.pageSize != m_length ||
+                 m_header.rootPage == 0 || m_header.rootPage >= m_header.pageCount)
+        {
+            error = "corrupt page file: ";
+        }
+        if (error)
+        {
+            unmap();
+            throw std::runtime_error(error + path);
+        }
+    }
+
+    template <size_t D>
+    MappedRTree<D>::~MappedRTree()
+    {
+        unmap();
+    }
+
+    template <size_t D>
+    void MappedRTree<D>::unmap()
+    {
+#ifdef __linux__
+        if (m_mapped && m_base)
+        {
+            munmap(const_cast<unsigned char *>(m_base), m_length);
+        }
+#endif
+        m_base = nullptr;
+        m_mapped = false;
+        m_buffer.reset();
+    }
+
+    template <size_t D>
+    uint64_t MappedRTree<D>::checkedPage(uint64_t id) const
+    {
+        if (id == 0 || id >= m_header.pageCount)
+        {
+            throw std::runtime_error("corrupt page file: child page out of range");
+        }
+        return id;
+    }
+
+    template <size_t D>
+    std::vector<id_type> MappedRTree<D>::search(const Region<D> &query) const
+    {
+        std::vector<id_type> results;
+        visit(query, [&](id_type id)
+              {
+                  results.push_back(id);
+                  return true; });
+        return results;
+    }
+
+    template <size_t D>
+    size_t MappedRTree<D>::count(const Region<D> &query) const
+    {
+        size_t hits = 0;
+        traverse(query, [&](const uint64_t *, const HitMask &mask)
+                 {
+                     hits += mask.popcount();
+                     return true; });
+        return hits;
+    }
+
+    template <size_t D>
+    bool MappedRTree<D>::exists(const Region<D> &query) const
+    {
+        bool found = false;
+        traverse(query, [&](const uint64_t *, const HitMask &mask)
+                 {
+                     found = mask.any();
+                     return !found; });
+        return found;
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class MappedRTree<DynamicDimension>;
+    template class MappedRTree<2>;
+    template class MappedRTree<3>;
+
+} // namespace RTree
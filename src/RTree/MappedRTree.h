@@ -0,0 +1,109 @@
+#ifndef RTREE_MAPPED_RTREE_H
+#define RTREE_MAPPED_RTREE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "Region.h"
+#include "Entry.h"
+#include "SimdKernel.h"
+#include "PageFormat.h"
+
+namespace RTree
+{
+
+    // 只读的持久化R-tree - 打开RTree::save()写出的文件，用mmap映射后直接在映射的页上查询，
+    // 不做任何反序列化，打开的代价与文件大小无关；页在第一次访问时才由操作系统读入。
+    // 叶子中存放的是数据条目的ID（RTree中的数据指针不能跨进程保存），查询结果也是ID。
+    // 对象本身只读，可以在多个线程中同时查询。
+    template <size_t D = DynamicDimension>
+    class MappedRTree
+    {
+    public:
+        // 文件无法打开、格式不符或维度与D不一致时抛出std::runtime_error
+        explicit MappedRTree(const std::string &path);
+        ~MappedRTree();
+
+        MappedRTree(const MappedRTree &) = delete;
+        MappedRTree &operator=(const MappedRTree &) = delete;
+
+        size_t getSize() const { return m_header.size; }
+        size_t getHeight() const { return m_header.height; }
+        size_t getDimension() const { return m_header.dimension; }
+        size_t getPageCount() const { return m_header.pageCount; }
+        size_t getPageSize() const { return m_header.pageSize; }
+
+        // visitor(id)返回false时停止，返回已访问的条目数
+        template <class Visitor>
+        size_t visit(const Region<D> &query, Visitor visitor) const
+        {
+            size_t visited = 0;
+            traverse(query, [&](const uint64_t *payload, const HitMask &mask)
+                     { return mask.forEachWhile([&](size_t i)
+                                                {
+                                                    visited++;
+                                                    return visitor(static_cast<id_type>(payload[i])); }); });
+            return visited;
+        }
+
+        std::vector<id_type> search(const Region<D> &query) const;
+        size_t count(const Region<D> &query) const;
+        bool exists(const Region<D> &query) const;
+
+    private:
+        const unsigned char *m_base; // 映射（或读入）的文件内容
+        size_t m_length;
+        bool m_mapped;                            // true: mmap得到；false: 读入m_buffer
+        std::unique_ptr<unsigned char[]> m_buffer; // 不支持mmap的平台上读入的文件内容（含对齐余量）
+        FileHeader m_header;
+        PageLayout m_layout;
+
+        const unsigned char *page(uint64_t id) const { return m_base + id * m_header.pageSize; }
+
+        // 深度优先遍历，onLeaf(payload, mask)返回false时停止
+        template <class OnLeaf>
+        void traverse(const Region<D> &query, OnLeaf onLeaf) const
+        {
+            if (m_header.size == 0 || query.getDimension() != m_header.dimension)
+            {
+                return;
+            }
+
+            std::vector<uint64_t> stack;
+            HitMask mask;
+            stack.push_back(m_header.rootPage);
+            while (!stack.empty())
+            {
+                const unsigned char *node = page(stack.back());
+                stack.pop_back();
+                const PageHeader *header = reinterpret_cast<const PageHeader *>(node);
+                uint64_t *words = mask.reset(header->count);
+                if (header->count == 0)
+                {
+                    continue;
+                }
+                intersectBatch(m_layout.bounds(node), m_layout.getCapacity(), header->count, m_header.dimension,
+                               query.m_low.data(), query.m_high.data(), words);
+
+                const uint64_t *payload = m_layout.payload(node);
+                if (header->level == 0)
+                {
+                    if (!onLeaf(payload, mask))
+                    {
+                        return;
+                    }
+                    continue;
+                }
+                mask.forEach([&](size_t i)
+                             { stack.push_back(checkedPage(payload[i])); });
+            }
+        }
+
+        uint64_t checkedPage(uint64_t id) const;
+        void unmap();
+    };
+
+} // namespace RTree
+
+#endif // RTREE_MAPPED_RTREE_H
@@ -0,0 +1,61 @@
+#include "NearestIterator.h"
+
+namespace RTree
+{
+
+    template <size_t D>
+    NearestIterator<D>::NearestIterator(Node<D> *root, const Point<D> &point)
+        : m_query(point), m_expandedNodes(0)
+    {
+        if (root && root->getEntryCount() > 0)
+        {
+            m_queue.push(Candidate(root->getMBR().getMinDistance(m_query), root, nullptr));
+        }
+    }
+
+    template <size_t D>
+    void NearestIterator<D>::advance()
+    {
+        while (!m_queue.empty() && m_queue.top().node)
+        {
+            Node<D> *node = m_queue.top().node;
+            m_queue.pop();
+            m_expandedNodes++;
+
+            for (size_t i = 0; i < node->getEntryCount(); i++)
+            {
+                if (node->isLeaf())
+                {
+                    const Entry<D> &entry = node->getEntry(i);
+                    m_queue.push(Candidate(entry.m_region.getMinDistance(m_query), nullptr, entry.m_data));
+                }
+                else
+                {
+                    m_queue.push(Candidate(node->getChildMBR(i).getMinDistance(m_query), node->getChild(i), nullptr));
+                }
+            }
+        }
+    }
+
+    template <size_t D>
+    bool NearestIterator<D>::hasNext()
+    {
+        advance();
+        return !m_queue.empty();
+    }
+
+    template <size_t D>
+    DistanceEntry NearestIterator<D>::next()
+    {
+        advance();
+        Candidate top = m_queue.top();
+        m_queue.pop();
+        return DistanceEntry(top.distance, top.data);
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class NearestIterator<DynamicDimension>;
+    template class NearestIterator<2>;
+    template class NearestIterator<3>;
+
+} // namespace RTree
@@ -0,0 +1,70 @@
+#ifndef RTREE_NEAREST_ITERATOR_H
+#define RTREE_NEAREST_ITERATOR_H
+
+#include <vector>
+#include <queue>
+#include "Node.h"
+
+namespace RTree
+{
+
+    // 距离条目 - 用于最近邻查询
+    struct DistanceEntry
+    {
+        double distance;
+        void *data;
+
+        DistanceEntry(double dist, void *d) : distance(dist), data(d) {}
+
+        bool operator<(const DistanceEntry &other) const
+        {
+            return distance > other.distance; // 使用小顶堆
+        }
+    };
+
+    // 增量最近邻迭代器 - Hjaltason–Samet best-first遍历
+    // 节点和数据条目放在同一个按最小距离排序的小顶堆中，每次弹出距离最小的元素：
+    // 弹出节点时展开其条目，弹出数据时即为下一个最近邻。因此只有距离不超过
+    // 第k个结果的节点才会被展开。树被修改后迭代器失效。
+    template <size_t D = DynamicDimension>
+    class NearestIterator
+    {
+    public:
+        NearestIterator(Node<D> *root, const Point<D> &point);
+
+        // 是否还有下一个最近邻
+        bool hasNext();
+
+        // 返回下一个最近邻（距离非递减）；调用前需保证hasNext()为true
+        DistanceEntry next();
+
+        // 已展开的节点数
+        size_t getExpandedNodes() const { return m_expandedNodes; }
+
+    private:
+        // 堆中的候选：node非空表示待展开的节点，否则为数据条目
+        struct Candidate
+        {
+            double distance;
+            Node<D> *node;
+            void *data;
+
+            Candidate(double dist, Node<D> *n, void *d) : distance(dist), node(n), data(d) {}
+
+            bool operator<(const Candidate &other) const
+            {
+                return distance > other.distance; // 使用小顶堆
+            }
+        };
+
+        Region<D> m_query;
+        std::priority_queue<Candidate> m_queue;
+        size_t m_expandedNodes;
+
+        // 展开节点直到堆顶为数据条目或堆为空
+        void advance();
+    };
+
+} // namespace RTree
+
+#endif // RTREE_NEAREST_ITERATOR_H
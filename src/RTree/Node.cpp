@@ -1,21 +1,323 @@
 #include "Node.h"
 #include "RTree.h"
 #include <limits>
-#include <iostream>
+#include <algorithm>
+#include <stdexcept>
 namespace RTree
 {
 
     //==========================
     // Node类方法实现
     //==========================
-    void Node::insertEntry(const Entry &entry)
+    template <size_t D>
+    bool Node<D>::usesBounds() const
     {
+        return m_tree && m_tree->getNodeLayout() == NodeLayout::StructOfArrays;
+    }
+
+    template <size_t D>
+    bool Node<D>::usesFloatBounds() const
+    {
+        return m_tree && m_tree->getNodeLayout() == NodeLayout::StructOfArraysFloat;
+    }
+
+    template <size_t D>
+    void Node<D>::encodeChildren()
+    {
+        for (size_t i = 0; i < m_quantized.size(); i++)
+        {
+            m_quantized.set(i, getChild(i)->getMBR(), m_nodeMBR);
+        }
+    }
+
+    template <size_t D>
+    Entry<D> Node<D>::copyEntry(size_t index) const
+    {
+        if (m_quantized.enabled())
+        {
+            Node *child = getChild(index);
+            return Entry<D>(child->getMBR(), 0, child);
+        }
+        return m_entries[index];
+    }
+
+    template <size_t D>
+    void Node<D>::syncBounds()
+    {
+        if (usesBounds())
+        {
+            m_bounds.assign(m_entries);
+        }
+        else
+        {
+            m_bounds.release();
+        }
+
+        if (usesFloatBounds())
+        {
+            m_floatBounds.assign(m_entries);
+        }
+        else
+        {
+            m_floatBounds.release();
+        }
+    }
+
+    template <size_t D>
+    void Node<D>::intersectMask(const Region<D> &query, HitMask &mask) const
+    {
+        intersectMask(query, mask, usesBounds() || usesFloatBounds());
+    }
+
+    template <size_t D>
+    void Node<D>::intersectMask(const Region<D> &query, HitMask &mask, bool useBounds) const
+    {
+        if (m_quantized.enabled())
+        {
+            // 编码向外取整，只会多访问少量子节点；叶子不量化，最终结果与其他布局一致
+            m_quantized.intersectMask(query, m_nodeMBR, mask);
+            return;
+        }
+        if (useBounds && !m_floatBounds.empty())
+        {
+            m_floatBounds.intersectMask(query, mask);
+            if (m_isLeaf)
+            {
+                // float边界向外取整会带来少量假阳性，用条目的double区域剔除
+                mask.forEach([&](size_t i)
+                             {
+                                 if (!m_entries[i].m_region.intersectsRegion(query))
+                                 {
+                                     mask.clear(i);
+                                 } });
+            }
+            return;
+        }
+        if (useBounds)
+        {
+            m_bounds.intersectMask(query, mask);
+            return;
+        }
+
+        uint64_t *words = mask.reset(m_entries.size());
+        std::fill(words, words + maskWords(m_entries.size()), 0);
+        for (size_t i = 0; i < m_entries.size(); i++)
+        {
+            if (m_entries[i].m_region.intersectsRegion(query))
+            {
+                words[i >> 6] |= uint64_t(1) << (i & 63);
+            }
+        }
+    }
+
+    template <size_t D>
+    void Node<D>::insertEntry(const Entry<D> &entry)
+    {
+        if (m_quantized.enabled())
+        {
+            // 新子节点落在节点MBR内时只编码它自己，否则MBR扩大，全部子节点重新编码
+            bool grown = m_quantized.empty() || !m_nodeMBR.containsRegion(entry.m_region);
+            if (m_quantized.empty())
+            {
+                m_nodeMBR = entry.m_region;
+            }
+            else if (grown)
+            {
+                m_nodeMBR.combineRegion(entry.m_region);
+            }
+            m_quantized.push(entry.m_childNode, entry.m_region, m_nodeMBR);
+            if (grown)
+            {
+                encodeChildren();
+            }
+            return;
+        }
+
         m_entries.push_back(entry);
+        if (usesBounds())
+        {
+            m_bounds.push(entry);
+        }
+        if (usesFloatBounds())
+        {
+            m_floatBounds.push(entry);
+        }
+        updateMBR();
+        if (m_isLeaf)
+        {
+            m_tree->updateIdIndex(entry.m_id, this);
+        }
+    }
+
+    template <size_t D>
+    void Node<D>::insertEntryAt(size_t index, const Entry<D> &entry)
+    {
+        if (m_quantized.enabled())
+        {
+            // 量化节点不保存Hilbert值，条目顺序没有意义
+            insertEntry(entry);
+            return;
+        }
+        m_entries.insert(index, entry);
+        syncBounds();
+        updateMBR();
+        if (m_isLeaf)
+        {
+            m_tree->updateIdIndex(entry.m_id, this);
+        }
+    }
+
+    template <size_t D>
+    uint64_t Node<D>::getLargestHilbertValue() const
+    {
+        uint64_t largest = 0;
+        for (const auto &entry : m_entries)
+        {
+            largest = std::max(largest, entry.m_hilbertValue);
+        }
+        return largest;
+    }
+
+    template <size_t D>
+    void Node<D>::setEntries(Entry<D> *entries, size_t count)
+    {
+        if (m_quantized.enabled())
+        {
+            // 先求出MBR，再按它编码每个子节点
+            m_quantized.clear();
+            if (count == 0)
+            {
+                return;
+            }
+            m_nodeMBR = entries[0].m_region;
+            for (size_t i = 1; i < count; i++)
+            {
+                m_nodeMBR.combineRegion(entries[i].m_region);
+            }
+            for (size_t i = 0; i < count; i++)
+            {
+                m_quantized.push(entries[i].m_childNode, entries[i].m_region, m_nodeMBR);
+                entries[i].m_childNode->setParent(this);
+            }
+            return;
+        }
+
+        m_entries.clear();
+        for (size_t i = 0; i < count; i++)
+        {
+            m_entries.push_back(std::move(entries[i]));
+        }
+        if (!m_isLeaf)
+        {
+            for (auto &entry : m_entries)
+            {
+                entry.m_childNode->setParent(this);
+            }
+        }
         updateMBR();
+        syncBounds();
     }
 
-    void Node::updateMBR()
+    template <size_t D>
+    void Node<D>::setEntryChild(size_t index, Node *child)
     {
+        if (m_quantized.enabled())
+        {
+            m_quantized.setPayload(index, child);
+            return;
+        }
+        m_entries[index].m_childNode = child;
+        if (usesBounds())
+        {
+            m_bounds.setPayload(index, child);
+        }
+        if (usesFloatBounds())
+        {
+            m_floatBounds.setPayload(index, child);
+        }
+    }
+
+    template <size_t D>
+    void Node<D>::releaseSubtree(Node *node, NodeAllocator &allocator, SharedNodeTable &shared)
+    {
+        std::vector<Node *> stack;
+        if (node)
+        {
+            stack.push_back(node);
+        }
+        while (!stack.empty())
+        {
+            Node *current = stack.back();
+            stack.pop_back();
+            // 仍被其他树或快照引用的节点保留
+            if (!shared.release(current))
+            {
+                continue;
+            }
+            if (!current->isLeaf())
+            {
+                for (size_t i = 0; i < current->getEntryCount(); i++)
+                {
+                    stack.push_back(current->getChild(i));
+                }
+            }
+            size_t blockClass = current->getBlockClass();
+            current->~Node();
+            allocator.deallocate(current, blockClass);
+        }
+    }
+
+    template <size_t D>
+    void Node<D>::setEntryRegion(size_t index, const Region<D> &region)
+    {
+        if (m_quantized.enabled())
+        {
+            // 超出节点MBR时编码会被截断：先扩大MBR并重新编码全部子节点（之后的updateMBR可能再收缩）
+            if (m_nodeMBR.containsRegion(region))
+            {
+                m_quantized.set(index, region, m_nodeMBR);
+            }
+            else
+            {
+                m_nodeMBR.combineRegion(region);
+                encodeChildren();
+            }
+            return;
+        }
+        m_entries[index].m_region = region;
+        if (usesBounds())
+        {
+            m_bounds.set(index, region);
+        }
+        if (usesFloatBounds())
+        {
+            m_floatBounds.set(index, region);
+        }
+    }
+
+    template <size_t D>
+    void Node<D>::updateMBR()
+    {
+        if (m_quantized.enabled())
+        {
+            // 精确的区域在子节点中；MBR改变后编码的参考区域随之改变，全部子节点重新编码
+            if (m_quantized.empty())
+            {
+                return;
+            }
+            Region<D> mbr = getChild(0)->getMBR();
+            for (size_t i = 1; i < m_quantized.size(); i++)
+            {
+                mbr.combineRegion(getChild(i)->getMBR());
+            }
+            if (mbr.m_low != m_nodeMBR.m_low || mbr.m_high != m_nodeMBR.m_high)
+            {
+                m_nodeMBR = mbr;
+                encodeChildren();
+            }
+            return;
+        }
+
         if (m_entries.empty())
         {
             return;
@@ -28,13 +330,15 @@ namespace RTree
         }
     }
 
-    Node *Node::chooseSubtree(const Region &mbr)
+    template <size_t D>
+    Node<D> *Node<D>::chooseSubtree(const Region<D> &)
     {
         // 基类实现，叶子节点返回自身
         return this;
     }
 
-    Node *Node::findLeaf(id_type id, const Region &mbr)
+    template <size_t D>
+    Node<D> *Node<D>::findLeaf(id_type id, const Region<D> &)
     {
         // 基类实现：在当前节点中查找
         int index = findEntry(id);
@@ -45,7 +349,8 @@ namespace RTree
         return nullptr;
     }
 
-    int Node::findEntry(id_type id) const
+    template <size_t D>
+    int Node<D>::findEntry(id_type id) const
     {
         for (size_t i = 0; i < m_entries.size(); i++)
         {
@@ -57,11 +362,92 @@ namespace RTree
         return -1;
     }
 
-    void Node::removeEntry(size_t index)
+    template <size_t D>
+    int Node<D>::findChild(const Node *child) const
+    {
+        if (m_quantized.enabled())
+        {
+            return m_quantized.find(child);
+        }
+        for (size_t i = 0; i < m_entries.size(); i++)
+        {
+            if (m_entries[i].m_childNode == child)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    template <size_t D>
+    void Node<D>::distributeEntries(const Entry<D> &newEntry, const std::vector<size_t> &group2, Node *other)
+    {
+        size_t count = m_entries.size();
+        HitMask moving;
+        uint64_t *movingWords = moving.reset(count + 1);
+        std::fill(movingWords, movingWords + maskWords(count + 1), 0);
+        for (size_t idx : group2)
+        {
+            movingWords[idx >> 6] |= uint64_t(1) << (idx & 63);
+            if (idx < count)
+            {
+                other->m_entries.push_back(std::move(m_entries[idx]));
+            }
+            else
+            {
+                other->m_entries.push_back(newEntry);
+            }
+        }
+
+        // 留下的条目前移填补空位
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!moving.test(i))
+            {
+                if (kept != i)
+                {
+                    m_entries[kept] = std::move(m_entries[i]);
+                }
+                kept++;
+            }
+        }
+        m_entries.truncate(kept);
+        if (!moving.test(count))
+        {
+            m_entries.push_back(newEntry);
+        }
+
+        // 更新MBR和SoA边界
+        updateMBR();
+        other->updateMBR();
+        syncBounds();
+        other->syncBounds();
+    }
+
+    template <size_t D>
+    void Node<D>::removeEntry(size_t index)
     {
+        if (m_quantized.enabled())
+        {
+            if (index < m_quantized.size())
+            {
+                m_quantized.erase(index);
+                updateMBR();
+            }
+            return;
+        }
         if (index < m_entries.size())
         {
-            m_entries.erase(m_entries.begin() + index);
+            m_entries.erase(index);
+            if (usesBounds())
+            {
+                m_bounds.erase(index);
+            }
+            if (usesFloatBounds())
+            {
+                m_floatBounds.erase(index);
+            }
             updateMBR();
         }
     }
@@ -69,61 +455,47 @@ namespace RTree
     //==========================
     // LeafNode类方法实现
     //==========================
-    LeafNode::~LeafNode()
+    template <size_t D>
+    LeafNode<D>::~LeafNode()
     {
         // 不需要释放m_data，因为叶子节点不拥有数据的所有权
     }
 
-    void LeafNode::insertData(void *data, size_t dataSize, const Region &mbr, id_type id)
+    template <size_t D>
+    void LeafNode<D>::insertData(void *data, size_t dataSize, const Region<D> &mbr, id_type id)
     {
-        Entry entry(mbr, id, data, dataSize);
-        insertEntry(entry);
+        Entry<D> entry(mbr, id, data, dataSize);
+        this->insertEntry(entry);
     }
 
-    void LeafNode::split(const Entry &newEntry, Node *&newNode, size_t maxEntries)
+    template <size_t D>
+    void LeafNode<D>::split(const Entry<D> &newEntry, Node<D> *&newNode, size_t)
     {
         // 创建新节点
-        LeafNode *newLeaf = new LeafNode(m_tree);
+        LeafNode *newLeaf = this->m_tree->createLeafNode();
         newNode = newLeaf;
 
-        // 获取分裂策略
-        std::shared_ptr<SplitStrategy> strategy = m_tree->getSplitStrategy();
-
-        // 执行分裂
-        std::vector<size_t> group1, group2;
-        strategy->split(m_entries, newEntry, group1, group2);
-
-        // 创建临时条目数组，包含新条目
-        std::vector<Entry> allEntries = m_entries;
-        allEntries.push_back(newEntry);
+        // 执行分裂：策略只返回下标
+        auto &groups = this->splitGroups();
+        this->m_tree->getSplitStrategy()->split(this->m_entries, newEntry, groups.group1, groups.group2);
+        this->distributeEntries(newEntry, groups.group2, newLeaf);
 
-        // 清空当前节点条目
-        m_entries.clear();
-
-        // 将第一组条目分配到当前节点
-        for (size_t idx : group1)
+        // ID索引：新条目先记在当前节点，搬到新节点的条目随后改指新节点
+        this->m_tree->updateIdIndex(newEntry.m_id, this);
+        for (size_t i = 0; i < newLeaf->getEntryCount(); i++)
         {
-            m_entries.push_back(allEntries[idx]);
+            this->m_tree->updateIdIndex(newLeaf->m_entries[i].m_id, newLeaf);
         }
 
-        // 将第二组条目分配到新节点
-        for (size_t idx : group2)
-        {
-            newLeaf->m_entries.push_back(allEntries[idx]);
-        }
-
-        // 更新MBR
-        updateMBR();
-        newLeaf->updateMBR();
-
         // 设置新节点的父节点
-        newLeaf->setParent(m_parent);
+        newLeaf->setParent(this->getParent());
     }
 
-    Node *LeafNode::findLeaf(id_type id, const Region &mbr)
+    template <size_t D>
+    Node<D> *LeafNode<D>::findLeaf(id_type id, const Region<D> &)
     {
         // 在叶子节点中查找条目
-        int index = findEntry(id);
+        int index = this->findEntry(id);
         if (index >= 0)
         {
             return this;
@@ -131,10 +503,21 @@ namespace RTree
         return nullptr;
     }
 
-    std::vector<void *> LeafNode::search(const Region &query) const
+    template <size_t D>
+    std::vector<void *> LeafNode<D>::search(const Region<D> &query) const
     {
         std::vector<void *> results;
-        for (const auto &entry : m_entries)
+        if (this->usesBounds() || this->usesFloatBounds())
+        {
+            // SoA + SIMD扫描：一次得到整个节点的命中位图
+            HitMask mask;
+            this->intersectMask(query, mask);
+            mask.forEach([&](size_t i)
+                         { results.push_back(this->getPayload(i)); });
+            return results;
+        }
+
+        for (const auto &entry : this->m_entries)
         {
             if (entry.m_region.intersectsRegion(query))
             {
@@ -147,26 +530,27 @@ namespace RTree
     //==========================
     // InternalNode类方法实现
     //==========================
-    InternalNode::~InternalNode()
+    template <size_t D>
+    InternalNode<D>::~InternalNode()
     {
-        // 内部节点拥有子节点的所有权，需要释放
-        for (auto &entry : m_entries)
-        {
-            delete entry.m_childNode;
-        }
+        // 子节点由所属树的节点分配器统一管理，这里不递归释放
     }
 
-    Node *InternalNode::chooseSubtree(const Region &mbr)
+    template <size_t D>
+    Node<D> *InternalNode<D>::chooseChild(const Region<D> &mbr) const
     {
         // 选择扩展面积最小的子树
         double minEnlargement = std::numeric_limits<double>::max();
         double minArea = std::numeric_limits<double>::max();
         size_t chosen = 0;
 
-        for (size_t i = 0; i < m_entries.size(); i++)
+        for (size_t i = 0; i < this->getEntryCount(); i++)
         {
-            double enlargement = m_entries[i].getEnlargement(mbr);
-            double area = m_entries[i].m_region.getArea();
+            const Region<D> &region = this->getChildMBR(i);
+            Region<D> combined = region;
+            combined.combineRegion(mbr);
+            double area = region.getArea();
+            double enlargement = combined.getArea() - area;
 
             if (enlargement < minEnlargement ||
                 (enlargement == minEnlargement && area < minArea))
@@ -176,66 +560,185 @@ namespace RTree
                 chosen = i;
             }
         }
-        Node* childNode = m_entries[chosen].m_childNode;
-            if (!childNode) {
-                std::cout << "Error: Null child node found!" << std::endl;
-                return nullptr;
+        return this->getChild(chosen);
+    }
+
+    template <size_t D>
+    Node<D> *InternalNode<D>::chooseChildLeastOverlap(const Region<D> &mbr) const
+    {
+        // 候选按(面积扩展, 面积)升序排列；M较大时按R*论文的近似只考察前32个
+        const size_t maxCandidates = 32;
+        size_t count = this->getEntryCount();
+        std::vector<std::pair<std::pair<double, double>, size_t>> candidates;
+        candidates.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            const Region<D> &region = this->getChildMBR(i);
+            Region<D> combined = region;
+            combined.combineRegion(mbr);
+            double area = region.getArea();
+            candidates.push_back(std::make_pair(std::make_pair(combined.getArea() - area, area), i));
+        }
+        size_t candidateCount = std::min(maxCandidates, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + candidateCount, candidates.end());
+
+        double minOverlap = std::numeric_limits<double>::max();
+        size_t chosen = candidates[0].second;
+        size_t dimension = mbr.getDimension();
+        for (size_t c = 0; c < candidateCount; c++)
+        {
+            size_t i = candidates[c].second;
+            const Region<D> &original = this->getChildMBR(i);
+            Region<D> enlarged = original;
+            enlarged.combineRegion(mbr);
+
+            // 扩大后的区域包含原区域，每个兄弟的重叠增量都非负：累计超过当前最小值即可放弃。
+            // 与扩大后区域不相交的兄弟贡献为0
+            double overlap = 0.0;
+            for (size_t j = 0; j < count && overlap < minOverlap && candidates[c].first.first > 0.0; j++)
+            {
+                const Region<D> &other = this->getChildMBR(j);
+                double after = 1.0;
+                double before = 1.0;
+                for (size_t d = 0; d < dimension && after > 0.0; d++)
+                {
+                    after *= std::max(0.0, std::min(enlarged.m_high[d], other.m_high[d]) - std::max(enlarged.m_low[d], other.m_low[d]));
+                    before *= std::max(0.0, std::min(original.m_high[d], other.m_high[d]) - std::max(original.m_low[d], other.m_low[d]));
+                }
+                if (j != i && after > 0.0)
+                {
+                    overlap += after - before;
+                }
+            }
+
+            // 候选已按面积扩展、面积排好序，重叠相同时保留先出现的
+            if (overlap < minOverlap)
+            {
+                minOverlap = overlap;
+                chosen = i;
+                if (overlap == 0.0)
+                {
+                    break;
+                }
             }
+        }
+        return this->getChild(chosen);
+    }
+
+    template <size_t D>
+    Node<D> *InternalNode<D>::chooseSubtree(const Region<D> &mbr)
+    {
+        // 空的内部节点或空的子节点指针说明树结构已损坏
+        Node<D> *childNode = this->getEntryCount() == 0 ? nullptr : chooseChild(mbr);
+        if (!childNode)
+        {
+            throw std::logic_error("internal node has no child to descend into");
+        }
 
         return childNode->chooseSubtree(mbr);
     }
 
-    void InternalNode::split(const Entry &newEntry, Node *&newNode, size_t maxEntries)
+    template <size_t D>
+    void InternalNode<D>::split(const Entry<D> &newEntry, Node<D> *&newNode, size_t)
     {
         // 创建新节点
-        InternalNode *newInternal = new InternalNode(m_level, m_tree);
+        InternalNode *newInternal = this->m_tree->createInternalNode(this->m_level);
         newNode = newInternal;
+        if (this->isQuantized())
+        {
+            splitQuantized(newEntry, newInternal);
+            return;
+        }
 
-        // 获取分裂策略
-        std::shared_ptr<SplitStrategy> strategy = m_tree->getSplitStrategy();
-
-        // 执行分裂
-        std::vector<size_t> group1, group2;
-        strategy->split(m_entries, newEntry, group1, group2);
+        // 执行分裂：策略只返回下标
+        auto &groups = this->splitGroups();
+        this->m_tree->getSplitStrategy()->split(this->m_entries, newEntry, groups.group1, groups.group2);
+        this->distributeEntries(newEntry, groups.group2, newInternal);
 
-        // 创建临时条目数组，包含新条目
-        std::vector<Entry> allEntries = m_entries;
-        allEntries.push_back(newEntry);
+        // 子节点的父指针：新条目先指向当前节点，搬到新节点的子节点随后改指新节点
+        newEntry.m_childNode->setParent(this);
+        for (size_t i = 0; i < newInternal->getEntryCount(); i++)
+        {
+            newInternal->m_entries[i].m_childNode->setParent(newInternal);
+        }
 
-        // 清空当前节点条目
-        m_entries.clear();
+        // 设置新节点的父节点
+        newInternal->setParent(this->getParent());
+    }
 
-        // 将第一组条目分配到当前节点
-        for (size_t idx : group1)
+    template <size_t D>
+    void InternalNode<D>::splitQuantized(const Entry<D> &newEntry, InternalNode *newInternal)
+    {
+        // 量化节点没有条目数组：由子节点指针和子节点的精确MBR临时组成条目交给分裂策略，
+        // 两组分别用setEntries重新编码
+        static thread_local std::vector<Entry<D>> kept;
+        static thread_local std::vector<Entry<D>> moved;
+        kept.clear();
+        moved.clear();
+        size_t count = this->getEntryCount();
+        for (size_t i = 0; i < count; i++)
         {
-            m_entries.push_back(allEntries[idx]);
-            allEntries[idx].m_childNode->setParent(this);
+            kept.push_back(this->copyEntry(i));
         }
-
-        // 将第二组条目分配到新节点
-        for (size_t idx : group2)
+        kept.push_back(newEntry);
+
+        auto &groups = this->splitGroups();
+        this->m_tree->getSplitStrategy()->split(EntrySpan<D>(kept.data(), count), newEntry, groups.group1, groups.group2);
+        HitMask moving;
+        uint64_t *movingWords = moving.reset(count + 1);
+        std::fill(movingWords, movingWords + maskWords(count + 1), 0);
+        for (size_t idx : groups.group2)
         {
-            newInternal->m_entries.push_back(allEntries[idx]);
-            allEntries[idx].m_childNode->setParent(newInternal);
+            movingWords[idx >> 6] |= uint64_t(1) << (idx & 63);
+            moved.push_back(kept[idx]);
+        }
+        size_t keptCount = 0;
+        for (size_t i = 0; i <= count; i++)
+        {
+            if (!moving.test(i))
+            {
+                if (keptCount != i)
+                {
+                    kept[keptCount] = kept[i];
+                }
+                keptCount++;
+            }
         }
 
-        // 更新MBR
-        updateMBR();
-        newInternal->updateMBR();
-
-        // 设置新节点的父节点
-        newInternal->setParent(m_parent);
+        this->setEntries(kept.data(), keptCount);
+        newInternal->setEntries(moved.data(), moved.size());
+        newInternal->setParent(this->getParent());
     }
 
-    Node *InternalNode::findLeaf(id_type id, const Region &mbr)
+    template <size_t D>
+    Node<D> *InternalNode<D>::findLeaf(id_type id, const Region<D> &mbr)
     {
+        if (this->usesBounds() || this->usesFloatBounds() || this->isQuantized())
+        {
+            // SoA + SIMD扫描：先求出所有相交的子节点，再按顺序递归
+            HitMask mask;
+            this->intersectMask(mbr, mask);
+            for (size_t i = 0; i < this->getEntryCount(); i++)
+            {
+                if (mask.test(i))
+                {
+                    Node<D> *result = static_cast<Node<D> *>(this->getPayload(i))->findLeaf(id, mbr);
+                    if (result)
+                    {
+                        return result;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
         // 首先检查当前节点的条目
-        for (const auto &entry : m_entries)
+        for (const auto &entry : this->m_entries)
         {
             if (entry.m_region.intersectsRegion(mbr))
             {
                 // 递归检查子节点
-                Node *result = entry.m_childNode->findLeaf(id, mbr);
+                Node<D> *result = entry.m_childNode->findLeaf(id, mbr);
                 if (result)
                 {
                     return result;
@@ -245,11 +748,23 @@ namespace RTree
         return nullptr;
     }
 
-    void InternalNode::addChild(Node *child, const Region &mbr, id_type id)
+    template <size_t D>
+    void InternalNode<D>::addChild(Node<D> *child, const Region<D> &mbr, id_type id)
     {
-        Entry entry(mbr, id, child);
-        insertEntry(entry);
+        Entry<D> entry(mbr, id, child);
+        this->insertEntry(entry);
         child->setParent(this);
     }
 
-} // namespace RTree
\ No newline at end of file
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class Node<DynamicDimension>;
+    template class Node<2>;
+    template class Node<3>;
+    template class LeafNode<DynamicDimension>;
+    template class LeafNode<2>;
+    template class LeafNode<3>;
+    template class InternalNode<DynamicDimension>;
+    template class InternalNode<2>;
+    template class InternalNode<3>;
+
+} // namespace RTree
@@ -2,85 +2,256 @@
 #define RTREE_NODE_H
 
 #include <vector>
-#include "Entry.h"
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include "EntryArray.h"
+#include "NodeBounds.h"
+#include "OptimisticLock.h"
+#include "NodeAllocator.h"
+#include "SharedNodeTable.h"
 
 namespace RTree
 {
 
     // 前向声明
+    template <size_t D>
     class RTree;
 
     // 节点基类
+    template <size_t D = DynamicDimension>
     class Node
     {
     protected:
-        bool m_isLeaf;                // 是否是叶子节点
-        size_t m_level;               // 树中的层级 (0为叶子)
-        std::vector<Entry> m_entries; // 条目列表
-        Region m_nodeMBR;             // 节点的MBR
-        Node *m_parent;               // 父节点指针
-        RTree *m_tree;                // 所属树的指针
+        bool m_isLeaf;                   // 是否是叶子节点
+        uint32_t m_blockClass;           // 节点所在块在分配器中的块大小编号
+        size_t m_level;                  // 树中的层级 (0为叶子)
+        EntryArray<D> m_entries;         // 条目数组（存储紧跟在节点对象之后，与节点同在一个slab块中）
+        Region<D> m_nodeMBR;             // 节点的MBR
+        std::atomic<Node *> m_parent;    // 父节点指针（R-link模式下由持有父节点写锁的线程修改）
+        RTree<D> *m_tree;                // 所属树的指针
+        NodeBounds<D> m_bounds;          // SoA模式下与m_entries同步的边界数组（存储是同一分配器的另一个块）
+        NodeBounds<D, float> m_floatBounds; // float SoA模式下代替m_bounds的边界数组
+        QuantizedBounds<D> m_quantized;  // 量化布局的内部节点：子节点指针和编码，此时m_entries为空
+
+        // 并发模式（R-link/乐观）才需要的同步状态，单线程模式下不分配
+        struct SyncState
+        {
+            uint64_t nsn;                        // 节点序号(NSN)：R-link模式下每次分裂取全局计数器的新值
+            Node *rightLink;                     // 右链：指向最近一次分裂出的右兄弟
+            std::shared_timed_mutex latch;       // 节点锁：读者共享，写者独占
+            OptimisticLock versionLock;          // 乐观并发模式的版本锁
+
+            SyncState() : nsn(0), rightLink(nullptr) {}
+        };
+        std::unique_ptr<SyncState> m_sync; // 由树在开启并发模式时或并发模式下创建节点时分配
+
+        // 所属树是否使用SoA布局
+        bool usesBounds() const;
+        // 所属树是否使用float SoA布局
+        bool usesFloatBounds() const;
+        // 按当前m_nodeMBR重新编码全部子节点（量化布局）
+        void encodeChildren();
 
     public:
-        Node(bool isLeaf, size_t level, RTree *tree)
-            : m_isLeaf(isLeaf), m_level(level), m_parent(nullptr), m_tree(tree) {}
+        // 节点的存储：条目数组（由树在节点所在的块中划出）、容量、提供SoA边界和编码块的分配器、
+        // 节点块的块大小编号；codeBits非0时是量化的内部节点，不使用条目数组（entries为空）
+        struct Storage
+        {
+            Entry<D> *entries;
+            size_t capacity;
+            NodeAllocator *allocator;
+            size_t blockClass;
+            size_t codeBits;
+        };
+
+        Node(bool isLeaf, size_t level, RTree<D> *tree, const Storage &storage)
+            : m_isLeaf(isLeaf), m_blockClass(static_cast<uint32_t>(storage.blockClass)), m_level(level),
+              m_entries(storage.entries, storage.codeBits ? 0 : storage.capacity), m_parent(nullptr), m_tree(tree)
+        {
+            m_bounds.init(storage.capacity, storage.allocator);
+            m_floatBounds.init(storage.capacity, storage.allocator);
+            if (storage.codeBits)
+            {
+                m_quantized.init(storage.capacity, storage.codeBits, storage.allocator);
+            }
+        }
         virtual ~Node() {}
 
         bool isLeaf() const { return m_isLeaf; }
         size_t getLevel() const { return m_level; }
-        const Region &getMBR() const { return m_nodeMBR; }
-        size_t getEntryCount() const { return m_entries.size(); }
-        void setTree(RTree *tree) { m_tree = tree; }
-        RTree *getTree() const { return m_tree; }
+        size_t getBlockClass() const { return m_blockClass; }
+        const Region<D> &getMBR() const { return m_nodeMBR; }
+        size_t getEntryCount() const { return m_quantized.enabled() ? m_quantized.size() : m_entries.size(); }
+        // 是否是量化布局的内部节点（只有子节点指针和编码，没有条目）
+        bool isQuantized() const { return m_quantized.enabled(); }
+        uint64_t getLargestHilbertValue() const;
+        void setTree(RTree<D> *tree) { m_tree = tree; }
+        RTree<D> *getTree() const { return m_tree; }
 
-        virtual void insertEntry(const Entry &entry);
+        virtual void insertEntry(const Entry<D> &entry);
+        // 在index处插入条目（Hilbert模式保持条目有序）
+        void insertEntryAt(size_t index, const Entry<D> &entry);
+        // 一次性替换全部条目（批量装载用，条目从entries中移出），只计算一次MBR
+        void setEntries(Entry<D> *entries, size_t count);
         void updateMBR();
-        const Entry &getEntry(size_t index) const { return m_entries[index]; }
-        Entry &getEntryRef(size_t index) { return m_entries[index]; }
+        // 条目访问（量化的内部节点没有条目，改用getChild/getChildMBR/copyEntry）
+        const Entry<D> &getEntry(size_t index) const { return m_entries[index]; }
+        Entry<D> &getEntryRef(size_t index) { return m_entries[index]; }
+        // 内部节点的第index个子节点
+        Node *getChild(size_t index) const
+        {
+            return m_quantized.enabled() ? static_cast<Node *>(m_quantized.payload(index)) : m_entries[index].m_childNode;
+        }
+        // 内部节点第index个子节点的区域：量化布局下取子节点自己的MBR
+        const Region<D> &getChildMBR(size_t index) const
+        {
+            return m_quantized.enabled() ? getChild(index)->getMBR() : m_entries[index].m_region;
+        }
+        // 第index个条目的副本；量化的内部节点由子节点指针和子节点的MBR组成
+        Entry<D> copyEntry(size_t index) const;
+        // 量化布局下region必须是子节点当前的MBR
+        void setEntryRegion(size_t index, const Region<D> &region);
+        // 替换第index个条目的子节点（路径复制时指向副本）
+        void setEntryChild(size_t index, Node *child);
+
+        // SoA边界数组（仅在NodeLayout::StructOfArrays下有效）
+        const NodeBounds<D> &getBounds() const { return m_bounds; }
+        // float边界数组（仅在NodeLayout::StructOfArraysFloat下有效）
+        const NodeBounds<D, float> &getFloatBounds() const { return m_floatBounds; }
+        void syncBounds();
+
+        // 计算所有条目与query的相交位图：SoA/float模式使用SIMD内核，否则逐条检测。
+        // float边界的叶子命中再用条目的double区域复核，结果与其他布局一致
+        void intersectMask(const Region<D> &query, HitMask &mask) const;
+        // 同上，由调用者指定是否使用SoA/float边界（快照可能比所属树活得更久，不能再访问树）
+        void intersectMask(const Region<D> &query, HitMask &mask, bool useBounds) const;
+
+        // 第index个条目的子节点指针或数据指针（SoA/float模式下从平行数组读取，不触及条目本身）
+        void *getPayload(size_t index) const
+        {
+            if (m_quantized.enabled())
+            {
+                return m_quantized.payload(index);
+            }
+            if (!m_bounds.empty())
+            {
+                return m_bounds.payload(index);
+            }
+            if (!m_floatBounds.empty())
+            {
+                return m_floatBounds.payload(index);
+            }
+            const Entry<D> &entry = m_entries[index];
+            return m_isLeaf ? entry.m_data : static_cast<void *>(entry.m_childNode);
+        }
+
+        Node *getParent() const { return m_parent.load(std::memory_order_relaxed); }
+        void setParent(Node *parent) { m_parent.store(parent, std::memory_order_relaxed); }
 
-        Node *getParent() const { return m_parent; }
-        void setParent(Node *parent) { m_parent = parent; }
+        // 分配/释放并发模式的同步状态；只能在没有其他线程访问本节点时调用
+        void enableSync()
+        {
+            if (!m_sync)
+            {
+                m_sync.reset(new SyncState());
+            }
+        }
+        void disableSync() { m_sync.reset(); }
 
-        virtual bool isOverflow(size_t maxEntries) const { return m_entries.size() > maxEntries; }
-        virtual bool isUnderflow(size_t minEntries) const { return m_entries.size() < minEntries; }
+        // R-link支持，调用者需持有本节点的锁（以下访问要求已调用enableSync）
+        uint64_t getNSN() const { return m_sync->nsn; }
+        Node *getRightLink() const { return m_sync->rightLink; }
+        std::shared_timed_mutex &getLatch() const { return m_sync->latch; }
 
-        virtual Node *chooseSubtree(const Region &mbr) = 0;
-        virtual Node *findLeaf(id_type id, const Region &mbr);
+        // 乐观并发支持：版本锁（条目数组和SoA边界容量固定，读者并发读取时不会被重新分配）
+        OptimisticLock &getVersionLock() const { return m_sync->versionLock; }
+
+        // 释放node的一个引用（引用计数见SharedNodeTable），最后一个引用释放时节点析构后放回allocator，
+        // 并继续释放其子节点
+        static void releaseSubtree(Node *node, NodeAllocator &allocator, SharedNodeTable &shared);
+
+        // 分裂后把newNode接到右侧：newNode继承本节点原来的NSN和右链，本节点取新的NSN。
+        // 读者若发现节点NSN大于读取父节点时记下的计数器值，就沿右链补上分出去的条目
+        void linkRight(Node *newNode, uint64_t nsn)
+        {
+            newNode->m_sync->nsn = m_sync->nsn;
+            newNode->m_sync->rightLink = m_sync->rightLink;
+            m_sync->nsn = nsn;
+            m_sync->rightLink = newNode;
+        }
+
+        virtual bool isOverflow(size_t maxEntries) const { return getEntryCount() > maxEntries; }
+        virtual bool isUnderflow(size_t minEntries) const { return getEntryCount() < minEntries; }
+
+        virtual Node *chooseSubtree(const Region<D> &mbr) = 0;
+        virtual Node *findLeaf(id_type id, const Region<D> &mbr);
 
         int findEntry(id_type id) const;
+        int findChild(const Node *child) const;
         void removeEntry(size_t index);
 
-        virtual void split(const Entry &newEntry, Node *&newNode, size_t maxEntries) = 0;
+        // 将当前节点的条目与newEntry一起分裂到当前节点和newNode中
+        virtual void split(const Entry<D> &newEntry, Node *&newNode, size_t maxEntries) = 0;
+
+    protected:
+        // 分裂策略输出的两组下标；每个线程复用同一份，分裂时不必重新申请
+        struct SplitGroups
+        {
+            std::vector<size_t> group1;
+            std::vector<size_t> group2;
+        };
+        static SplitGroups &splitGroups()
+        {
+            static thread_local SplitGroups groups;
+            return groups;
+        }
+
+        // 落实分裂结果：group2中的条目（下标等于条目数时指newEntry）移入other，其余条目在原数组中前移。
+        // 不复制整个条目数组，条目数组和SoA边界都留在原来的块中
+        void distributeEntries(const Entry<D> &newEntry, const std::vector<size_t> &group2, Node *other);
     };
 
     // 叶子节点
-    class LeafNode : public Node
+    template <size_t D = DynamicDimension>
+    class LeafNode : public Node<D>
     {
     public:
-        LeafNode(RTree *tree = nullptr) : Node(true, 0, tree) {}
+        LeafNode(RTree<D> *tree, const typename Node<D>::Storage &storage)
+            : Node<D>(true, 0, tree, storage) {}
         ~LeafNode() override;
 
-        void insertData(void *data, size_t dataSize, const Region &mbr, id_type id);
-        void split(const Entry &newEntry, Node *&newNode, size_t maxEntries) override;
-        Node *findLeaf(id_type id, const Region &mbr) override;
-        Node *chooseSubtree(const Region &mbr) override { return this; }
-        std::vector<void *> search(const Region &query) const;
+        void insertData(void *data, size_t dataSize, const Region<D> &mbr, id_type id);
+        void split(const Entry<D> &newEntry, Node<D> *&newNode, size_t maxEntries) override;
+        Node<D> *findLeaf(id_type id, const Region<D> &mbr) override;
+        Node<D> *chooseSubtree(const Region<D> &) override { return this; }
+        std::vector<void *> search(const Region<D> &query) const;
     };
 
     // 内部节点
-    class InternalNode : public Node
+    template <size_t D = DynamicDimension>
+    class InternalNode : public Node<D>
     {
     public:
-        InternalNode(size_t level, RTree *tree = nullptr) : Node(false, level, tree) {}
+        InternalNode(size_t level, RTree<D> *tree, const typename Node<D>::Storage &storage)
+            : Node<D>(false, level, tree, storage) {}
         ~InternalNode() override;
 
-        Node *getChild(size_t index) const { return m_entries[index].m_childNode; }
-        Node *chooseSubtree(const Region &mbr) override;
-        void split(const Entry &newEntry, Node *&newNode, size_t maxEntries) override;
-        Node *findLeaf(id_type id, const Region &mbr) override;
-        void addChild(Node *child, const Region &mbr, id_type id);
+        // 在本节点的子节点中选择插入mbr时面积扩展最小的一个
+        Node<D> *chooseChild(const Region<D> &mbr) const;
+        // R*-tree：选择插入mbr后与其他兄弟的重叠面积增加最小的子节点（其次面积扩展最小、面积最小），
+        // 只在面积扩展最小的若干个候选中比较，避免大节点上的平方代价
+        Node<D> *chooseChildLeastOverlap(const Region<D> &mbr) const;
+        Node<D> *chooseSubtree(const Region<D> &mbr) override;
+        void split(const Entry<D> &newEntry, Node<D> *&newNode, size_t maxEntries) override;
+        Node<D> *findLeaf(id_type id, const Region<D> &mbr) override;
+        void addChild(Node<D> *child, const Region<D> &mbr, id_type id);
+
+    private:
+        // 量化节点的分裂：子节点和newEntry按分裂策略分到本节点和newInternal
+        void splitQuantized(const Entry<D> &newEntry, InternalNode *newInternal);
     };
 
 } // namespace RTree
 
-#endif // RTREE_NODE_H
\ No newline at end of file
+#endif // RTREE_NODE_H
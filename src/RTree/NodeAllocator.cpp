@@ -0,0 +1,204 @@
+#include "NodeAllocator.h"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace RTree
+{
+
+    NodeAllocator::NodeAllocator(size_t blockSize, bool hugePages)
+        : m_hugePages(hugePages)
+    {
+        addSizeClass(blockSize);
+    }
+
+    size_t NodeAllocator::addSizeClass(size_t blockSize)
+    {
+        // 块大小向上取整到Alignment，至少能放下空闲链表指针
+        blockSize = std::max(blockSize, sizeof(FreeBlock));
+        blockSize = (blockSize + Alignment - 1) / Alignment * Alignment;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_classes.push_back({blockSize, nullptr, nullptr, nullptr, 0});
+        return m_classes.size() - 1;
+    }
+
+    size_t NodeAllocator::findSizeClass(size_t bytes) const
+    {
+        size_t best = NoSizeClass;
+        for (size_t i = 0; i < m_classes.size(); i++)
+        {
+            if (m_classes[i].blockSize >= bytes && (best == NoSizeClass || m_classes[i].blockSize < m_classes[best].blockSize))
+            {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    NodeAllocator::~NodeAllocator()
+    {
+        release();
+    }
+
+    void NodeAllocator::setHugePages(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hugePages = enable;
+    }
+
+    void NodeAllocator::addSlab(SizeClass &sizeClass)
+    {
+        Slab slab = {nullptr, 0, false, false};
+        size_t bytes = m_hugePages ? HugePageSize : SlabSize;
+        // 超大的块（高维度节点）至少保证一个slab放得下若干块
+        bytes = std::max(bytes, sizeClass.blockSize * 16);
+
+#ifdef __linux__
+        if (m_hugePages)
+        {
+            bytes = (bytes + HugePageSize - 1) / HugePageSize * HugePageSize;
+
+            // 先尝试显式大页(hugetlbfs)，系统未预留大页时退回到透明大页
+            void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (memory != MAP_FAILED)
+            {
+                slab.memory = memory;
+                slab.mapped = true;
+                slab.huge = true;
+            }
+            else
+            {
+                memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (memory == MAP_FAILED)
+                {
+                    throw std::bad_alloc();
+                }
+                slab.memory = memory;
+                slab.mapped = true;
+                slab.huge = madvise(memory, bytes, MADV_HUGEPAGE) == 0;
+            }
+        }
+#endif
+        if (!slab.memory)
+        {
+            slab.memory = ::operator new(bytes);
+        }
+        slab.bytes = bytes;
+        m_slabs.push_back(slab);
+
+        // 起点对齐到Alignment
+        uintptr_t raw = reinterpret_cast<uintptr_t>(slab.memory);
+        uintptr_t aligned = (raw + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+        sizeClass.cursor = reinterpret_cast<char *>(aligned);
+        sizeClass.slabEnd = static_cast<char *>(slab.memory) + bytes;
+    }
+
+    void *NodeAllocator::allocate(size_t sizeClass)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SizeClass &target = m_classes[sizeClass];
+        target.liveBlocks++;
+
+        // 优先复用空闲链表中的块
+        if (target.freeList)
+        {
+            FreeBlock *block = target.freeList;
+            target.freeList = block->next;
+            return block;
+        }
+
+        if (!target.cursor || target.cursor + target.blockSize > target.slabEnd)
+        {
+            try
+            {
+                addSlab(target);
+            }
+            catch (...)
+            {
+                target.liveBlocks--;
+                throw;
+            }
+        }
+        void *block = target.cursor;
+        target.cursor += target.blockSize;
+        return block;
+    }
+
+    void NodeAllocator::deallocate(void *block, size_t sizeClass)
+    {
+        if (!block)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SizeClass &target = m_classes[sizeClass];
+        FreeBlock *freeBlock = static_cast<FreeBlock *>(block);
+        freeBlock->next = target.freeList;
+        target.freeList = freeBlock;
+        target.liveBlocks--;
+    }
+
+    void NodeAllocator::freeSlab(const Slab &slab)
+    {
+#ifdef __linux__
+        if (slab.mapped)
+        {
+            munmap(slab.memory, slab.bytes);
+            return;
+        }
+#endif
+        ::operator delete(slab.memory);
+    }
+
+    void NodeAllocator::release()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto &slab : m_slabs)
+        {
+            freeSlab(slab);
+        }
+        m_slabs.clear();
+        for (auto &sizeClass : m_classes)
+        {
+            sizeClass.freeList = nullptr;
+            sizeClass.cursor = nullptr;
+            sizeClass.slabEnd = nullptr;
+            sizeClass.liveBlocks = 0;
+        }
+    }
+
+    size_t NodeAllocator::getSlabCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_slabs.size();
+    }
+
+    size_t NodeAllocator::getLiveBlocks(size_t sizeClass) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_classes[sizeClass].liveBlocks;
+    }
+
+    size_t NodeAllocator::getHugePageSlabs() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t count = 0;
+        for (const auto &slab : m_slabs)
+        {
+            if (slab.huge)
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+} // namespace RTree
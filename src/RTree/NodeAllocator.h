@@ -0,0 +1,86 @@
+#ifndef RTREE_NODE_ALLOCATOR_H
+#define RTREE_NODE_ALLOCATOR_H
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+namespace RTree
+{
+
+    // 节点的slab分配器 - 按固定大小的块从大块内存(slab)中切分节点，
+    // 删除的节点放回空闲链表复用；整棵树释放时直接归还所有slab，不必逐个free。
+    // 除节点块外还可以登记其他块大小（SoA边界数组），每种大小有独立的slab和空闲链表。
+    // 可选用大页(2MB)作为slab，减少大树的TLB缺失。分配/释放有锁保护，可供并行装载使用。
+    class NodeAllocator
+    {
+    public:
+        static const size_t Alignment = 64;               // 块按cache line对齐
+        static const size_t SlabSize = 256 * 1024;         // 普通slab大小
+        static const size_t HugePageSize = 2 * 1024 * 1024; // 大页slab大小
+
+        static const size_t NoSizeClass = static_cast<size_t>(-1);
+
+        // blockSize为编号0的块大小（节点块）
+        explicit NodeAllocator(size_t blockSize, bool hugePages = false);
+        ~NodeAllocator();
+
+        NodeAllocator(const NodeAllocator &) = delete;
+        NodeAllocator &operator=(const NodeAllocator &) = delete;
+
+        // 登记一种块大小，返回其编号；只能在开始分配之前调用
+        size_t addSizeClass(size_t blockSize);
+        // 能放下bytes字节的最小块大小的编号，没有时返回NoSizeClass
+        size_t findSizeClass(size_t bytes) const;
+
+        void *allocate(size_t sizeClass = 0);
+        void deallocate(void *block, size_t sizeClass = 0);
+
+        // 归还所有slab；调用者保证其中的对象已不再使用
+        void release();
+
+        // 只影响之后新申请的slab
+        void setHugePages(bool enable);
+        bool getHugePages() const { return m_hugePages; }
+
+        size_t getBlockSize(size_t sizeClass = 0) const { return m_classes[sizeClass].blockSize; }
+        size_t getSizeClassCount() const { return m_classes.size(); }
+        size_t getSlabCount() const;
+        size_t getLiveBlocks(size_t sizeClass = 0) const;
+        size_t getHugePageSlabs() const;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+        struct Slab
+        {
+            void *memory;
+            size_t bytes;
+            bool mapped; // true: mmap得到（需munmap），false: operator new得到
+            bool huge;   // 是否实际使用了大页
+        };
+
+        struct SizeClass
+        {
+            size_t blockSize;
+            FreeBlock *freeList;
+            char *cursor;  // 当前slab中尚未切分部分的起点
+            char *slabEnd; // 当前slab末尾
+            size_t liveBlocks;
+        };
+
+        bool m_hugePages;
+        std::vector<Slab> m_slabs;
+        std::vector<SizeClass> m_classes;
+        mutable std::mutex m_mutex;
+
+        void addSlab(SizeClass &sizeClass);
+        static void freeSlab(const Slab &slab);
+    };
+
+} // namespace RTree
+
+#endif // RTREE_NODE_ALLOCATOR_H
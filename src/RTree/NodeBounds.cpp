@@ -0,0 +1,530 @@
+#include "NodeBounds.h"
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace RTree
+{
+
+    namespace
+    {
+        // 把double坐标存为T：下界向下、上界向上取整，存储的区间总是包含原区间
+        template <class T>
+        struct Outward
+        {
+            static T down(double value) { return value; }
+            static T up(double value) { return value; }
+        };
+
+        template <>
+        struct Outward<float>
+        {
+            static float down(double value)
+            {
+                float result = static_cast<float>(value);
+                return result > value ? std::nextafter(result, -std::numeric_limits<float>::infinity()) : result;
+            }
+            static float up(double value)
+            {
+                float result = static_cast<float>(value);
+                return result < value ? std::nextafter(result, std::numeric_limits<float>::infinity()) : result;
+            }
+        };
+    }
+
+    template <size_t D, class T>
+    void NodeBounds<D, T>::init(size_t capacity, NodeAllocator *allocator)
+    {
+        release();
+        m_capacity = (capacity + Lane - 1) / Lane * Lane;
+        m_allocator = allocator;
+    }
+
+    template <size_t D, class T>
+    size_t NodeBounds<D, T>::storageBytes(size_t capacity, size_t dimension)
+    {
+        size_t lanes = (capacity + Lane - 1) / Lane * Lane;
+        return 2 * dimension * lanes * sizeof(T) + lanes * sizeof(void *);
+    }
+
+    template <size_t D, class T>
+    void NodeBounds<D, T>::release()
+    {
+        if (m_sizeClass != NoBlockClass)
+        {
+            m_allocator->deallocate(m_block, m_sizeClass);
+        }
+        else
+        {
+            delete[] m_block;
+        }
+        m_block = nullptr;
+        m_sizeClass = NoBlockClass;
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    template <size_t D, class T>
+    void NodeBounds<D, T>::ensureStorage(size_t dimension)
+    {
+        if (m_block && dimension == m_dimension)
+        {
+            return;
+        }
+
+        // 固定维度的树按maxEntries和D登记了正好放得下的块大小；动态维度借用放得下的节点块，都放不下时退回到堆
+        release();
+        size_t bytes = storageBytes(m_capacity, dimension);
+        size_t sizeClass = m_allocator ? m_allocator->findSizeClass(bytes) : NodeAllocator::NoSizeClass;
+        if (sizeClass != NodeAllocator::NoSizeClass)
+        {
+            m_block = static_cast<unsigned char *>(m_allocator->allocate(sizeClass));
+            m_sizeClass = static_cast<uint32_t>(sizeClass);
+            m_data = reinterpret_cast<T *>(m_block);
+        }
+        else
+        {
+            m_block = new unsigned char[bytes + Alignment];
+            uintptr_t raw = reinterpret_cast<uintptr_t>(m_block);
+            m_data = reinterpret_cast<T *>((raw + Alignment - 1) & ~(uintptr_t)(Alignment - 1));
+        }
+        // SIMD内核按整块读取，段尾的填充区清零
+        std::memset(m_data, 0, 2 * dimension * m_capacity * sizeof(T));
+        m_dimension = dimension;
+    }
+
+    template <size_t D, class T>
+    void *NodeBounds<D, T>::payloadOf(const Entry<D> &entry)
+    {
+        return entry.isLeaf ? entry.m_data : static_cast<void *>(entry.m_childNode);
+    }
+
+    template <size_t D, class T>
+    void NodeBounds<D, T>::assign(EntrySpan<D> entries)
+    {
+        clear();
+        if (entries.empty())
+        {
+            return;
+        }
+
+        ensureStorage(entries[0].m_region.getDimension());
+        for (const auto &entry : entries)
+        {
+            push(entry);
+        }
+    }
+
+    template <size_t D, class T>
+    void NodeBounds<D, T>::push(const Entry<D> &entry)
+    {
+        ensureStorage(entry.m_region.getDimension());
+        payloads()[m_size] = payloadOf(entry);
+        m_size++;
+        set(m_size - 1, entry.m_region);
+    }
+
+    template <size_t D, class T>
+    void NodeBounds<D, T>::erase(size_t index)
+    {
+        if (index >= m_size)
+        {
+            return;
+        }
+
+        // 每一维的数组中把index之后的元素前移一位，保持与Entry数组顺序一致
+        size_t tail = m_size - index - 1;
+        for (size_t d = 0; d < 2 * m_dimension; d++)
+        {
+            T *column = m_data + d * m_capacity;
+            std::memmove(column + index, column + index + 1, tail * sizeof(T));
+        }
+        void **payload = payloads();
+        std::memmove(payload + index, payload + index + 1, tail * sizeof(void *));
+        m_size--;
+    }
+
+    template <size_t D, class T>
+    void NodeBounds<D, T>::set(size_t index, const Region<D> &region)
+    {
+        for (size_t d = 0; d < m_dimension; d++)
+        {
+            m_data[d * m_capacity + index] = Outward<T>::down(region.m_low[d]);
+            m_data[(m_dimension + d) * m_capacity + index] = Outward<T>::up(region.m_high[d]);
+        }
+    }
+
+    template <size_t D, class T>
+    bool NodeBounds<D, T>::intersects(size_t index, const Region<D> &query) const
+    {
+        if (m_dimension != query.getDimension())
+            return false;
+
+        for (size_t d = 0; d < m_dimension; d++)
+        {
+            if (low(d)[index] > query.m_high[d] || high(d)[index] < query.m_low[d])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <size_t D, class T>
+    bool NodeBounds<D, T>::covers(size_t index, const Region<D> &region) const
+    {
+        for (size_t d = 0; d < m_dimension; d++)
+        {
+            if (low(d)[index] > region.m_low[d] || high(d)[index] < region.m_high[d])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <size_t D, class T>
+    size_t NodeBounds<D, T>::chooseLeastEnlargement(const Region<D> &region) const
+    {
+        double minEnlargement = std::numeric_limits<double>::max();
+        double minArea = std::numeric_limits<double>::max();
+        size_t chosen = 0;
+        for (size_t i = 0; i < m_size; i++)
+        {
+            double area = 1.0;
+            double combined = 1.0;
+            for (size_t d = 0; d < m_dimension; d++)
+            {
+                double lowValue = low(d)[i];
+                double highValue = high(d)[i];
+                area *= highValue - lowValue;
+                combined *= std::max(highValue, region.m_high[d]) - std::min(lowValue, region.m_low[d]);
+            }
+            double enlargement = combined - area;
+            if (enlargement < minEnlargement || (enlargement == minEnlargement && area < minArea))
+            {
+                minEnlargement = enlargement;
+                minArea = area;
+                chosen = i;
+            }
+        }
+        return chosen;
+    }
+
+    template <size_t D, class T>
+    void NodeBounds<D, T>::intersectMask(const Region<D> &query, HitMask &mask) const
+    {
+        uint64_t *words = mask.reset(m_size);
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        if (m_dimension != query.getDimension())
+        {
+            std::memset(words, 0, maskWords(m_size) * sizeof(uint64_t));
+            return;
+        }
+
+        // 查询区域按同样的规则向外取整（double时原样复制）
+        const size_t LocalDims = 16;
+        T local[2 * LocalDims];
+        std::vector<T> heap;
+        T *queryBounds = local;
+        if (m_dimension > LocalDims)
+        {
+            heap.resize(2 * m_dimension);
+            queryBounds = heap.data();
+        }
+        for (size_t d = 0; d < m_dimension; d++)
+        {
+            queryBounds[d] = Outward<T>::down(query.m_low[d]);
+            queryBounds[m_dimension + d] = Outward<T>::up(query.m_high[d]);
+        }
+        intersectBatch(m_data, m_capacity, m_size, m_dimension, queryBounds, queryBounds + m_dimension, words);
+    }
+
+    template <size_t D>
+    size_t QuantizedBounds<D>::lanes(size_t capacity)
+    {
+        return (capacity + 7) / 8 * 8;
+    }
+
+    template <size_t D>
+    void QuantizedBounds<D>::init(size_t capacity, size_t bits, NodeAllocator *allocator)
+    {
+        if (bits != 8 && bits != 16)
+        {
+            throw std::invalid_argument("quantized bounds support 8 or 16 bits");
+        }
+        release();
+        m_capacity = static_cast<uint32_t>(capacity);
+        m_bits = static_cast<uint32_t>(bits);
+        m_allocator = allocator;
+    }
+
+    template <size_t D>
+    size_t QuantizedBounds<D>::storageBytes(size_t capacity, size_t dimension, size_t bits)
+    {
+        return 2 * dimension * lanes(capacity) * (bits / 8) + capacity * sizeof(void *);
+    }
+
+    template <size_t D>
+    void QuantizedBounds<D>::release()
+    {
+        if (m_sizeClass != NoBlockClass)
+        {
+            m_allocator->deallocate(m_block, m_sizeClass);
+        }
+        else
+        {
+            delete[] m_block;
+        }
+        m_block = nullptr;
+        m_sizeClass = NoBlockClass;
+        m_codes = nullptr;
+        m_size = 0;
+    }
+
+    template <size_t D>
+    void QuantizedBounds<D>::ensureStorage(size_t dimension)
+    {
+        if (m_block && dimension == m_dimension)
+        {
+            return;
+        }
+
+        // 与NodeBounds相同：优先取分配器中放得下的最小块，都放不下时退回到堆
+        release();
+        size_t bytes = storageBytes(m_capacity, dimension, m_bits);
+        size_t sizeClass = m_allocator ? m_allocator->findSizeClass(bytes) : NodeAllocator::NoSizeClass;
+        if (sizeClass != NodeAllocator::NoSizeClass)
+        {
+            m_block = static_cast<unsigned char *>(m_allocator->allocate(sizeClass));
+            m_sizeClass = static_cast<uint32_t>(sizeClass);
+            m_codes = m_block;
+        }
+        else
+        {
+            m_block = new unsigned char[bytes + Alignment];
+            uintptr_t raw = reinterpret_cast<uintptr_t>(m_block);
+            m_codes = reinterpret_cast<unsigned char *>((raw + Alignment - 1) & ~(uintptr_t)(Alignment - 1));
+        }
+        m_dimension = static_cast<uint32_t>(dimension);
+    }
+
+    namespace
+    {
+        // 把value映射到[0, maxCode]：下界向下、上界向上取整，超出参考区域的部分截断到两端。
+        // 参考区域在这一维退化（或不是有限值）时scale为0，所有编码都是0
+        inline uint32_t encodeLow(double value, double origin, double scale, uint32_t maxCode)
+        {
+            double code = std::floor((value - origin) * scale);
+            if (!(code > 0))
+                return 0;
+            return code >= maxCode ? maxCode : static_cast<uint32_t>(code);
+        }
+
+        inline uint32_t encodeHigh(double value, double origin, double scale, uint32_t maxCode)
+        {
+            double code = std::ceil((value - origin) * scale);
+            if (!(code > 0))
+                return 0;
+            return code >= maxCode ? maxCode : static_cast<uint32_t>(code);
+        }
+
+        inline double codeScale(double low, double high, uint32_t maxCode)
+        {
+            double span = high - low;
+            return span > 0 && std::isfinite(span) ? maxCode / span : 0.0;
+        }
+
+        template <class Code>
+        void storeCodes(unsigned char *codes, size_t lanes, size_t dimension, size_t index,
+                        const uint32_t *values)
+        {
+            Code *column = reinterpret_cast<Code *>(codes);
+            for (size_t d = 0; d < 2 * dimension; d++)
+            {
+                column[d * lanes + index] = static_cast<Code>(values[d]);
+            }
+        }
+
+        template <class Code>
+        void moveCodes(unsigned char *codes, size_t lanes, size_t dimension, size_t index, size_t tail)
+        {
+            Code *column = reinterpret_cast<Code *>(codes);
+            for (size_t d = 0; d < 2 * dimension; d++)
+            {
+                std::memmove(column + d * lanes + index, column + d * lanes + index + 1, tail * sizeof(Code));
+            }
+        }
+
+        // 与intersectScalar相同的按列扫描，编码与查询编码都是闭区间
+        template <class Code>
+        void intersectCodes(const unsigned char *codes, size_t lanes, size_t count, size_t dimension,
+                            const uint32_t *queryLow, const uint32_t *queryHigh, uint64_t *words)
+        {
+            const Code *column = reinterpret_cast<const Code *>(codes);
+            for (size_t base = 0; base < count; base += 64)
+            {
+                size_t n = std::min<size_t>(64, count - base);
+                uint64_t bits = n == 64 ? ~0ULL : ((1ULL << n) - 1);
+                for (size_t d = 0; d < dimension && bits; d++)
+                {
+                    const Code *low = column + d * lanes + base;
+                    const Code *high = column + (dimension + d) * lanes + base;
+                    uint64_t hit = 0;
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        hit |= (uint64_t)(low[i] <= queryHigh[d] && high[i] >= queryLow[d]) << i;
+                    }
+                    bits &= hit;
+                }
+                words[base / 64] = bits;
+            }
+        }
+    }
+
+    template <size_t D>
+    void QuantizedBounds<D>::encode(size_t index, const Region<D> &region, const Region<D> &reference)
+    {
+        const size_t LocalDims = 16;
+        uint32_t local[2 * LocalDims];
+        std::vector<uint32_t> heap;
+        uint32_t *values = local;
+        if (m_dimension > LocalDims)
+        {
+            heap.resize(2 * m_dimension);
+            values = heap.data();
+        }
+
+        uint32_t maxCode = (1u << m_bits) - 1;
+        for (size_t d = 0; d < m_dimension; d++)
+        {
+            double scale = codeScale(reference.m_low[d], reference.m_high[d], maxCode);
+            values[d] = encodeLow(region.m_low[d], reference.m_low[d], scale, maxCode);
+            // 退化的参考区域中所有编码都是0，上界取满以保持保守
+            values[m_dimension + d] = scale > 0 ? encodeHigh(region.m_high[d], reference.m_low[d], scale, maxCode) : maxCode;
+        }
+
+        size_t lane = lanes(m_capacity);
+        if (m_bits == 8)
+            storeCodes<uint8_t>(m_codes, lane, m_dimension, index, values);
+        else
+            storeCodes<uint16_t>(m_codes, lane, m_dimension, index, values);
+    }
+
+    template <size_t D>
+    void QuantizedBounds<D>::push(void *child, const Region<D> &region, const Region<D> &reference)
+    {
+        if (m_size == m_capacity)
+        {
+            throw std::logic_error("node entry capacity exceeded");
+        }
+        ensureStorage(region.getDimension());
+        payloads()[m_size] = child;
+        m_size++;
+        encode(m_size - 1, region, reference);
+    }
+
+    template <size_t D>
+    void QuantizedBounds<D>::set(size_t index, const Region<D> &region, const Region<D> &reference)
+    {
+        encode(index, region, reference);
+    }
+
+    template <size_t D>
+    void QuantizedBounds<D>::erase(size_t index)
+    {
+        if (index >= m_size)
+        {
+            return;
+        }
+
+        size_t tail = m_size - index - 1;
+        size_t lane = lanes(m_capacity);
+        if (m_bits == 8)
+            moveCodes<uint8_t>(m_codes, lane, m_dimension, index, tail);
+        else
+            moveCodes<uint16_t>(m_codes, lane, m_dimension, index, tail);
+        void **payload = payloads();
+        std::memmove(payload + index, payload + index + 1, tail * sizeof(void *));
+        m_size--;
+    }
+
+    template <size_t D>
+    int QuantizedBounds<D>::find(const void *payload) const
+    {
+        void **children = payloads();
+        for (size_t i = 0; i < m_size; i++)
+        {
+            if (children[i] == payload)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    template <size_t D>
+    void QuantizedBounds<D>::intersectMask(const Region<D> &query, const Region<D> &reference, HitMask &mask) const
+    {
+        uint64_t *words = mask.reset(m_size);
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        if (m_dimension != query.getDimension())
+        {
+            std::memset(words, 0, maskWords(m_size) * sizeof(uint64_t));
+            return;
+        }
+
+        // 查询区域经同一映射向外取整；与参考区域不相交的维度直接无结果
+        const size_t LocalDims = 16;
+        uint32_t local[2 * LocalDims];
+        std::vector<uint32_t> heap;
+        uint32_t *queryCodes = local;
+        if (m_dimension > LocalDims)
+        {
+            heap.resize(2 * m_dimension);
+            queryCodes = heap.data();
+        }
+
+        uint32_t maxCode = (1u << m_bits) - 1;
+        for (size_t d = 0; d < m_dimension; d++)
+        {
+            if (query.m_low[d] > reference.m_high[d] || query.m_high[d] < reference.m_low[d])
+            {
+                std::memset(words, 0, maskWords(m_size) * sizeof(uint64_t));
+                return;
+            }
+            double scale = codeScale(reference.m_low[d], reference.m_high[d], maxCode);
+            queryCodes[d] = encodeLow(query.m_low[d], reference.m_low[d], scale, maxCode);
+            queryCodes[m_dimension + d] = scale > 0 ? encodeHigh(query.m_high[d], reference.m_low[d], scale, maxCode) : maxCode;
+        }
+
+        size_t lane = lanes(m_capacity);
+        if (m_bits == 8)
+            intersectCodes<uint8_t>(m_codes, lane, m_size, m_dimension, queryCodes, queryCodes + m_dimension, words);
+        else
+            intersectCodes<uint16_t>(m_codes, lane, m_size, m_dimension, queryCodes, queryCodes + m_dimension, words);
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class NodeBounds<DynamicDimension>;
+    template class NodeBounds<2>;
+    template class NodeBounds<3>;
+    template class NodeBounds<DynamicDimension, float>;
+    template class NodeBounds<2, float>;
+    template class NodeBounds<3, float>;
+    template class QuantizedBounds<DynamicDimension>;
+    template class QuantizedBounds<2>;
+    template class QuantizedBounds<3>;
+
+} // namespace RTree
@@ -0,0 +1,176 @@
+#ifndef RTREE_NODE_BOUNDS_H
+#define RTREE_NODE_BOUNDS_H
+
+#include <vector>
+#include <cstdint>
+#include "EntryArray.h"
+#include "SimdKernel.h"
+#include "NodeAllocator.h"
+
+namespace RTree
+{
+
+    // 节点存储模式
+    enum class NodeLayout
+    {
+        Entries,             // 仅使用Entry数组（AoS，默认）
+        StructOfArrays,      // 额外维护按维度连续存放的边界数组（SoA），扫描时使用
+        StructOfArraysFloat, // 以float存放SoA边界代替double（下界向下、上界向上取整），边界数组的内存减半，
+                             // 每个SIMD寄存器容纳两倍条目；叶子的命中再用条目的double区域复核
+        Quantized16,         // QR-tree：内部节点不存条目，只存子节点指针和子节点MBR相对本节点MBR的16位编码
+                             // （向外取整），精确的MBR取自子节点本身；叶子同Entries
+        Quantized8           // 同上，8位编码
+    };
+
+    // 布局是否量化内部节点
+    inline bool isQuantizedLayout(NodeLayout layout)
+    {
+        return layout == NodeLayout::Quantized16 || layout == NodeLayout::Quantized8;
+    }
+
+    // 量化布局的编码位数，其他布局为0
+    inline size_t quantizedBits(NodeLayout layout)
+    {
+        return layout == NodeLayout::Quantized16 ? 16 : (layout == NodeLayout::Quantized8 ? 8 : 0);
+    }
+
+    // 节点边界的SoA存储 - 每个维度的下界/上界各占一段连续、64字节对齐的数组，
+    // 子节点/数据指针存放在紧随其后的平行数组中。布局：
+    //   [low_0 ... | low_1 ... | ... | high_0 ... | high_1 ... | ... | payload ...]
+    // 每段长度为容量(一个cache line所含元素数的倍数)，因此扫描一个节点的某一维只会触及少数几个cache line。
+    // 容量由树的maxEntries决定，创建后不变；存储是节点分配器中按边界数组大小登记的块（没有合适的块大小时从堆分配）。
+    // T为float时坐标向外取整（下界向下、上界向上），查询区域同样向外取整，过滤结果只多不少
+    template <size_t D = DynamicDimension, class T = double>
+    class NodeBounds
+    {
+    public:
+        static const size_t Alignment = 64;               // cache line / AVX-512 对齐
+        static const size_t Lane = Alignment / sizeof(T); // 容量按8个double / 16个float对齐
+
+        NodeBounds()
+            : m_block(nullptr), m_allocator(nullptr), m_data(nullptr),
+              m_size(0), m_capacity(0), m_dimension(D), m_sizeClass(NoBlockClass) {}
+        ~NodeBounds() { release(); }
+        NodeBounds(const NodeBounds &) = delete;
+        NodeBounds &operator=(const NodeBounds &) = delete;
+
+        // 设定容量（向上取整到Lane）和存储来源；存储在第一次写入、维度确定时才申请
+        void init(size_t capacity, NodeAllocator *allocator);
+        // 容量为capacity、维度为dimension时边界数组与payload数组共占的字节数
+        static size_t storageBytes(size_t capacity, size_t dimension);
+
+        size_t size() const { return m_size; }
+        size_t capacity() const { return m_capacity; }
+        size_t getDimension() const { return m_dimension; }
+        bool empty() const { return m_size == 0; }
+
+        // 第d维的下界/上界数组，长度为size()
+        const T *low(size_t d) const { return m_data + d * m_capacity; }
+        const T *high(size_t d) const { return m_data + (m_dimension + d) * m_capacity; }
+        void *payload(size_t index) const { return payloads()[index]; }
+
+        void clear() { m_size = 0; }
+        // 归还存储（切换到Entries布局时）
+        void release();
+        void assign(EntrySpan<D> entries);
+        void push(const Entry<D> &entry);
+        void erase(size_t index);
+        void set(size_t index, const Region<D> &region);
+        void setPayload(size_t index, void *payload) { payloads()[index] = payload; }
+
+        bool intersects(size_t index, const Region<D> &query) const;
+        bool covers(size_t index, const Region<D> &region) const;
+
+        // 插入region时面积扩展最小（相同时面积最小）的条目下标，与InternalNode::chooseChild规则一致
+        size_t chooseLeastEnlargement(const Region<D> &region) const;
+
+        // 使用SIMD内核一次性检测所有条目，结果写入mask
+        void intersectMask(const Region<D> &query, HitMask &mask) const;
+
+    private:
+        static const uint32_t NoBlockClass = static_cast<uint32_t>(-1);
+
+        // 每个节点都带有这个对象，计数用32位、payload数组的位置现算，节点对象保持在4个cache line以内
+        unsigned char *m_block;      // 分配器的块，或堆内存（含对齐余量）
+        NodeAllocator *m_allocator;  // 存储来源，为空时使用堆
+        T *m_data;                   // 对齐后的边界数组起点，之后是payload数组（子节点指针或数据指针）
+        uint32_t m_size;
+        uint32_t m_capacity;
+        uint32_t m_dimension;
+        uint32_t m_sizeClass;        // m_block在m_allocator中的块大小编号，NoBlockClass表示来自堆
+
+        void **payloads() const { return reinterpret_cast<void **>(m_data + 2 * m_dimension * m_capacity); }
+        // 按dimension准备存储，维度改变时丢弃已有内容
+        void ensureStorage(size_t dimension);
+        static void *payloadOf(const Entry<D> &entry);
+    };
+
+    // 量化的子节点边界（QR-tree）- 量化布局下内部节点的全部存储：子节点指针和子节点MBR的8/16位编码，
+    // 不保存double区域（精确的MBR在子节点自己的m_nodeMBR中）。编码相对参考区域（所在节点的MBR）：
+    // 按 (x - low) * scale 映射到[0, 2^bits-1]，下界向下取整、上界向上取整；查询区域经同一映射
+    // （同样向外取整）后在整数上比较。映射与截断都单调，真实相交的子节点编码必然相交，只会多出少量假阳性。
+    // 参考区域不单独保存，由调用者每次传入；参考区域改变后调用者必须重新编码全部子节点。布局：
+    //   [low_0 ... | low_1 ... | ... | high_0 ... | high_1 ... | ... | child ...]
+    // 扫描是逐条的标量比较，每段只按8个编码取整（不按cache line填充，8位编码的块才真正变小），
+    // 子节点指针数组紧随其后，保持8字节对齐
+    template <size_t D = DynamicDimension>
+    class QuantizedBounds
+    {
+    public:
+        static const size_t Alignment = 64;
+
+        QuantizedBounds()
+            : m_block(nullptr), m_allocator(nullptr), m_codes(nullptr),
+              m_size(0), m_capacity(0), m_dimension(D), m_sizeClass(NoBlockClass), m_bits(0) {}
+        ~QuantizedBounds() { release(); }
+        QuantizedBounds(const QuantizedBounds &) = delete;
+        QuantizedBounds &operator=(const QuantizedBounds &) = delete;
+
+        // bits为8或16；存储在第一次写入、维度确定时才申请
+        void init(size_t capacity, size_t bits, NodeAllocator *allocator);
+        // 容量为capacity、维度为dimension时编码与子节点指针共占的字节数
+        static size_t storageBytes(size_t capacity, size_t dimension, size_t bits);
+
+        bool enabled() const { return m_bits != 0; }
+        size_t getBits() const { return m_bits; }
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        void *payload(size_t index) const { return payloads()[index]; }
+        void setPayload(size_t index, void *payload) { payloads()[index] = payload; }
+        // payload所在的下标，没有时返回-1
+        int find(const void *payload) const;
+
+        void clear() { m_size = 0; }
+        void release();
+        void push(void *child, const Region<D> &region, const Region<D> &reference);
+        void erase(size_t index);
+        void set(size_t index, const Region<D> &region, const Region<D> &reference);
+
+        // 编码与query相交的位图（保守：可能有假阳性，没有假阴性）
+        void intersectMask(const Region<D> &query, const Region<D> &reference, HitMask &mask) const;
+
+    private:
+        static const uint32_t NoBlockClass = static_cast<uint32_t>(-1);
+
+        unsigned char *m_block;     // 分配器的块，或堆内存（含对齐余量）
+        NodeAllocator *m_allocator; // 存储来源，为空时使用堆
+        unsigned char *m_codes;     // 对齐后的编码数组起点（uint8_t或uint16_t）
+        uint32_t m_size;
+        uint32_t m_capacity;
+        uint32_t m_dimension;
+        uint32_t m_sizeClass;       // m_block在m_allocator中的块大小编号，NoBlockClass表示来自堆
+        uint32_t m_bits;            // 0表示未启用（非量化布局）
+
+        // 每段编码的长度
+        static size_t lanes(size_t capacity);
+        void **payloads() const
+        {
+            return reinterpret_cast<void **>(m_codes + 2 * m_dimension * lanes(m_capacity) * (m_bits / 8));
+        }
+        void ensureStorage(size_t dimension);
+        void encode(size_t index, const Region<D> &region, const Region<D> &reference);
+    };
+
+} // namespace RTree
+
+#endif // RTREE_NODE_BOUNDS_H
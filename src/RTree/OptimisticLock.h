@@ -0,0 +1,75 @@
+#ifndef RTREE_OPTIMISTIC_LOCK_H
+#define RTREE_OPTIMISTIC_LOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace RTree
+{
+
+    // 乐观版本锁（Optimistic Lock Coupling）- 一个64位版本号：
+    //   bit0 = 废弃位（节点已从树中摘除，等待epoch回收）
+    //   bit1 = 写锁位
+    //   其余位 = 版本计数，每次写解锁加一
+    // 读者不写共享内存：先读版本号，读取内容，再确认版本号未变（validate），失败则重试。
+    // 写者用CAS把读到的版本号升级为写锁（tryUpgrade），保证读到的内容在加锁时仍然有效。
+    class OptimisticLock
+    {
+    public:
+        OptimisticLock() : m_version(0) {}
+
+        static bool isLocked(uint64_t version) { return (version & 2) != 0; }
+        static bool isObsolete(uint64_t version) { return (version & 1) != 0; }
+
+        // 读开始：返回当前版本号；被写锁或已废弃时返回的版本号不可用于读取
+        uint64_t beginRead() const { return m_version.load(std::memory_order_acquire); }
+
+        // 读结束：之前的普通读取完成后确认版本号未变
+        bool validate(uint64_t version) const
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return m_version.load(std::memory_order_relaxed) == version;
+        }
+
+        // 版本号仍为version时加写锁
+        bool tryUpgrade(uint64_t version)
+        {
+            if (isLocked(version) || isObsolete(version))
+            {
+                return false;
+            }
+            return m_version.compare_exchange_strong(version, version + 2, std::memory_order_acquire);
+        }
+
+        // 自旋等待直到加上写锁；节点已废弃时返回false
+        bool writeLock()
+        {
+            while (true)
+            {
+                uint64_t version = beginRead();
+                if (isObsolete(version))
+                {
+                    return false;
+                }
+                if (!isLocked(version) && tryUpgrade(version))
+                {
+                    return true;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        // 写解锁并递增版本号，返回新的版本号
+        uint64_t writeUnlock() { return m_version.fetch_add(2, std::memory_order_release) + 2; }
+
+        // 写解锁并标记为废弃
+        void writeUnlockObsolete() { m_version.fetch_add(3, std::memory_order_release); }
+
+    private:
+        std::atomic<uint64_t> m_version;
+    };
+
+} // namespace RTree
+
+#endif // RTREE_OPTIMISTIC_LOCK_H
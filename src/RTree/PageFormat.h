@@ -0,0 +1,81 @@
+#ifndef RTREE_PAGE_FORMAT_H
+#define RTREE_PAGE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace RTree
+{
+
+    // 持久化文件格式 - 文件由定长页组成，第0页为文件头，其余每页存放一个节点。
+    // 节点页的布局与NodeBounds一致，映射到内存后可以直接交给SIMD内核扫描：
+    //   [PageHeader(64字节) | low_0 ... | low_1 ... | ... | high_0 ... | high_1 ... | payload ...]
+    // 每段长度为capacity（8的倍数）；payload在内部节点中是子节点的页号，在叶子中是数据条目的ID。
+    // 所有数值按本机字节序存放，文件只能在字节序相同的机器间共享。
+    struct FileHeader
+    {
+        char magic[8];      // "RTREEPG1"
+        uint32_t version;   // 格式版本
+        uint32_t dimension; // 维度（空的动态维度树为0）
+        uint64_t pageSize;  // 页大小（字节），4KB的倍数
+        uint64_t capacity;  // 每页最多条目数
+        uint64_t pageCount; // 总页数（含文件头页）
+        uint64_t rootPage;  // 根节点页号
+        uint64_t height;    // 树高度
+        uint64_t size;      // 数据条目数
+    };
+
+    struct PageHeader
+    {
+        uint32_t level; // 层级（0为叶子）
+        uint32_t count; // 有效条目数
+        uint8_t reserved[56];
+    };
+
+    // 页内各部分的位置，由维度和容量决定
+    class PageLayout
+    {
+    public:
+        static const uint32_t Version = 1;
+        static const size_t HeaderSize = sizeof(PageHeader); // 64字节，保证边界数组按cache line对齐
+        static const size_t PageAlignment = 4096;
+
+        PageLayout() : m_dimension(0), m_capacity(0), m_pageSize(0) {}
+
+        // 能容纳maxEntries个条目的布局：容量向上取整到8，页大小向上取整到4KB
+        PageLayout(size_t dimension, size_t maxEntries)
+            : m_dimension(dimension), m_capacity((maxEntries + 7) / 8 * 8)
+        {
+            size_t bytes = HeaderSize + (2 * m_dimension + 1) * m_capacity * sizeof(double);
+            m_pageSize = (bytes + PageAlignment - 1) / PageAlignment * PageAlignment;
+        }
+
+        static void writeMagic(char *magic) { std::memcpy(magic, "RTREEPG1", 8); }
+        static bool checkMagic(const char *magic) { return std::memcmp(magic, "RTREEPG1", 8) == 0; }
+
+        size_t getDimension() const { return m_dimension; }
+        size_t getCapacity() const { return m_capacity; }
+        size_t getPageSize() const { return m_pageSize; }
+
+        // 页内的SoA边界数组与payload数组
+        double *bounds(unsigned char *page) const { return reinterpret_cast<double *>(page + HeaderSize); }
+        const double *bounds(const unsigned char *page) const { return reinterpret_cast<const double *>(page + HeaderSize); }
+        uint64_t *payload(unsigned char *page) const
+        {
+            return reinterpret_cast<uint64_t *>(page + HeaderSize + 2 * m_dimension * m_capacity * sizeof(double));
+        }
+        const uint64_t *payload(const unsigned char *page) const
+        {
+            return reinterpret_cast<const uint64_t *>(page + HeaderSize + 2 * m_dimension * m_capacity * sizeof(double));
+        }
+
+    private:
+        size_t m_dimension;
+        size_t m_capacity;
+        size_t m_pageSize;
+    };
+
+} // namespace RTree
+
+#endif // RTREE_PAGE_FORMAT_H
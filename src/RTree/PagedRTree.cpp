@@ -0,0 +1,475 @@
+#include "PagedRTree.h"
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace RTree
+{
+
+    template <size_t D>
+    PagedRTree<D>::PagedRTree(const std::string &path, size_t bufferFrames, std::shared_ptr<SplitStrategy<D>> strategy)
+        : m_splitStrategy(strategy), m_pinnedLevel(1), m_pinFloor(1)
+    {
+        // 先读文件头确定页大小
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        in.read(reinterpret_cast<char *>(&m_header), sizeof(m_header));
+        if (!in || !PageLayout::checkMagic(m_header.magic) || m_header.version != PageLayout::Version)
+        {
+            throw std::runtime_error("not an R-tree page file: " + path);
+        }
+        if (D != DynamicDimension && m_header.dimension != D)
+        {
+            throw std::runtime_error("page file dimension does not match the tree: " + path);
+        }
+        m_layout = PageLayout(m_header.dimension, m_header.capacity);
+        if (m_layout.getPageSize() != m_header.pageSize)
+        {
+            throw std::runtime_error("corrupt page file: " + path);
+        }
+        in.close();
+
+        m_pool.reset(new BufferPool(path, m_header.pageSize, bufferFrames, false));
+    }
+
+    template <size_t D>
+    PagedRTree<D>::PagedRTree(const std::string &path, size_t bufferFrames, size_t maxEntries, size_t dimension,
+                              std::shared_ptr<SplitStrategy<D>> strategy)
+        : m_layout(dimension, maxEntries), m_splitStrategy(strategy), m_pinnedLevel(1), m_pinFloor(1)
+    {
+        if (D != DynamicDimension && dimension != D)
+        {
+            throw std::invalid_argument("dimension does not match the tree");
+        }
+        if (maxEntries < 2)
+        {
+            throw std::invalid_argument("maxEntries must be at least 2");
+        }
+
+        std::memset(&m_header, 0, sizeof(m_header));
+        PageLayout::writeMagic(m_header.magic);
+        m_header.version = PageLayout::Version;
+        m_header.dimension = static_cast<uint32_t>(dimension);
+        m_header.pageSize = m_layout.getPageSize();
+        m_header.capacity = m_layout.getCapacity();
+        m_header.height = 1;
+        m_header.size = 0;
+
+        m_pool.reset(new BufferPool(path, m_header.pageSize, bufferFrames, true));
+        uint64_t headerPage;
+        m_pool->allocate(headerPage);
+        m_pool->unpin(headerPage, true);
+        allocatePage(m_header.rootPage, 0);
+        m_pool->unpin(m_header.rootPage, true);
+        writeHeader();
+    }
+
+    template <size_t D>
+    PagedRTree<D>::~PagedRTree()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            // 析构时无法报告写回失败
+        }
+    }
+
+    template <size_t D>
+    void PagedRTree<D>::flush()
+    {
+        writeHeader();
+        m_pool->flush();
+    }
+
+    template <size_t D>
+    void PagedRTree<D>::writeHeader()
+    {
+        m_header.pageCount = m_pool->getPageCount();
+        PageGuard guard(*m_pool, 0);
+        std::memcpy(guard.data(), &m_header, sizeof(m_header));
+        guard.markDirty();
+    }
+
+    template <size_t D>
+    typename PagedRTree<D>::PageView PagedRTree<D>::view(unsigned char *page) const
+    {
+        PageView result;
+        result.header = reinterpret_cast<PageHeader *>(page);
+        result.bounds = m_layout.bounds(page);
+        result.payload = m_layout.payload(page);
+        return result;
+    }
+
+    template <size_t D>
+    void PagedRTree<D>::retain(const PageGuard &guard) const
+    {
+        const PageHeader *header = reinterpret_cast<const PageHeader *>(guard.data());
+        size_t level = header->level;
+        if (level < m_pinFloor || m_pinned.count(guard.getPageId()))
+        {
+            return;
+        }
+
+        // 上层的页数总是少于下层：预算不够时从最低的常驻层开始整层放弃，直到新页能够常驻或其所在层也被放弃
+        size_t budget = m_pool->getFrameCount() / PinnedFraction;
+        while (m_pinned.size() >= budget && m_pinFloor <= level)
+        {
+            for (auto it = m_pinned.begin(); it != m_pinned.end();)
+            {
+                if (it->second == m_pinFloor)
+                {
+                    m_pool->unpin(it->first, false);
+                    it = m_pinned.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            m_pinFloor++;
+        }
+        if (level >= m_pinFloor)
+        {
+            m_pool->pin(guard.getPageId());
+            m_pinned[guard.getPageId()] = level;
+        }
+    }
+
+    template <size_t D>
+    unsigned char *PagedRTree<D>::allocatePage(uint64_t &pageId, size_t level)
+    {
+        unsigned char *data = m_pool->allocate(pageId);
+        PageHeader *header = reinterpret_cast<PageHeader *>(data);
+        header->level = static_cast<uint32_t>(level);
+        header->count = 0;
+        return data;
+    }
+
+    template <size_t D>
+    Region<D> PagedRTree<D>::entryRegion(const PageView &page, size_t index) const
+    {
+        size_t dimension = m_header.dimension;
+        size_t capacity = m_layout.getCapacity();
+        Region<D> region;
+        initCoords(region.m_low, dimension, 0.0);
+        initCoords(region.m_high, dimension, 0.0);
+        for (size_t d = 0; d < dimension; d++)
+        {
+            region.m_low[d] = page.bounds[d * capacity + index];
+            region.m_high[d] = page.bounds[(dimension + d) * capacity + index];
+        }
+        return region;
+    }
+
+    template <size_t D>
+    void PagedRTree<D>::setEntry(PageView &page, size_t index, const Region<D> &region, uint64_t payload) const
+    {
+        size_t dimension = m_header.dimension;
+        size_t capacity = m_layout.getCapacity();
+        for (size_t d = 0; d < dimension; d++)
+        {
+            page.bounds[d * capacity + index] = region.m_low[d];
+            page.bounds[(dimension + d) * capacity + index] = region.m_high[d];
+        }
+        page.payload[index] = payload;
+    }
+
+    template <size_t D>
+    Region<D> PagedRTree<D>::pageMBR(const PageView &page) const
+    {
+        // 空页得到空区域（下界为+inf、上界为-inf），不与任何查询相交
+        size_t dimension = m_header.dimension;
+        size_t capacity = m_layout.getCapacity();
+        Region<D> mbr;
+        initCoords(mbr.m_low, dimension, std::numeric_limits<double>::infinity());
+        initCoords(mbr.m_high, dimension, -std::numeric_limits<double>::infinity());
+        for (size_t d = 0; d < dimension; d++)
+        {
+            const double *low = page.bounds + d * capacity;
+            const double *high = page.bounds + (dimension + d) * capacity;
+            for (size_t i = 0; i < page.header->count; i++)
+            {
+                mbr.m_low[d] = std::min(mbr.m_low[d], low[i]);
+                mbr.m_high[d] = std::max(mbr.m_high[d], high[i]);
+            }
+        }
+        return mbr;
+    }
+
+    template <size_t D>
+    size_t PagedRTree<D>::chooseLeastEnlargement(const PageView &page, const Region<D> &region) const
+    {
+        // 与NodeBounds::chooseLeastEnlargement规则相同；被删空的子页面积按0计
+        size_t dimension = m_header.dimension;
+        size_t capacity = m_layout.getCapacity();
+        double minEnlargement = std::numeric_limits<double>::max();
+        double minArea = std::numeric_limits<double>::max();
+        size_t chosen = 0;
+        for (size_t i = 0; i < page.header->count; i++)
+        {
+            bool empty = dimension > 0 && page.bounds[i] > page.bounds[dimension * capacity + i];
+            double area = empty ? 0.0 : 1.0;
+            double combined = 1.0;
+            for (size_t d = 0; d < dimension; d++)
+            {
+                double lowValue = page.bounds[d * capacity + i];
+                double highValue = page.bounds[(dimension + d) * capacity + i];
+                if (!empty)
+                {
+                    area *= highValue - lowValue;
+                }
+                combined *= std::max(highValue, region.m_high[d]) - std::min(lowValue, region.m_low[d]);
+            }
+            double enlargement = combined - area;
+            if (enlargement < minEnlargement || (enlargement == minEnlargement && area < minArea))
+            {
+                minEnlargement = enlargement;
+                minArea = area;
+                chosen = i;
+            }
+        }
+        return chosen;
+    }
+
+    template <size_t D>
+    uint64_t PagedRTree<D>::splitPage(uint64_t pageId, const Entry<D> &newEntry)
+    {
+        PageGuard guard(*m_pool, pageId);
+        PageView page = view(guard.data());
+
+        // 页内条目转成Entry交给分裂策略，payload放在m_id中
+        std::vector<Entry<D>> entries;
+        entries.reserve(page.header->count + 1);
+        for (size_t i = 0; i < page.header->count; i++)
+        {
+            entries.emplace_back(entryRegion(page, i), static_cast<id_type>(page.payload[i]), nullptr, 0);
+        }
+        std::vector<size_t> group1, group2;
+        m_splitStrategy->split(entries, newEntry, group1, group2);
+        entries.push_back(newEntry);
+
+        uint64_t siblingId;
+        PageView sibling = view(allocatePage(siblingId, page.header->level));
+        for (size_t i = 0; i < group1.size(); i++)
+        {
+            setEntry(page, i, entries[group1[i]].m_region, entries[group1[i]].m_id);
+        }
+        page.header->count = static_cast<uint32_t>(group1.size());
+        for (size_t i = 0; i < group2.size(); i++)
+        {
+            setEntry(sibling, i, entries[group2[i]].m_region, entries[group2[i]].m_id);
+        }
+        sibling.header->count = static_cast<uint32_t>(group2.size());
+
+        m_pool->unpin(siblingId, true);
+        guard.markDirty();
+        return siblingId;
+    }
+
+    template <size_t D>
+    void PagedRTree<D>::insert(id_type id, const Region<D> &mbr)
+    {
+        if (mbr.getDimension() != m_header.dimension)
+        {
+            throw std::invalid_argument("Regions have different dimensions");
+        }
+
+        // 自根向下选择叶子，记录路径上的(页号, 所选子节点下标)
+        std::vector<std::pair<uint64_t, size_t>> path;
+        uint64_t pageId = m_header.rootPage;
+        while (true)
+        {
+            PageGuard guard(*m_pool, pageId);
+            retain(guard);
+            PageView page = view(guard.data());
+            if (page.header->level == 0)
+            {
+                break;
+            }
+            size_t index = chooseLeastEnlargement(page, mbr);
+            path.emplace_back(pageId, index);
+            pageId = page.payload[index];
+        }
+
+        // 叶子有空间时直接写入，否则与新条目一起分裂（页号0是文件头，用来表示没有分裂）
+        Entry<D> pending(mbr, id, nullptr, 0);
+        uint64_t splitId = 0;
+        {
+            PageGuard guard(*m_pool, pageId);
+            PageView page = view(guard.data());
+            if (page.header->count < m_layout.getCapacity())
+            {
+                setEntry(page, page.header->count, mbr, id);
+                page.header->count++;
+                guard.markDirty();
+            }
+            else
+            {
+                splitId = splitPage(pageId, pending);
+            }
+        }
+
+        auto mbrOf = [this](uint64_t page)
+        {
+            PageGuard guard(*m_pool, page);
+            return pageMBR(view(guard.data()));
+        };
+
+        // 向上调整：更新父页中子节点的区域，插入分裂出的新页（父页满时继续分裂）
+        uint64_t child = pageId;
+        while (!path.empty())
+        {
+            uint64_t parentId = path.back().first;
+            size_t index = path.back().second;
+            path.pop_back();
+
+            PageGuard guard(*m_pool, parentId);
+            PageView parent = view(guard.data());
+            setEntry(parent, index, mbrOf(child), child);
+            guard.markDirty();
+            if (splitId != 0)
+            {
+                Entry<D> splitEntry(mbrOf(splitId), static_cast<id_type>(splitId), nullptr, 0);
+                if (parent.header->count < m_layout.getCapacity())
+                {
+                    setEntry(parent, parent.header->count, splitEntry.m_region, splitId);
+                    parent.header->count++;
+                    splitId = 0;
+                }
+                else
+                {
+                    splitId = splitPage(parentId, splitEntry);
+                }
+            }
+            child = parentId;
+        }
+
+        if (splitId != 0)
+        {
+            // 根分裂：创建新根
+            uint64_t rootId;
+            PageView root = view(allocatePage(rootId, m_header.height));
+            setEntry(root, 0, mbrOf(child), child);
+            setEntry(root, 1, mbrOf(splitId), splitId);
+            root.header->count = 2;
+            m_pool->unpin(rootId, true);
+            m_header.rootPage = rootId;
+            m_header.height++;
+        }
+        m_header.size++;
+    }
+
+    template <size_t D>
+    bool PagedRTree<D>::findLeaf(uint64_t pageId, id_type id, const Region<D> &mbr,
+                                 std::vector<std::pair<uint64_t, size_t>> &path)
+    {
+        PageGuard guard(*m_pool, pageId);
+        retain(guard);
+        PageView page = view(guard.data());
+        size_t dimension = m_header.dimension;
+        size_t capacity = m_layout.getCapacity();
+
+        for (size_t i = 0; i < page.header->count; i++)
+        {
+            if (page.header->level == 0)
+            {
+                if (page.payload[i] == id)
+                {
+                    path.emplace_back(pageId, i);
+                    return true;
+                }
+                continue;
+            }
+
+            // 只进入包含mbr的子树
+            bool contains = true;
+            for (size_t d = 0; d < dimension && contains; d++)
+            {
+                contains = page.bounds[d * capacity + i] <= mbr.m_low[d] &&
+                           page.bounds[(dimension + d) * capacity + i] >= mbr.m_high[d];
+            }
+            if (!contains)
+            {
+                continue;
+            }
+            path.emplace_back(pageId, i);
+            if (findLeaf(page.payload[i], id, mbr, path))
+            {
+                return true;
+            }
+            path.pop_back();
+        }
+        return false;
+    }
+
+    template <size_t D>
+    bool PagedRTree<D>::remove(id_type id, const Region<D> &mbr)
+    {
+        std::vector<std::pair<uint64_t, size_t>> path;
+        if (mbr.getDimension() != m_header.dimension || !findLeaf(m_header.rootPage, id, mbr, path))
+        {
+            return false;
+        }
+
+        // 用最后一个条目填补被删除的位置
+        uint64_t child = path.back().first;
+        {
+            PageGuard guard(*m_pool, child);
+            PageView leaf = view(guard.data());
+            size_t last = leaf.header->count - 1;
+            setEntry(leaf, path.back().second, entryRegion(leaf, last), leaf.payload[last]);
+            leaf.header->count--;
+            guard.markDirty();
+        }
+        path.pop_back();
+
+        // 向上收缩祖先中的区域
+        while (!path.empty())
+        {
+            PageGuard guard(*m_pool, path.back().first);
+            PageView parent = view(guard.data());
+            Region<D> childMBR;
+            {
+                PageGuard childGuard(*m_pool, child);
+                childMBR = pageMBR(view(childGuard.data()));
+            }
+            setEntry(parent, path.back().second, childMBR, child);
+            guard.markDirty();
+            child = path.back().first;
+            path.pop_back();
+        }
+        m_header.size--;
+        return true;
+    }
+
+    template <size_t D>
+    std::vector<id_type> PagedRTree<D>::search(const Region<D> &query) const
+    {
+        std::vector<id_type> results;
+        visit(query, [&](id_type id)
+              {
+                  results.push_back(id);
+                  return true; });
+        return results;
+    }
+
+    template <size_t D>
+    size_t PagedRTree<D>::count(const Region<D> &query) const
+    {
+        return visit(query, [](id_type)
+                     { return true; });
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class PagedRTree<DynamicDimension>;
+    template class PagedRTree<2>;
+    template class PagedRTree<3>;
+
+} // namespace RTree
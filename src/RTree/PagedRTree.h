@@ -0,0 +1,154 @@
+#ifndef RTREE_PAGED_RTREE_H
+#define RTREE_PAGED_RTREE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include "Region.h"
+#include "Entry.h"
+#include "SplitStrategy.h"
+#include "SimdKernel.h"
+#include "PageFormat.h"
+#include "BufferPool.h"
+
+namespace RTree
+{
+
+    // 外存R-tree - 节点以PageFormat.h的定长页存放在文件中，通过有限大小的缓冲池按需读入，
+    // 因此树可以远大于内存。与RTree一样支持insert/search/remove，但叶子中保存的是数据条目的ID。
+    // 上层的内部节点页第一次读入后一直固定在缓冲池中，常驻页总数不超过帧数的PinnedFraction分之一：
+    // 超出时放弃固定最低的常驻层，该层的页与更低的层一样可以被淘汰。上层能整体常驻时，
+    // 查询只有触及的叶子页可能需要I/O。文件格式与RTree::save()相同，可以直接打开已保存的树继续修改。
+    // 节点最大条目数取页容量。缓冲池的帧数至少要能容纳常驻页加上一次分裂所需的页，否则抛出std::runtime_error；
+    // 查询也会修改常驻页集合，因此不支持多线程同时访问。
+    template <size_t D = DynamicDimension>
+    class PagedRTree
+    {
+    public:
+        // 打开已有的页文件
+        PagedRTree(const std::string &path, size_t bufferFrames,
+                   std::shared_ptr<SplitStrategy<D>> strategy = std::make_shared<QuadraticSplitStrategy<D>>());
+        // 创建新的空树（覆盖已有文件）
+        PagedRTree(const std::string &path, size_t bufferFrames, size_t maxEntries, size_t dimension,
+                   std::shared_ptr<SplitStrategy<D>> strategy = std::make_shared<QuadraticSplitStrategy<D>>());
+        // 写回所有脏页和文件头
+        ~PagedRTree();
+
+        PagedRTree(const PagedRTree &) = delete;
+        PagedRTree &operator=(const PagedRTree &) = delete;
+
+        void insert(id_type id, const Region<D> &mbr);
+        bool remove(id_type id, const Region<D> &mbr);
+
+        // visitor(id)返回false时停止，返回已访问的条目数
+        template <class Visitor>
+        size_t visit(const Region<D> &query, Visitor visitor) const
+        {
+            size_t visited = 0;
+            if (m_header.size == 0 || query.getDimension() != m_header.dimension)
+            {
+                return visited;
+            }
+
+            std::vector<uint64_t> stack;
+            HitMask mask;
+            stack.push_back(m_header.rootPage);
+            while (!stack.empty())
+            {
+                PageGuard guard(*m_pool, stack.back());
+                stack.pop_back();
+                retain(guard);
+                const PageHeader *header = reinterpret_cast<const PageHeader *>(guard.data());
+                uint64_t *words = mask.reset(header->count);
+                if (header->count == 0)
+                {
+                    continue;
+                }
+                intersectBatch(m_layout.bounds(guard.data()), m_layout.getCapacity(), header->count,
+                               m_header.dimension, query.m_low.data(), query.m_high.data(), words);
+
+                const uint64_t *payload = m_layout.payload(guard.data());
+                if (header->level > 0)
+                {
+                    mask.forEach([&](size_t i)
+                                 { stack.push_back(payload[i]); });
+                    continue;
+                }
+                bool more = mask.forEachWhile([&](size_t i)
+                                              {
+                                                  visited++;
+                                                  return visitor(static_cast<id_type>(payload[i])); });
+                if (!more)
+                {
+                    break;
+                }
+            }
+            return visited;
+        }
+
+        std::vector<id_type> search(const Region<D> &query) const;
+        size_t count(const Region<D> &query) const;
+
+        // 把脏页和文件头写回文件
+        void flush();
+
+        // 常驻页最多占用帧数的1/PinnedFraction
+        static const size_t PinnedFraction = 4;
+
+        // level不小于minLevel的节点页读入后固定（默认1：所有内部节点），但常驻页超出预算时
+        // 实际固定的最低层会自动升高。只影响之后读入的页
+        void setPinnedLevel(size_t minLevel)
+        {
+            m_pinnedLevel = minLevel;
+            m_pinFloor = minLevel;
+        }
+        size_t getPinnedLevel() const { return m_pinnedLevel; }
+        // 当前实际固定的最低层（不小于getPinnedLevel()）
+        size_t getPinFloor() const { return m_pinFloor; }
+
+        size_t getSize() const { return m_header.size; }
+        size_t getHeight() const { return m_header.height; }
+        size_t getMaxEntries() const { return m_layout.getCapacity(); }
+        BufferPool &getBufferPool() const { return *m_pool; }
+
+    private:
+        // 页内条目的视图
+        struct PageView
+        {
+            PageHeader *header;
+            double *bounds;
+            uint64_t *payload;
+        };
+
+        FileHeader m_header;
+        PageLayout m_layout;
+        std::unique_ptr<BufferPool> m_pool;
+        std::shared_ptr<SplitStrategy<D>> m_splitStrategy;
+        size_t m_pinnedLevel;                                // 用户要求固定的最低层
+        mutable size_t m_pinFloor;                           // 实际固定的最低层，常驻页超出预算时升高
+        mutable std::unordered_map<uint64_t, size_t> m_pinned; // 常驻缓冲池的页 -> 所在层
+
+        PageView view(unsigned char *page) const;
+        // 层级不低于m_pinFloor的页第一次访问时额外保留一次pin，使其常驻缓冲池；
+        // 常驻页达到预算时先放弃固定最低的常驻层
+        void retain(const PageGuard &guard) const;
+        // 分配新页并写入页头，返回时已被固定
+        unsigned char *allocatePage(uint64_t &pageId, size_t level);
+
+        Region<D> entryRegion(const PageView &page, size_t index) const;
+        void setEntry(PageView &page, size_t index, const Region<D> &region, uint64_t payload) const;
+        Region<D> pageMBR(const PageView &page) const;
+        size_t chooseLeastEnlargement(const PageView &page, const Region<D> &region) const;
+
+        // 把newEntry（m_id为payload）与满页一起分裂，返回新页号
+        uint64_t splitPage(uint64_t pageId, const Entry<D> &newEntry);
+
+        bool findLeaf(uint64_t pageId, id_type id, const Region<D> &mbr,
+                      std::vector<std::pair<uint64_t, size_t>> &path);
+        void writeHeader();
+    };
+
+} // namespace RTree
+
+#endif // RTREE_PAGED_RTREE_H
@@ -4,7 +4,8 @@
 namespace RTree
 {
 
-    double Point::distance(const Point &p) const
+    template <size_t D>
+    double Point<D>::distance(const Point &p) const
     {
         if (m_coords.size() != p.m_coords.size())
         {
@@ -20,4 +21,9 @@ namespace RTree
         return std::sqrt(sum);
     }
 
-} // namespace RTree
\ No newline at end of file
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class Point<DynamicDimension>;
+    template class Point<2>;
+    template class Point<3>;
+
+} // namespace RTree
@@ -2,23 +2,75 @@
 #define RTREE_POINT_H
 
 #include <vector>
+#include <array>
 #include <cmath>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
 
 namespace RTree
 {
 
+    // 动态维度标记 - 坐标使用std::vector存储，维度在运行时确定
+    const size_t DynamicDimension = 0;
+
+    // 坐标存储类型 - 固定维度使用std::array（无堆分配，循环可展开），动态维度使用std::vector
+    template <size_t D>
+    struct CoordinateArray
+    {
+        typedef std::array<double, D> type;
+    };
+
+    template <>
+    struct CoordinateArray<DynamicDimension>
+    {
+        typedef std::vector<double> type;
+    };
+
+    // 坐标初始化：动态维度按dim分配，固定维度忽略dim
+    inline void initCoords(std::vector<double> &coords, size_t dim, double value)
+    {
+        coords.assign(dim, value);
+    }
+
+    template <size_t N>
+    inline void initCoords(std::array<double, N> &coords, size_t, double value)
+    {
+        coords.fill(value);
+    }
+
+    // 坐标赋值：固定维度要求坐标个数与维度一致
+    template <class Iter>
+    inline void assignCoords(std::vector<double> &coords, Iter first, Iter last)
+    {
+        coords.assign(first, last);
+    }
+
+    template <size_t N, class Iter>
+    inline void assignCoords(std::array<double, N> &coords, Iter first, Iter last)
+    {
+        if (static_cast<size_t>(std::distance(first, last)) != N)
+        {
+            throw std::invalid_argument("Coordinate count does not match dimension");
+        }
+        std::copy(first, last, coords.begin());
+    }
+
     // 点类 - 表示空间中的一个点
+    template <size_t D = DynamicDimension>
     class Point
     {
     public:
-        std::vector<double> m_coords; // 坐标值
+        typedef typename CoordinateArray<D>::type Coords;
+
+        Coords m_coords; // 坐标值
 
-        Point() {}
-        Point(const std::vector<double> &coords) : m_coords(coords) {}
+        Point() { initCoords(m_coords, 0, 0.0); }
+        Point(const std::vector<double> &coords) { assignCoords(m_coords, coords.begin(), coords.end()); }
         Point(double x, double y)
         {
-            m_coords.push_back(x);
-            m_coords.push_back(y);
+            const double coords[2] = {x, y};
+            assignCoords(m_coords, coords, coords + 2);
         }
 
         size_t getDimension() const { return m_coords.size(); }
@@ -27,4 +79,4 @@ namespace RTree
 
 } // namespace RTree
 
-#endif // RTREE_POINT_H
\ No newline at end of file
+#endif // RTREE_POINT_H
@@ -0,0 +1,248 @@
+#include "QueryExecutor.h"
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cmath>
+
+namespace RTree
+{
+
+    template <size_t D>
+    struct QueryExecutor<D>::QueryState
+    {
+        std::mutex mutex;                  // 保护结果的合并
+        std::atomic<size_t> pendingParts;  // 尚未完成的任务数
+        std::atomic<size_t> totalParts;    // 拆分出的任务总数
+        std::chrono::steady_clock::time_point started;
+
+        QueryState() : pendingParts(1), totalParts(1) {}
+    };
+
+    template <size_t D>
+    struct QueryExecutor<D>::BatchState
+    {
+        const std::vector<QueryRequest<D>> &requests;
+        std::vector<QueryResult> &results;
+        std::unique_ptr<QueryState[]> states;
+        std::chrono::steady_clock::time_point submitted;
+        double fanout; // 估计的平均扇出，用于估计子树大小
+
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t remaining; // 未完成的查询数（mutex保护）
+
+        BatchState(const std::vector<QueryRequest<D>> &r, std::vector<QueryResult> &res)
+            : requests(r), results(res), states(new QueryState[r.size()]), fanout(1.0), remaining(r.size()) {}
+    };
+
+    template <size_t D>
+    std::vector<QueryResult> QueryExecutor<D>::execute(const std::vector<QueryRequest<D>> &requests)
+    {
+        std::vector<QueryResult> results(requests.size());
+        if (requests.empty())
+        {
+            return results;
+        }
+
+        BatchState batch(requests, results);
+        // 高度为h、共n条数据的树平均扇出约为n^(1/h)，第l层节点下约有fanout^(l+1)条数据
+        batch.fanout = std::pow(static_cast<double>(std::max<size_t>(m_tree.getSize(), 1)),
+                                1.0 / static_cast<double>(m_tree.getHeight()));
+        batch.submitted = std::chrono::steady_clock::now();
+
+        std::exception_ptr submitError;
+        for (size_t i = 0; i < requests.size(); i++)
+        {
+            try
+            {
+                if (requests[i].type == QueryType::Range)
+                {
+                    m_pool.submit([this, &batch, i]()
+                                  { runRange(batch, i, nullptr); });
+                }
+                else
+                {
+                    m_pool.submit([this, &batch, i]()
+                                  { runNearest(batch, i); });
+                }
+            }
+            catch (...)
+            {
+                // 未提交的查询不会再完成，从计数中扣除后等待已提交的任务（它们引用了batch）
+                submitError = std::current_exception();
+                std::lock_guard<std::mutex> lock(batch.mutex);
+                batch.remaining -= requests.size() - i;
+                break;
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(batch.mutex);
+            batch.done.wait(lock, [&batch]()
+                            { return batch.remaining == 0; });
+        }
+        if (submitError)
+        {
+            std::rethrow_exception(submitError);
+        }
+        return results;
+    }
+
+    template <size_t D>
+    void QueryExecutor<D>::runRange(BatchState &batch, size_t index, const Node<D> *start)
+    {
+        QueryState &state = batch.states[index];
+        if (!start)
+        {
+            // 查询的第一个任务：从根开始
+            state.started = std::chrono::steady_clock::now();
+            start = m_tree.getRoot();
+        }
+
+        // 异常只终止本任务：记录后照常完成，保证计数归零、execute()能够返回
+        std::vector<void *> partial;
+        try
+        {
+            scanRange(batch, index, start, partial);
+        }
+        catch (...)
+        {
+            recordError(batch, index);
+        }
+
+        finishPart(batch, index, partial);
+    }
+
+    template <size_t D>
+    void QueryExecutor<D>::scanRange(BatchState &batch, size_t index, const Node<D> *start, std::vector<void *> &partial)
+    {
+        QueryState &state = batch.states[index];
+        const Region<D> &query = batch.requests[index].region;
+        std::vector<const Node<D> *> stack;
+        stack.push_back(start);
+        HitMask mask;
+
+        while (!stack.empty())
+        {
+            const Node<D> *node = stack.back();
+            stack.pop_back();
+            node->intersectMask(query, mask);
+            if (node->isLeaf())
+            {
+                mask.forEach([&](size_t i)
+                             { partial.push_back(node->getPayload(i)); });
+                continue;
+            }
+
+            // 子树估计足够大时，除第一个命中的子节点外都拆成独立任务供其他线程窃取
+            double childSize = std::pow(batch.fanout, static_cast<double>(node->getLevel()));
+            bool split = m_splitThreshold > 0 && m_pool.size() > 1 && childSize >= static_cast<double>(m_splitThreshold);
+            bool keepFirst = true;
+            mask.forEach([&](size_t i)
+                         {
+                             const Node<D> *child = static_cast<const Node<D> *>(node->getPayload(i));
+                             if (!split || keepFirst)
+                             {
+                                 stack.push_back(child);
+                                 keepFirst = false;
+                                 return;
+                             }
+                             state.pendingParts++;
+                             state.totalParts++;
+                             try
+                             {
+                                 m_pool.submit([this, &batch, index, child]()
+                                               { runRange(batch, index, child); });
+                             }
+                             catch (...)
+                             {
+                                 state.pendingParts--;
+                                 state.totalParts--;
+                                 throw;
+                             } });
+        }
+    }
+
+    template <size_t D>
+    void QueryExecutor<D>::runNearest(BatchState &batch, size_t index)
+    {
+        QueryState &state = batch.states[index];
+        state.started = std::chrono::steady_clock::now();
+        const QueryRequest<D> &request = batch.requests[index];
+        try
+        {
+            batch.results[index].neighbors = m_tree.nearest(request.point, request.k);
+        }
+        catch (...)
+        {
+            recordError(batch, index);
+        }
+        finishQuery(batch, index);
+    }
+
+    template <size_t D>
+    void QueryExecutor<D>::recordError(BatchState &batch, size_t index)
+    {
+        // 拆分执行的多个任务可能同时失败，只保留第一个异常
+        std::lock_guard<std::mutex> lock(batch.states[index].mutex);
+        if (!batch.results[index].error)
+        {
+            batch.results[index].error = std::current_exception();
+        }
+    }
+
+    template <size_t D>
+    void QueryExecutor<D>::finishPart(BatchState &batch, size_t index, std::vector<void *> &partial)
+    {
+        QueryState &state = batch.states[index];
+        if (!partial.empty())
+        {
+            try
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                std::vector<void *> &data = batch.results[index].data;
+                if (data.empty())
+                {
+                    data.swap(partial);
+                }
+                else
+                {
+                    data.insert(data.end(), partial.begin(), partial.end());
+                }
+            }
+            catch (...)
+            {
+                recordError(batch, index);
+            }
+        }
+
+        if (--state.pendingParts == 0)
+        {
+            finishQuery(batch, index);
+        }
+    }
+
+    template <size_t D>
+    void QueryExecutor<D>::finishQuery(BatchState &batch, size_t index)
+    {
+        QueryState &state = batch.states[index];
+        QueryResult &result = batch.results[index];
+        auto now = std::chrono::steady_clock::now();
+        result.latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - batch.submitted);
+        result.serviceTime = std::chrono::duration_cast<std::chrono::nanoseconds>(now - state.started);
+        result.parts = state.totalParts;
+
+        // 在锁内递减并通知：等待方只有在本线程释放锁之后才能看到remaining为0并销毁batch
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        if (--batch.remaining == 0)
+        {
+            batch.done.notify_all();
+        }
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class QueryExecutor<DynamicDimension>;
+    template class QueryExecutor<2>;
+    template class QueryExecutor<3>;
+
+} // namespace RTree
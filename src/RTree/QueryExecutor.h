@@ -0,0 +1,99 @@
+#ifndef RTREE_QUERY_EXECUTOR_H
+#define RTREE_QUERY_EXECUTOR_H
+
+#include <vector>
+#include <chrono>
+#include <exception>
+#include "RTree.h"
+#include "WorkStealingPool.h"
+
+namespace RTree
+{
+
+    // 查询类型
+    enum class QueryType
+    {
+        Range,  // 范围查询，结果为与区域相交的数据
+        Nearest // K近邻查询，结果按距离升序
+    };
+
+    // 单个查询请求
+    template <size_t D = DynamicDimension>
+    struct QueryRequest
+    {
+        QueryType type;
+        Region<D> region; // Range使用
+        Point<D> point;   // Nearest使用
+        size_t k;         // Nearest使用
+
+        static QueryRequest range(const Region<D> &region)
+        {
+            QueryRequest request;
+            request.type = QueryType::Range;
+            request.region = region;
+            request.k = 0;
+            return request;
+        }
+
+        static QueryRequest nearest(const Point<D> &point, size_t k)
+        {
+            QueryRequest request;
+            request.type = QueryType::Nearest;
+            request.point = point;
+            request.k = k;
+            return request;
+        }
+    };
+
+    // 单个查询的结果和耗时
+    struct QueryResult
+    {
+        std::vector<void *> data;              // Range结果（拆分执行时顺序不确定）
+        std::vector<DistanceEntry> neighbors;  // Nearest结果
+        std::chrono::nanoseconds latency;      // 从批次提交到查询完成
+        std::chrono::nanoseconds serviceTime;  // 从开始执行到完成（不含排队）
+        size_t parts;                          // 执行时拆成的任务数
+        std::exception_ptr error;              // 执行中抛出的第一个异常；非空时结果可能不完整
+
+        QueryResult() : latency(0), serviceTime(0), parts(0) {}
+    };
+
+    // 并发只读查询执行器 - 在工作窃取线程池上对同一棵树并发执行大量查询。
+    // 执行期间树不能被修改（插入、删除、批量装载等）。
+    // 估计结果很大的范围查询会把子树拆成独立任务，由空闲线程窃取并行执行。
+    template <size_t D = DynamicDimension>
+    class QueryExecutor
+    {
+    public:
+        QueryExecutor(const RTree<D> &tree, WorkStealingPool &pool)
+            : m_tree(tree), m_pool(pool), m_splitThreshold(DefaultSplitThreshold) {}
+
+        // 执行一批查询并等待全部完成，结果与requests一一对应。
+        // 单个查询抛出的异常记录在对应结果的error中，不影响其他查询；提交任务失败时等已提交的任务结束后重新抛出
+        std::vector<QueryResult> execute(const std::vector<QueryRequest<D>> &requests);
+
+        // 子树估计条目数不少于threshold时拆成单独任务；0表示不拆分
+        void setSplitThreshold(size_t threshold) { m_splitThreshold = threshold; }
+        size_t getSplitThreshold() const { return m_splitThreshold; }
+
+    private:
+        static const size_t DefaultSplitThreshold = 4096;
+
+        struct QueryState;
+        struct BatchState;
+
+        const RTree<D> &m_tree;
+        WorkStealingPool &m_pool;
+        size_t m_splitThreshold;
+
+        void runRange(BatchState &batch, size_t index, const Node<D> *start);
+        void scanRange(BatchState &batch, size_t index, const Node<D> *start, std::vector<void *> &partial);
+        void runNearest(BatchState &batch, size_t index);
+        void finishPart(BatchState &batch, size_t index, std::vector<void *> &partial);
+        void finishQuery(BatchState &batch, size_t index);
+        void recordError(BatchState &batch, size_t index);
+    };
+
+} // namespace RTree
+
+#endif // RTREE_QUERY_EXECUTOR_H
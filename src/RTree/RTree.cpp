@@ -1,219 +1,2375 @@
 #include "RTree.h"
+#include "PageFormat.h"
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
 
 namespace RTree
 {
 
-    void RTree::insert(void *data, size_t dataSize, const Region &mbr)
+    template <size_t D>
+    id_type RTree<D>::insert(void *data, size_t dataSize, const Region<D> &mbr)
     {
+        // 生成唯一ID
+        id_type id = generateID();
+        insert(id, data, dataSize, mbr);
+        return id;
+    }
+
+    template <size_t D>
+    void RTree<D>::insert(id_type id, void *data, size_t dataSize, const Region<D> &mbr)
+    {
+        // 之后生成的ID必须大于所有已用ID
+        id_type next = m_nextID.load();
+        while (next <= id && !m_nextID.compare_exchange_weak(next, id + 1))
+        {
+        }
+
         // 递增数据项数量
         m_size++;
 
-        // 生成唯一ID
-        id_type id = generateID();
-        if (id == 20)
+        if (m_concurrencyMode == ConcurrencyMode::RLink)
+        {
+            insertRLink(Entry<D>(mbr, id, data, dataSize));
+            return;
+        }
+        if (m_concurrencyMode == ConcurrencyMode::Optimistic)
+        {
+            insertOptimistic(Entry<D>(mbr, id, data, dataSize));
+            return;
+        }
+
+        if (m_insertMode == InsertMode::Hilbert)
+        {
+            ensureHilbertCurve(mbr);
+            Entry<D> entry(mbr, id, data, dataSize);
+            entry.m_hilbertValue = m_hilbertCurve.value(mbr);
+            insertHilbert(entry);
+            return;
+        }
+
+        if (m_insertMode == InsertMode::RStar)
+        {
+            std::vector<bool> reinserted(m_treeHeight, false);
+            insertRStar(Entry<D>(mbr, id, data, dataSize), 0, reinserted);
+            return;
+        }
+
+        // 第一步：定位叶子节点（被快照共享时先复制路径）
+        Node<D> *leafNode = unsharePath(m_root->chooseSubtree(mbr));
+        LeafNode<D> *leaf = static_cast<LeafNode<D> *>(leafNode);
+
+        // 第二步：叶子节点未满时直接插入
+        if (leaf->getEntryCount() < m_maxEntries)
+        {
+            leaf->insertData(data, dataSize, mbr, id);
+
+            // 没有分裂，只需调整树
+            adjustTree(leaf);
+            return;
+        }
+
+        // 第三步：叶子节点已满，带着新条目一起分裂
+        Entry<D> newEntry(mbr, id, data, dataSize);
+        Node<D> *newNode = nullptr;
+        leaf->split(newEntry, newNode, m_maxEntries);
+
+        // 调整树
+        adjustTree(leaf, newNode);
+    }
+
+    template <size_t D>
+    Node<D> *RTree<D>::chooseNodeRStar(const Region<D> &mbr, size_t level) const
+    {
+        // 叶子的父层按重叠扩展选择（决定数据落在哪个叶子），更高层按面积扩展选择
+        Node<D> *node = m_root;
+        while (node->getLevel() > level)
+        {
+            const InternalNode<D> *internal = static_cast<const InternalNode<D> *>(node);
+            node = node->getLevel() == 1 ? internal->chooseChildLeastOverlap(mbr) : internal->chooseChild(mbr);
+        }
+        return node;
+    }
+
+    template <size_t D>
+    void RTree<D>::insertRStar(const Entry<D> &entry, size_t level, std::vector<bool> &reinserted)
+    {
+        Node<D> *node = unsharePath(chooseNodeRStar(entry.m_region, level));
+        if (node->getEntryCount() >= m_maxEntries)
+        {
+            overflowRStar(node, entry, reinserted);
+            return;
+        }
+
+        if (node->isLeaf())
+        {
+            node->insertEntry(entry);
+        }
+        else
+        {
+            static_cast<InternalNode<D> *>(node)->addChild(entry.m_childNode, entry.m_region, entry.m_id);
+        }
+        adjustTree(node);
+    }
+
+    template <size_t D>
+    void RTree<D>::overflowRStar(Node<D> *node, const Entry<D> &entry, std::vector<bool> &reinserted)
+    {
+        size_t level = node->getLevel();
+        if (level >= reinserted.size())
+        {
+            reinserted.resize(level + 1, false);
+        }
+        if (node != m_root && !reinserted[level])
+        {
+            reinserted[level] = true;
+            reinsertRStar(node, entry, reinserted);
+            return;
+        }
+
+        Node<D> *newNode = nullptr;
+        node->split(entry, newNode, m_maxEntries);
+        if (node == m_root)
+        {
+            adjustTree(node, newNode);
+            return;
+        }
+
+        // 父节点放得下新节点时与普通插入相同；放不下时父节点同样先尝试重插
+        Node<D> *parent = node->getParent();
+        parent->setEntryRegion(parent->findChild(node), node->getMBR());
+        if (parent->getEntryCount() < m_maxEntries)
+        {
+            static_cast<InternalNode<D> *>(parent)->addChild(newNode, newNode->getMBR(), generateID());
+            adjustTree(parent);
+            return;
+        }
+        overflowRStar(parent, Entry<D>(newNode->getMBR(), generateID(), newNode), reinserted);
+    }
+
+    template <size_t D>
+    void RTree<D>::reinsertRStar(Node<D> *node, const Entry<D> &entry, std::vector<bool> &reinserted)
+    {
+        std::vector<Entry<D>> entries;
+        entries.reserve(node->getEntryCount() + 1);
+        Region<D> bounds = entry.m_region;
+        for (size_t i = 0; i < node->getEntryCount(); i++)
+        {
+            entries.push_back(node->copyEntry(i));
+            bounds.combineRegion(entries.back().m_region);
+        }
+        entries.push_back(entry);
+
+        // 按条目中心到节点中心的距离从远到近排序
+        Point<D> center = bounds.getCenter();
+        std::vector<std::pair<double, size_t>> order;
+        order.reserve(entries.size());
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            Point<D> entryCenter = entries[i].m_region.getCenter();
+            double distance = 0.0;
+            for (size_t d = 0; d < center.getDimension(); d++)
+            {
+                double delta = entryCenter.m_coords[d] - center.m_coords[d];
+                distance += delta * delta;
+            }
+            order.push_back(std::make_pair(distance, i));
+        }
+        std::sort(order.begin(), order.end(), [](const std::pair<double, size_t> &a, const std::pair<double, size_t> &b)
+                  { return a.first > b.first; });
+
+        size_t count = std::max<size_t>(1, entries.size() * 3 / 10);
+        std::vector<Entry<D>> removed, kept;
+        removed.reserve(count);
+        kept.reserve(entries.size() - count);
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            (i < count ? removed : kept).push_back(entries[order[i].second]);
+        }
+
+        // 剩下的条目留在原节点，先把缩小后的MBR向上传播，再从近到远重插（close reinsert）
+        node->setEntries(kept.data(), kept.size());
+        if (node->isLeaf())
+        {
+            indexLeaf(node); // 新条目可能留在原节点
+        }
+        adjustTree(node);
+        size_t level = node->getLevel();
+        for (size_t i = removed.size(); i-- > 0;)
+        {
+            insertRStar(removed[i], level, reinserted);
+        }
+    }
+
+    template <size_t D>
+    void RTree<D>::insertRLink(const Entry<D> &entry)
+    {
+        // 第一步：自顶向下选择叶子，每层只在读取子节点指针时持有共享锁。
+        // 选中的子节点之后可能被分裂，但插入任何一个仍在树中的节点都是正确的
+        std::vector<Node<D> *> path;
+        Node<D> *node = nullptr;
+        {
+            std::shared_lock<std::shared_timed_mutex> rootLock(m_rootLatch);
+            node = m_root;
+        }
+        while (!node->isLeaf())
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(node->getLatch());
+            path.push_back(node);
+            node = static_cast<InternalNode<D> *>(node)->chooseChild(entry.m_region);
+        }
+
+        // 第二步：锁住叶子插入；已满则在持有父节点写锁的情况下分裂，
+        // 保证读者要么在分裂前读到父节点（之后沿右链补上），要么读到已插入新兄弟的父节点
+        std::unique_lock<std::shared_timed_mutex> nodeLock(node->getLatch());
+        Entry<D> pending = entry;
+        while (node->getEntryCount() >= m_maxEntries)
+        {
+            std::unique_lock<std::shared_timed_mutex> rootLock(m_rootLatch, std::defer_lock);
+            Node<D> *parent = lockParent(node, path, rootLock);
+
+            Node<D> *sibling = nullptr;
+            node->split(pending, sibling, m_maxEntries);
+            node->linkRight(sibling, ++m_globalNSN);
+
+            if (!parent)
+            {
+                // 根节点分裂：持有rootLock创建新根
+                InternalNode<D> *newRoot = createInternalNode(node->getLevel() + 1);
+                newRoot->addChild(node, node->getMBR(), generateID());
+                newRoot->addChild(sibling, sibling->getMBR(), generateID());
+                m_root = newRoot;
+                m_treeHeight = newRoot->getLevel() + 1;
+                return;
+            }
+
+            // 分裂后本节点的MBR缩小，新兄弟作为待插入条目交给父节点
+            parent->setEntryRegion(parent->findChild(node), node->getMBR());
+            sibling->setParent(parent);
+            pending = Entry<D>(sibling->getMBR(), generateID(), sibling);
+
+            nodeLock = std::unique_lock<std::shared_timed_mutex>(parent->getLatch(), std::adopt_lock);
+            node = parent;
+        }
+        node->insertEntry(pending);
+        if (!node->isLeaf())
+        {
+            pending.m_childNode->setParent(node);
+        }
+
+        // 第三步：向上扩展MBR，父节点中的条目已包含子节点MBR时停止
+        while (true)
+        {
+            std::unique_lock<std::shared_timed_mutex> rootLock(m_rootLatch, std::defer_lock);
+            Node<D> *parent = lockParent(node, path, rootLock);
+            if (!parent)
+            {
+                return;
+            }
+
+            int index = parent->findChild(node);
+            bool covered = parent->getEntry(index).m_region.containsRegion(node->getMBR());
+            if (!covered)
+            {
+                parent->setEntryRegion(index, node->getMBR());
+                parent->updateMBR();
+            }
+
+            nodeLock = std::unique_lock<std::shared_timed_mutex>(parent->getLatch(), std::adopt_lock);
+            node = parent;
+            if (covered)
+            {
+                return;
+            }
+        }
+    }
+
+    template <size_t D>
+    Node<D> *RTree<D>::lockParent(Node<D> *node, std::vector<Node<D> *> &path,
+                                  std::unique_lock<std::shared_timed_mutex> &rootLock)
+    {
+        Node<D> *candidate = nullptr;
+        if (!path.empty())
+        {
+            candidate = path.back();
+            path.pop_back();
+        }
+        else
+        {
+            rootLock.lock();
+            if (m_root == node)
+            {
+                return nullptr;
+            }
+
+            // 下降之后根节点已经分裂过：从新根沿最左路径找到父节点所在层的第一个节点。
+            // 先释放rootLock再加节点锁，避免与持有节点锁等待rootLock的写者死锁
+            candidate = m_root;
+            rootLock.unlock();
+            while (candidate->getLevel() > node->getLevel() + 1)
+            {
+                std::shared_lock<std::shared_timed_mutex> lock(candidate->getLatch());
+                candidate = candidate->getChild(0);
+            }
+        }
+
+        // 父节点分裂时子节点只会移到右兄弟中，沿右链查找
+        while (candidate)
+        {
+            candidate->getLatch().lock();
+            if (candidate->findChild(node) >= 0)
+            {
+                return candidate;
+            }
+            Node<D> *next = candidate->getRightLink();
+            candidate->getLatch().unlock();
+            candidate = next;
+        }
+        throw std::logic_error("R-link parent not found");
+    }
+
+    template <size_t D>
+    void RTree<D>::setConcurrencyMode(ConcurrencyMode mode)
+    {
+        if (mode != ConcurrencyMode::None && m_insertMode != InsertMode::Guttman)
+        {
+            throw std::invalid_argument("concurrent modes require Guttman insert mode");
+        }
+        if (mode != ConcurrencyMode::None && hasSnapshots())
+        {
+            throw std::logic_error("concurrent modes cannot be enabled while snapshots exist");
+        }
+        if (mode != ConcurrencyMode::None && m_idIndexEnabled)
+        {
+            throw std::logic_error("concurrent modes cannot be used with the id index");
+        }
+        if (mode == ConcurrencyMode::RLink && isQuantizedLayout(m_nodeLayout))
+        {
+            throw std::invalid_argument("R-link concurrency does not support quantized node layouts");
+        }
+        if (mode == ConcurrencyMode::Optimistic && m_nodeLayout != NodeLayout::StructOfArrays)
+        {
+            setNodeLayout(NodeLayout::StructOfArrays);
+        }
+        m_concurrencyMode = mode;
+
+        // 并发模式下每个节点都有同步状态，回到单线程模式时释放
+        // （条目数组和SoA边界的容量创建时就按maxEntries + 1固定，乐观模式的读者不会读到被重新分配的数组）
+        std::vector<Node<D> *> stack;
+        stack.push_back(m_root);
+        while (!stack.empty())
+        {
+            Node<D> *node = stack.back();
+            stack.pop_back();
+            if (mode == ConcurrencyMode::None)
+            {
+                node->disableSync();
+            }
+            else
+            {
+                node->enableSync();
+            }
+            if (!node->isLeaf())
+            {
+                for (size_t i = 0; i < node->getEntryCount(); i++)
+                {
+                    stack.push_back(node->getChild(i));
+                }
+            }
+        }
+    }
+
+    template <size_t D>
+    void RTree<D>::insertOptimistic(const Entry<D> &entry)
+    {
+        EpochGuard epoch;
+        while (!tryInsertOptimistic(entry))
+        {
+        }
+    }
+
+    template <size_t D>
+    bool RTree<D>::tryInsertOptimistic(const Entry<D> &entry)
+    {
+        uint64_t rootVersion = m_rootVersion.beginRead();
+        if (OptimisticLock::isLocked(rootVersion))
+        {
+            return false;
+        }
+        Node<D> *node = m_root;
+        uint64_t version = node->getVersionLock().beginRead();
+        if (OptimisticLock::isLocked(version) || OptimisticLock::isObsolete(version) ||
+            !m_rootVersion.validate(rootVersion))
+        {
+            return false;
+        }
+
+        Node<D> *parent = nullptr;
+        uint64_t parentVersion = 0;
+        while (true)
+        {
+            if (node->getEntryCount() >= m_maxEntries)
+            {
+                // 满节点在下降途中先分裂：锁住父节点（根节点时锁住根指针）和本节点，分裂后从根重新开始
+                OptimisticLock &parentLock = parent ? parent->getVersionLock() : m_rootVersion;
+                if (!parentLock.tryUpgrade(parent ? parentVersion : rootVersion))
+                {
+                    return false;
+                }
+                if (!node->getVersionLock().tryUpgrade(version))
+                {
+                    parentLock.writeUnlock();
+                    return false;
+                }
+                splitOptimistic(node, parent);
+                node->getVersionLock().writeUnlock();
+                parentLock.writeUnlock();
+                return false;
+            }
+
+            if (node->isLeaf())
+            {
+                if (!node->getVersionLock().tryUpgrade(version))
+                {
+                    return false;
+                }
+                node->insertEntry(entry);
+                node->getVersionLock().writeUnlock();
+                return true;
+            }
+
+            // 在SoA边界上选择子树；读到的下标和指针要等版本确认后才能使用
+            const NodeBounds<D> &bounds = node->getBounds();
+            if (bounds.size() == 0)
+            {
+                return false;
+            }
+            size_t index = bounds.chooseLeastEnlargement(entry.m_region);
+            bool covered = bounds.covers(index, entry.m_region);
+            Node<D> *child = static_cast<Node<D> *>(bounds.payload(index));
+            if (!node->getVersionLock().validate(version))
+            {
+                return false;
+            }
+
+            uint64_t childVersion;
+            if (!covered)
+            {
+                // 需要扩大子节点的条目区域：加写锁修改后继续下降
+                if (!node->getVersionLock().tryUpgrade(version))
+                {
+                    return false;
+                }
+                Region<D> enlarged = node->getEntry(index).m_region;
+                enlarged.combineRegion(entry.m_region);
+                node->setEntryRegion(index, enlarged);
+                node->updateMBR();
+                childVersion = child->getVersionLock().beginRead();
+                version = node->getVersionLock().writeUnlock();
+            }
+            else
+            {
+                childVersion = child->getVersionLock().beginRead();
+                if (!node->getVersionLock().validate(version))
+                {
+                    return false;
+                }
+            }
+            if (OptimisticLock::isLocked(childVersion) || OptimisticLock::isObsolete(childVersion))
+            {
+                return false;
+            }
+
+            parent = node;
+            parentVersion = version;
+            node = child;
+            version = childVersion;
+        }
+    }
+
+    template <size_t D>
+    void RTree<D>::splitOptimistic(Node<D> *node, Node<D> *parent)
+    {
+        // node已满：取出最后一个条目，连同它一起分裂，两个节点都不超过M个条目
+        Entry<D> last = node->copyEntry(node->getEntryCount() - 1);
+        node->removeEntry(node->getEntryCount() - 1);
+        Node<D> *newNode = nullptr;
+        node->split(last, newNode, m_maxEntries);
+
+        if (parent)
+        {
+            // 新节点在挂到父节点之前对读者不可见
+            parent->setEntryRegion(parent->findChild(node), node->getMBR());
+            static_cast<InternalNode<D> *>(parent)->addChild(newNode, newNode->getMBR(), generateID());
+            return;
+        }
+
+        InternalNode<D> *newRoot = createInternalNode(node->getLevel() + 1);
+        newRoot->addChild(node, node->getMBR(), generateID());
+        newRoot->addChild(newNode, newNode->getMBR(), generateID());
+        m_root = newRoot;
+        m_treeHeight = node->getLevel() + 2;
+    }
+
+    template <size_t D>
+    bool RTree<D>::removeOptimistic(id_type id, const Region<D> &mbr)
+    {
+        EpochGuard epoch;
+        while (true)
+        {
+            int result = tryRemoveOptimistic(id, mbr);
+            if (result >= 0)
+            {
+                return result == 1;
+            }
+        }
+    }
+
+    template <size_t D>
+    int RTree<D>::tryRemoveOptimistic(id_type id, const Region<D> &mbr)
+    {
+        struct Frame
+        {
+            Node<D> *node;
+            uint64_t version;
+            size_t depth;
+        };
+
+        uint64_t rootVersion = m_rootVersion.beginRead();
+        if (OptimisticLock::isLocked(rootVersion))
+        {
+            return -1;
+        }
+        Node<D> *root = m_root;
+        uint64_t version = root->getVersionLock().beginRead();
+        if (OptimisticLock::isLocked(version) || OptimisticLock::isObsolete(version) ||
+            !m_rootVersion.validate(rootVersion))
+        {
+            return -1;
+        }
+
+        // 深度优先查找叶子，path记录从根到当前节点的路径及读到的版本号
+        std::vector<Frame> stack;
+        std::vector<std::pair<Node<D> *, uint64_t>> path;
+        HitMask mask;
+        stack.push_back({root, version, 0});
+        int index = -1;
+        while (!stack.empty() && index < 0)
+        {
+            Frame frame = stack.back();
+            stack.pop_back();
+            path.resize(frame.depth);
+            path.emplace_back(frame.node, frame.version);
+            OptimisticLock &lock = frame.node->getVersionLock();
+
+            if (frame.node->isLeaf())
+            {
+                index = frame.node->findEntry(id);
+                if (!lock.validate(frame.version))
+                {
+                    return -1;
+                }
+                continue;
+            }
+
+            // 先确认子节点指针有效，再读取子节点版本号，最后再次确认父节点未变
+            frame.node->intersectMask(mbr, mask);
+            size_t begin = stack.size();
+            mask.forEach([&](size_t i)
+                         { stack.push_back({static_cast<Node<D> *>(frame.node->getPayload(i)), 0, frame.depth + 1}); });
+            if (!lock.validate(frame.version))
+            {
+                return -1;
+            }
+            for (size_t i = begin; i < stack.size(); i++)
+            {
+                stack[i].version = stack[i].node->getVersionLock().beginRead();
+                if (OptimisticLock::isLocked(stack[i].version) || OptimisticLock::isObsolete(stack[i].version))
+                {
+                    return -1;
+                }
+            }
+            if (!lock.validate(frame.version))
+            {
+                return -1;
+            }
+        }
+        if (index < 0)
+        {
+            return 0;
+        }
+
+        // 自叶子向上找出会被删空的节点，从最高的保留节点开始自上而下加锁
+        size_t leafDepth = path.size() - 1;
+        size_t top = leafDepth;
+        while (top > 0 && path[top].first->getEntryCount() == 1)
+        {
+            top--;
+        }
+        bool replaceRoot = top == 0 && leafDepth > 0 && path[0].first->getEntryCount() == 1;
+        if (replaceRoot && !m_rootVersion.tryUpgrade(rootVersion))
+        {
+            return -1;
+        }
+        for (size_t d = top; d <= leafDepth; d++)
+        {
+            if (!path[d].first->getVersionLock().tryUpgrade(path[d].second))
+            {
+                for (size_t u = top; u < d; u++)
+                {
+                    path[u].first->getVersionLock().writeUnlock();
+                }
+                if (replaceRoot)
+                {
+                    m_rootVersion.writeUnlock();
+                }
+                return -1;
+            }
+        }
+
+        // 版本号都未变，读到的路径和下标仍然有效
+        Node<D> *leaf = path[leafDepth].first;
+        leaf->removeEntry(index);
+        m_size--;
+
+        // 删空的节点从父节点摘除、标记为废弃，等读者离开后回收（不收缩MBR）
+        for (size_t d = leafDepth; d > top; d--)
+        {
+            Node<D> *node = path[d].first;
+            Node<D> *parent = path[d - 1].first;
+            parent->removeEntry(parent->findChild(node));
+            node->getVersionLock().writeUnlockObsolete();
+            retireNode(node);
+        }
+        if (replaceRoot)
+        {
+            m_root = createLeafNode();
+            m_treeHeight = 1;
+            path[0].first->getVersionLock().writeUnlockObsolete();
+            retireNode(path[0].first);
+            m_rootVersion.writeUnlock();
+        }
+        else
+        {
+            path[top].first->getVersionLock().writeUnlock();
+        }
+        return 1;
+    }
+
+    template <size_t D>
+    void RTree<D>::retireNode(Node<D> *node)
+    {
+        EpochManager &epochs = EpochManager::instance();
+        std::lock_guard<std::mutex> lock(m_retiredMutex);
+        m_retired.emplace_back(epochs.currentEpoch(), node);
+
+        // 推进epoch并释放早于所有活跃线程的节点
+        epochs.tryAdvance();
+        uint64_t safe = epochs.safeEpoch();
+        size_t kept = 0;
+        for (auto &retired : m_retired)
+        {
+            if (retired.first < safe)
+            {
+                destroyNode(retired.second);
+            }
+            else
+            {
+                m_retired[kept++] = retired;
+            }
+        }
+        m_retired.resize(kept);
+    }
+
+    template <size_t D>
+    void RTree<D>::ensureHilbertCurve(const Region<D> &mbr)
+    {
+        if (!m_hilbertCurve.isValid())
+        {
+            // 未指定曲线：以当前树的MBR（空树时为mbr）作为空间范围
+            m_hilbertCurve = HilbertCurve<D>(m_root->getEntryCount() > 0 ? m_root->getMBR() : mbr);
+        }
+
+        // Hilbert值取自区域中心；中心落在范围外时会被截断到边界格子，大量数据共用同一个值，
+        // 因此扩大范围并按新曲线重新打包（范围成倍扩大，重新打包的次数只随坐标范围对数增长）
+        Region<D> center = mbr;
+        for (size_t d = 0; d < center.getDimension(); d++)
+        {
+            center.m_low[d] = center.m_high[d] = (mbr.m_low[d] + mbr.m_high[d]) / 2.0;
+        }
+        if (widenHilbertCurve(center) && m_root->getEntryCount() > 0)
+        {
+            // 调用者已把即将插入的条目计入m_size，重新打包会按已有条目重置计数
+            size_t size = m_size;
+            std::vector<Entry<D>> entries;
+            HilbertBulkLoadStrategy<D> strategy(m_hilbertCurve);
+            bulkLoadEntries(entries, strategy);
+            m_size = size;
+        }
+    }
+
+    template <size_t D>
+    bool RTree<D>::widenHilbertCurve(const Region<D> &required)
+    {
+        const Region<D> &world = m_hilbertCurve.getWorld();
+        if (required.getDimension() != world.getDimension() || world.containsRegion(required))
+        {
+            return false;
+        }
+
+        // 超出的一侧再向外延伸合并后的跨度，之后的同向插入不会立刻再次触发
+        Region<D> widened = world;
+        widened.combineRegion(required);
+        for (size_t d = 0; d < widened.getDimension(); d++)
+        {
+            double span = widened.m_high[d] - widened.m_low[d];
+            if (required.m_low[d] < world.m_low[d])
+            {
+                widened.m_low[d] -= span;
+            }
+            if (required.m_high[d] > world.m_high[d])
+            {
+                widened.m_high[d] += span;
+            }
+        }
+        m_hilbertCurve = HilbertCurve<D>(widened);
+        return true;
+    }
+
+    template <size_t D>
+    void RTree<D>::insertHilbert(const Entry<D> &entry)
+    {
+        // 选择叶子：每层选择LHV大于h的第一个条目，没有则选择最后一个
+        Node<D> *node = m_root;
+        while (!node->isLeaf())
+        {
+            size_t chosen = node->getEntryCount() - 1;
+            for (size_t i = 0; i < node->getEntryCount(); i++)
+            {
+                if (node->getEntry(i).m_hilbertValue > entry.m_hilbertValue)
+                {
+                    chosen = i;
+                    break;
+                }
+            }
+            node = node->getChild(chosen);
+        }
+
+        insertHilbertEntry(unsharePath(node), entry);
+    }
+
+    template <size_t D>
+    void RTree<D>::insertHilbertEntry(Node<D> *node, const Entry<D> &entry)
+    {
+        // 节点未满：按Hilbert值有序插入，然后向上更新MBR和LHV
+        if (node->getEntryCount() < m_maxEntries)
+        {
+            size_t pos = 0;
+            while (pos < node->getEntryCount() && node->getEntry(pos).m_hilbertValue <= entry.m_hilbertValue)
+            {
+                pos++;
+            }
+            node->insertEntryAt(pos, entry);
+            if (!node->isLeaf())
+            {
+                entry.m_childNode->setParent(node);
+            }
+            propagateHilbert(node);
+            return;
+        }
+
+        // 节点已满：与父节点中相邻的一个兄弟协作（延迟分裂）
+        Node<D> *parent = node->getParent();
+        std::vector<Node<D> *> siblings;
+        if (parent)
+        {
+            size_t index = 0;
+            while (parent->getChild(index) != node)
+            {
+                index++;
+            }
+            if (index + 1 < parent->getEntryCount())
+            {
+                siblings.push_back(node);
+                siblings.push_back(unshareChild(parent, index + 1));
+            }
+            else if (index > 0)
+            {
+                siblings.push_back(unshareChild(parent, index - 1));
+                siblings.push_back(node);
+            }
+        }
+        if (siblings.empty())
+        {
+            siblings.push_back(node);
+        }
+
+        // 收集协作节点的全部条目和新条目，按Hilbert值排序
+        std::vector<Entry<D>> all;
+        for (Node<D> *sibling : siblings)
+        {
+            for (size_t i = 0; i < sibling->getEntryCount(); i++)
+            {
+                all.push_back(sibling->getEntry(i));
+            }
+        }
+        all.push_back(entry);
+        std::stable_sort(all.begin(), all.end(),
+                         [](const Entry<D> &a, const Entry<D> &b)
+                         { return a.m_hilbertValue < b.m_hilbertValue; });
+
+        // 兄弟都满：新建一个节点，s个节点的条目均分到s+1个节点（2-to-3分裂）
+        Node<D> *newNode = nullptr;
+        if (all.size() > siblings.size() * m_maxEntries)
+        {
+            if (node->isLeaf())
+            {
+                newNode = createLeafNode();
+            }
+            else
+            {
+                newNode = createInternalNode(node->getLevel());
+            }
+            siblings.push_back(newNode);
+        }
+
+        // 按顺序均分
+        size_t base = all.size() / siblings.size();
+        size_t extra = all.size() % siblings.size();
+        size_t begin = 0;
+        for (size_t s = 0; s < siblings.size(); s++)
+        {
+            size_t count = base + (s < extra ? 1 : 0);
+            siblings[s]->setEntries(all.data() + begin, count);
+            if (siblings[s]->isLeaf())
+            {
+                indexLeaf(siblings[s]);
+            }
+            begin += count;
+        }
+
+        if (!parent)
+        {
+            // 根节点分裂：创建新根
+            InternalNode<D> *newRoot = createInternalNode(m_treeHeight);
+            for (Node<D> *child : siblings)
+            {
+                newRoot->addChild(child, child->getMBR(), generateID());
+                newRoot->getEntryRef(newRoot->getEntryCount() - 1).m_hilbertValue = child->getLargestHilbertValue();
+            }
+            m_treeHeight++;
+            m_root = newRoot;
+            return;
+        }
+
+        // 更新父节点中协作节点的条目
+        for (size_t s = 0; s < siblings.size(); s++)
+        {
+            if (siblings[s] != newNode)
+            {
+                updateHilbertEntry(parent, siblings[s]);
+            }
+        }
+
+        if (!newNode)
+        {
+            propagateHilbert(parent);
+            return;
+        }
+
+        // 把新节点插入父节点（父节点也可能溢出）
+        newNode->setParent(parent);
+        Entry<D> newEntry(newNode->getMBR(), generateID(), newNode);
+        newEntry.m_hilbertValue = newNode->getLargestHilbertValue();
+        insertHilbertEntry(parent, newEntry);
+    }
+
+    template <size_t D>
+    void RTree<D>::updateHilbertEntry(Node<D> *parent, Node<D> *child)
+    {
+        for (size_t i = 0; i < parent->getEntryCount(); i++)
+        {
+            if (parent->getChild(i) == child)
+            {
+                parent->setEntryRegion(i, child->getMBR());
+                parent->getEntryRef(i).m_hilbertValue = child->getLargestHilbertValue();
+                break;
+            }
+        }
+        parent->updateMBR();
+    }
+
+    template <size_t D>
+    void RTree<D>::propagateHilbert(Node<D> *node)
+    {
+        while (node != m_root)
+        {
+            Node<D> *parent = node->getParent();
+            updateHilbertEntry(parent, node);
+            node = parent;
+        }
+    }
+
+    template <size_t D>
+    void RTree<D>::setInsertMode(InsertMode mode)
+    {
+        if (mode != InsertMode::Guttman && m_concurrencyMode != ConcurrencyMode::None)
+        {
+            throw std::invalid_argument("concurrent modes require Guttman insert mode");
+        }
+        if (mode == InsertMode::Hilbert && isQuantizedLayout(m_nodeLayout))
+        {
+            throw std::invalid_argument("Hilbert insert mode does not support quantized node layouts");
+        }
+        m_insertMode = mode;
+        if (mode == InsertMode::Hilbert && m_size > 0)
+        {
+            // 已有数据不满足Hilbert顺序，重新打包
+            std::vector<Entry<D>> entries;
+            HilbertBulkLoadStrategy<D> strategy(m_hilbertCurve);
+            bulkLoadEntries(entries, strategy);
+        }
+    }
+
+    template <size_t D>
+    void RTree<D>::adjustTree(Node<D> *node, Node<D> *newNode)
+    {
+        // 如果是根节点
+        if (node == m_root)
+        {
+            if (newNode)
+            {
+                // 创建新的根节点，旧根的所有权转移给新根
+                InternalNode<D> *newRoot = createInternalNode(m_treeHeight);
+    
+                // 添加旧根和新节点作为子节点
+                newRoot->addChild(node, node->getMBR(), generateID());
+                newRoot->addChild(newNode, newNode->getMBR(), generateID());
+
+                // 更新树的高度
+                m_treeHeight++;
+
+                // 设置新的根节点
+                m_root = newRoot;
+            }
+            return;
+        }
+
+        // 获取父节点
+        Node<D> *parent = node->getParent();
+
+        // 更新父节点中对应条目的MBR
+        for (size_t i = 0; i < parent->getEntryCount(); i++)
+        {
+            if (parent->getChild(i) == node)
+            {
+                parent->setEntryRegion(i, node->getMBR());
+                break;
+            }
+        }
+
+        // 如果有新节点，将其添加到父节点
+        if (newNode)
+        {
+            if (parent->getEntryCount() < m_maxEntries)
+            {
+                // 在父节点中增加新节点
+                InternalNode<D> *internalParent = static_cast<InternalNode<D> *>(parent);
+                internalParent->addChild(newNode, newNode->getMBR(), generateID());
+
+                // 没有分裂，继续向上调整
+                adjustTree(parent);
+            }
+            else
+            {
+                // 父节点已满：以指向新节点的条目分裂父节点
+                Entry<D> newEntry(newNode->getMBR(), generateID(), newNode);
+                Node<D> *newParent = nullptr;
+                parent->split(newEntry, newParent, m_maxEntries);
+
+                // 继续向上调整
+                adjustTree(parent, newParent);
+            }
+        }
+        else
+        {
+            // 更新父节点的MBR
+            parent->updateMBR();
+
+            // 继续向上调整
+            adjustTree(parent);
+        }
+    }
+
+    template <size_t D>
+    std::vector<void *> RTree<D>::search(const Region<D> &query) const
+    {
+        std::vector<void *> results;
+        visit(query, [&](void *data)
+              {
+                  results.push_back(data);
+                  return true; });
+        return results;
+    }
+
+    template <size_t D>
+    std::vector<std::vector<void *>> RTree<D>::searchBatch(const std::vector<Region<D>> &queries) const
+    {
+        std::vector<std::vector<void *>> results(queries.size());
+        if (!m_root || queries.empty())
+        {
+            return results;
+        }
+
+        // 每个待访问节点对应active中的一段查询下标[begin, end)。
+        // 深度优先下，出栈节点之上的区段都已处理完，可以直接截断，active的长度不超过树高×扇出×查询数
+        struct Frame
+        {
+            const Node<D> *node;
+            size_t begin;
+            size_t end;
+        };
+        std::vector<uint32_t> active(queries.size());
+        for (size_t q = 0; q < queries.size(); q++)
+        {
+            active[q] = static_cast<uint32_t>(q);
+        }
+        std::vector<Frame> stack;
+        stack.push_back(Frame{m_root, 0, queries.size()});
+
+        HitMask mask;
+        std::vector<std::pair<uint32_t, uint32_t>> hits; // (子节点下标, 查询下标)
+        std::vector<size_t> offsets;
+
+        while (!stack.empty())
+        {
+            Frame frame = stack.back();
+            stack.pop_back();
+            active.resize(frame.end);
+            const Node<D> *node = frame.node;
+
+            if (node->isLeaf())
+            {
+                for (size_t k = frame.begin; k < frame.end; k++)
+                {
+                    uint32_t q = active[k];
+                    node->intersectMask(queries[q], mask);
+                    mask.forEach([&](size_t i)
+                                 { results[q].push_back(node->getPayload(i)); });
+                }
+                continue;
+            }
+
+            // 逐个查询检测节点的全部条目，记录命中的(子节点, 查询)对
+            hits.clear();
+            for (size_t k = frame.begin; k < frame.end; k++)
+            {
+                uint32_t q = active[k];
+                node->intersectMask(queries[q], mask);
+                mask.forEach([&](size_t i)
+                             { hits.push_back(std::make_pair(static_cast<uint32_t>(i), q)); });
+            }
+            if (hits.empty())
+            {
+                continue;
+            }
+
+            // 按子节点计数排序，为每个子节点生成连续的查询区段
+            size_t childCount = node->getEntryCount();
+            offsets.assign(childCount + 1, 0);
+            for (const auto &hit : hits)
+            {
+                offsets[hit.first + 1]++;
+            }
+            for (size_t i = 0; i < childCount; i++)
+            {
+                offsets[i + 1] += offsets[i];
+            }
+
+            size_t base = active.size();
+            active.resize(base + hits.size());
+            for (size_t i = 0; i < childCount; i++)
+            {
+                if (offsets[i + 1] > offsets[i])
+                {
+                    stack.push_back(Frame{static_cast<const Node<D> *>(node->getPayload(i)),
+                                          base + offsets[i], base + offsets[i + 1]});
+                }
+            }
+            for (const auto &hit : hits)
+            {
+                active[base + offsets[hit.first]++] = hit.second;
+            }
+        }
+
+        return results;
+    }
+
+    template <size_t D>
+    bool RTree<D>::scanOptimistic(const Region<D> &query, TraversalScratch &scratch, bool stopAtFirst) const
+    {
+        std::vector<std::pair<const Node<D> *, uint64_t>> &stack = scratch.linkStack;
+        std::vector<void *> &hits = scratch.hits;
+        HitMask &mask = scratch.mask;
+        stack.clear();
+        hits.clear();
+
+        uint64_t rootVersion = m_rootVersion.beginRead();
+        if (OptimisticLock::isLocked(rootVersion))
+        {
+            return false;
+        }
+        const Node<D> *root = m_root;
+        uint64_t version = root->getVersionLock().beginRead();
+        if (OptimisticLock::isLocked(version) || OptimisticLock::isObsolete(version) ||
+            !m_rootVersion.validate(rootVersion))
+        {
+            return false;
+        }
+        stack.emplace_back(root, version);
+
+        while (!stack.empty())
+        {
+            const Node<D> *node = stack.back().first;
+            version = stack.back().second;
+            stack.pop_back();
+            const OptimisticLock &lock = node->getVersionLock();
+            node->intersectMask(query, mask);
+
+            if (node->isLeaf())
+            {
+                size_t begin = hits.size();
+                mask.forEach([&](size_t i)
+                             { hits.push_back(node->getPayload(i)); });
+                if (!lock.validate(version))
+                {
+                    return false;
+                }
+                if (stopAtFirst && hits.size() > begin)
+                {
+                    return true;
+                }
+                continue;
+            }
+
+            // 先确认子节点指针有效，再读取子节点版本号，最后再次确认父节点未变
+            size_t begin = stack.size();
+            mask.forEach([&](size_t i)
+                         { stack.emplace_back(static_cast<const Node<D> *>(node->getPayload(i)), 0); });
+            if (!lock.validate(version))
+            {
+                return false;
+            }
+            for (size_t i = begin; i < stack.size(); i++)
+            {
+                stack[i].second = stack[i].first->getVersionLock().beginRead();
+                if (OptimisticLock::isLocked(stack[i].second) || OptimisticLock::isObsolete(stack[i].second))
+                {
+                    return false;
+                }
+            }
+            if (!lock.validate(version))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <size_t D>
+    size_t RTree<D>::count(const Region<D> &query) const
+    {
+        if (m_concurrencyMode == ConcurrencyMode::RLink)
+        {
+            return visitRLink(query, [](void *)
+                              { return true; });
+        }
+        if (m_concurrencyMode == ConcurrencyMode::Optimistic)
+        {
+            return visitOptimistic(query, [](void *)
+                                   { return true; });
+        }
+
+        size_t hits = 0;
+        traverse(query, [&](const Node<D> *, const HitMask &mask)
+                 {
+                     hits += mask.popcount();
+                     return true; });
+        return hits;
+    }
+
+    template <size_t D>
+    bool RTree<D>::exists(const Region<D> &query) const
+    {
+        if (m_concurrencyMode == ConcurrencyMode::RLink)
+        {
+            return visitRLink(query, [](void *)
+                              { return false; }) > 0;
+        }
+        if (m_concurrencyMode == ConcurrencyMode::Optimistic)
+        {
+            // 只需找到第一个经过验证的命中
+            TraversalScratch scratch;
+            EpochGuard epoch;
+            while (!scanOptimistic(query, scratch, true))
+            {
+            }
+            return !scratch.hits.empty();
+        }
+
+        bool found = false;
+        traverse(query, [&](const Node<D> *, const HitMask &mask)
+                 {
+                     found = mask.any();
+                     return !found; });
+        return found;
+    }
+
+    template <size_t D>
+    std::vector<DistanceEntry> RTree<D>::nearest(const Point<D> &point, size_t k) const
+    {
+        std::vector<DistanceEntry> results;
+        NearestIterator<D> it = nearestIterator(point);
+        while (results.size() < k && it.hasNext())
+        {
+            results.push_back(it.next());
+        }
+        return results;
+    }
+
+    template <size_t D>
+    Node<D> *RTree<D>::findLeaf(Node<D> *node, id_type id, const Region<D> &mbr) const
+    {
+        if (!node)
+            return nullptr;
+
+        // 递归查找
+        return node->findLeaf(id, mbr);
+    }
+
+    template <size_t D>
+    bool RTree<D>::remove(id_type id, const Region<D> &mbr)
+    {
+        if (m_concurrencyMode == ConcurrencyMode::Optimistic)
+        {
+            return removeOptimistic(id, mbr);
+        }
+
+        Node<D> *leaf = removeFromLeaf(id, &mbr);
+        if (!leaf)
+        {
+            return false; // 未找到
+        }
+        condenseTree(std::vector<Node<D> *>(1, leaf));
+        return true;
+    }
+
+    template <size_t D>
+    bool RTree<D>::remove(id_type id)
+    {
+        if (!m_idIndexEnabled)
+        {
+            throw std::logic_error("remove by id requires the id index");
+        }
+
+        Node<D> *leaf = removeFromLeaf(id, nullptr);
+        if (!leaf)
+        {
+            return false;
+        }
+        condenseTree(std::vector<Node<D> *>(1, leaf));
+        return true;
+    }
+
+    template <size_t D>
+    bool RTree<D>::update(id_type id, const Region<D> &mbr)
+    {
+        if (!m_idIndexEnabled)
+        {
+            throw std::logic_error("update requires the id index");
+        }
+        auto it = m_idIndex.find(id);
+        if (it == m_idIndex.end())
+        {
+            return false;
+        }
+        Node<D> *leaf = unsharePath(it->second);
+        size_t index = static_cast<size_t>(leaf->findEntry(id));
+
+        if (m_insertMode != InsertMode::Hilbert)
+        {
+            // 第一步：仍在叶子的MBR内，原地修改，叶子的MBR只可能缩小
+            if (leaf->getMBR().containsRegion(mbr))
+            {
+                leaf->setEntryRegion(index, mbr);
+                leaf->updateMBR();
+                tightenPath(leaf);
+                return true;
+            }
+
+            // 第二步：同一父节点下选MBR包含新位置、面积最小的未满兄弟，兄弟及以上的MBR都不变
+            Node<D> *parent = leaf->getParent();
+            if (parent && leaf->getEntryCount() > m_minEntries)
+            {
+                size_t best = parent->getEntryCount();
+                double bestArea = std::numeric_limits<double>::infinity();
+                for (size_t i = 0; i < parent->getEntryCount(); i++)
+                {
+                    const Node<D> *sibling = parent->getChild(i);
+                    if (sibling != leaf && sibling->getEntryCount() < m_maxEntries &&
+                        sibling->getMBR().containsRegion(mbr) && sibling->getMBR().getArea() < bestArea)
+                    {
+                        best = i;
+                        bestArea = sibling->getMBR().getArea();
+                    }
+                }
+                if (best < parent->getEntryCount())
+                {
+                    Entry<D> entry = leaf->getEntry(index);
+                    entry.m_region = mbr;
+                    leaf->removeEntry(index);
+                    unshareChild(parent, best)->insertEntry(entry);
+                    tightenPath(leaf);
+                    return true;
+                }
+            }
+        }
+
+        // 第三步：删除后从根重新插入，保留原ID
+        Entry<D> entry = leaf->getEntry(index);
+        leaf = removeFromLeaf(id, nullptr);
+        condenseTree(std::vector<Node<D> *>(1, leaf));
+        insert(id, entry.m_data, entry.m_dataSize, mbr);
+        return true;
+    }
+
+    template <size_t D>
+    void RTree<D>::tightenPath(Node<D> *node)
+    {
+        while (node != m_root)
+        {
+            Node<D> *parent = node->getParent();
+            size_t index = static_cast<size_t>(parent->findChild(node));
+            if (parent->isQuantized())
+            {
+                // 量化节点没有保存子节点的区域，无从比较：重新编码后父节点MBR不变即可停止
+                Region<D> before = parent->getMBR();
+                parent->setEntryRegion(index, node->getMBR());
+                parent->updateMBR();
+                if (before.m_low == parent->getMBR().m_low && before.m_high == parent->getMBR().m_high)
+                {
+                    return;
+                }
+                node = parent;
+                continue;
+            }
+            const Region<D> &stored = parent->getEntry(index).m_region;
+            if (stored.m_low == node->getMBR().m_low && stored.m_high == node->getMBR().m_high)
+            {
+                return;
+            }
+            parent->setEntryRegion(index, node->getMBR());
+            parent->updateMBR();
+            node = parent;
+        }
+    }
+
+    template <size_t D>
+    size_t RTree<D>::removeBatch(const std::vector<std::pair<id_type, Region<D>>> &items)
+    {
+        size_t removed = 0;
+        if (m_concurrencyMode == ConcurrencyMode::Optimistic)
+        {
+            for (const auto &item : items)
+            {
+                removed += removeOptimistic(item.first, item.second) ? 1 : 0;
+            }
+            return removed;
+        }
+
+        // 先从叶子中删除全部条目，最后对所有受影响的叶子统一做一次CondenseTree
+        std::vector<Node<D> *> leaves;
+        for (const auto &item : items)
+        {
+            Node<D> *leaf = removeFromLeaf(item.first, &item.second);
+            if (leaf)
+            {
+                leaves.push_back(leaf);
+                removed++;
+            }
+        }
+        if (!leaves.empty())
+        {
+            condenseTree(std::move(leaves));
+        }
+        return removed;
+    }
+
+    template <size_t D>
+    Node<D> *RTree<D>::removeFromLeaf(id_type id, const Region<D> *mbr)
+    {
+        // 找到包含该条目的叶子节点
+        Node<D> *leaf = nullptr;
+        if (m_idIndexEnabled)
+        {
+            auto it = m_idIndex.find(id);
+            leaf = it == m_idIndex.end() ? nullptr : it->second;
+        }
+        else
+        {
+            leaf = findLeaf(m_root, id, *mbr);
+        }
+        if (!leaf || !leaf->isLeaf())
+        {
+            return nullptr;
+        }
+        leaf = unsharePath(leaf);
+
+        int entryIndex = leaf->findEntry(id);
+        if (entryIndex < 0)
+        {
+            return nullptr;
+        }
+        leaf->removeEntry(entryIndex);
+        m_idIndex.erase(id);
+        m_size--;
+        return leaf;
+    }
+
+    template <size_t D>
+    void RTree<D>::condenseTree(std::vector<Node<D> *> dirty)
+    {
+        // 自底向上逐层处理被修改过的节点：下溢的非根节点从父节点中摘除，其条目记为孤儿（连同所在层级）；
+        // 其余节点把缩小后的MBR写回父条目。同一父节点只处理一次，所以批量删除时每个节点最多调整一次
+        std::vector<std::pair<Entry<D>, size_t>> orphans;
+        std::vector<Node<D> *> parents;
+        while (!dirty.empty())
+        {
+            std::sort(dirty.begin(), dirty.end());
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+            parents.clear();
+            for (Node<D> *node : dirty)
+            {
+                if (node == m_root)
+                {
+                    continue;
+                }
+                Node<D> *parent = node->getParent();
+                int index = parent->findChild(node);
+                if (node->isUnderflow(m_minEntries) || node->getEntryCount() == 0)
+                {
+                    for (size_t i = 0; i < node->getEntryCount(); i++)
+                    {
+                        orphans.push_back(std::make_pair(node->copyEntry(i), node->getLevel()));
+                    }
+                    // 条目已转给孤儿列表，只释放节点本身
+                    parent->removeEntry(index);
+                    destroyNode(node);
+                }
+                else if (m_insertMode == InsertMode::Hilbert)
+                {
+                    updateHilbertEntry(parent, node);
+                }
+                else
+                {
+                    parent->setEntryRegion(index, node->getMBR());
+                    parent->updateMBR();
+                }
+                parents.push_back(parent);
+            }
+            dirty.swap(parents);
+        }
+
+        // 所有子节点都被摘除时根节点为空，换成空叶子
+        if (!m_root->isLeaf() && m_root->getEntryCount() == 0)
+        {
+            destroyNode(m_root);
+            m_root = createLeafNode();
+            m_treeHeight = 1;
+        }
+
+        // 高层的孤儿先插回原来的层级，保证树高不变时它们的子树仍在正确的深度
+        std::stable_sort(orphans.begin(), orphans.end(),
+                         [](const std::pair<Entry<D>, size_t> &a, const std::pair<Entry<D>, size_t> &b)
+                         { return a.second > b.second; });
+        for (const auto &orphan : orphans)
+        {
+            reinsertOrphan(orphan.first, orphan.second);
+        }
+
+        // 根节点只剩一个子节点时降低树高
+        while (!m_root->isLeaf() && m_root->getEntryCount() == 1)
+        {
+            Node<D> *child = m_root->getChild(0);
+            destroyNode(m_root);
+            child->setParent(nullptr);
+            m_root = child;
+            m_treeHeight = child->getLevel() + 1;
+        }
+    }
+
+    template <size_t D>
+    void RTree<D>::reinsertOrphan(const Entry<D> &entry, size_t level)
+    {
+        // 树已变矮或Hilbert模式（条目必须按Hilbert值有序）时，把子树拆成数据条目逐个插入
+        if (level > 0 && (level > m_root->getLevel() || m_insertMode == InsertMode::Hilbert))
+        {
+            std::vector<Entry<D>> entries;
+            std::vector<const Node<D> *> stack(1, entry.m_childNode);
+            while (!stack.empty())
+            {
+                const Node<D> *node = stack.back();
+                stack.pop_back();
+                for (size_t i = 0; i < node->getEntryCount(); i++)
+                {
+                    if (node->isLeaf())
+                    {
+                        entries.push_back(node->getEntry(i));
+                    }
+                    else
+                    {
+                        stack.push_back(node->getChild(i));
+                    }
+                }
+            }
+            destroySubtree(entry.m_childNode);
+            for (const auto &dataEntry : entries)
+            {
+                reinsertOrphan(dataEntry, 0);
+            }
+            return;
+        }
+
+        if (m_insertMode == InsertMode::Hilbert)
+        {
+            insertHilbert(entry);
+            return;
+        }
+        if (m_insertMode == InsertMode::RStar)
+        {
+            std::vector<bool> reinserted(m_treeHeight, false);
+            insertRStar(entry, level, reinserted);
+            return;
+        }
+
+        // Guttman：在level层选择面积扩展最小的节点放入，满了就分裂
+        Node<D> *node = m_root;
+        while (node->getLevel() > level)
+        {
+            node = static_cast<InternalNode<D> *>(node)->chooseChild(entry.m_region);
+        }
+        node = unsharePath(node);
+        if (node->getEntryCount() < m_maxEntries)
+        {
+            if (node->isLeaf())
+            {
+                node->insertEntry(entry);
+            }
+            else
+            {
+                static_cast<InternalNode<D> *>(node)->addChild(entry.m_childNode, entry.m_region, entry.m_id);
+            }
+            adjustTree(node);
+            return;
+        }
+        Node<D> *newNode = nullptr;
+        node->split(entry, newNode, m_maxEntries);
+        adjustTree(node, newNode);
+    }
+
+    template <size_t D>
+    void RTree<D>::collectDataEntries(std::vector<Entry<D>> &entries) const
+    {
+        std::vector<Node<D> *> stack;
+        stack.push_back(m_root);
+        while (!stack.empty())
+        {
+            Node<D> *node = stack.back();
+            stack.pop_back();
+            for (size_t i = 0; i < node->getEntryCount(); i++)
+            {
+                if (node->isLeaf())
+                {
+                    entries.push_back(node->getEntry(i));
+                }
+                else
+                {
+                    stack.push_back(node->getChild(i));
+                }
+            }
+        }
+    }
+
+    template <size_t D>
+    BulkLoadStrategy<D> *RTree<D>::choosePacker(const std::vector<Entry<D>> &entries,
+                                                BulkLoadStrategy<D> &strategy,
+                                                HilbertBulkLoadStrategy<D> &hilbertStrategy)
+    {
+        if (m_insertMode != InsertMode::Hilbert)
+        {
+            return &strategy;
+        }
+
+        // Hilbert模式：无论传入何种策略都按树的Hilbert曲线打包，保证后续插入的顺序一致；
+        // 数据超出已有曲线的范围时先扩大范围（反正要重新打包）
+        Region<D> world;
+        for (const auto &entry : entries)
+        {
+            world.combineRegion(entry.m_region);
+        }
+        if (!m_hilbertCurve.isValid())
+        {
+            m_hilbertCurve = HilbertCurve<D>(world);
+        }
+        else
+        {
+            widenHilbertCurve(world);
+        }
+        hilbertStrategy = HilbertBulkLoadStrategy<D>(m_hilbertCurve);
+        return &hilbertStrategy;
+    }
+
+    template <size_t D>
+    std::vector<Entry<D>> RTree<D>::packLevels(std::vector<Entry<D>> level, BulkLoadStrategy<D> &strategy,
+                                               size_t height, size_t stopHeight)
+    {
+        const bool toRoot = stopHeight == std::numeric_limits<size_t>::max();
+        std::vector<size_t> groupEnds;
+        for (; height < stopHeight; height++)
+        {
+            strategy.partition(level, m_maxEntries, m_minEntries, groupEnds);
+
+            std::vector<Entry<D>> parents;
+            parents.reserve(groupEnds.size());
+            size_t begin = 0;
+            for (size_t end : groupEnds)
+            {
+                Node<D> *node = nullptr;
+                if (height == 0)
+                {
+                    node = createLeafNode();
+                }
+                else
+                {
+                    node = createInternalNode(height);
+                }
+
+                node->setEntries(level.data() + begin, end - begin);
+                parents.push_back(Entry<D>(node->getMBR(), generateID(), node));
+                parents.back().m_hilbertValue = node->getLargestHilbertValue();
+                begin = end;
+            }
+
+            level = std::move(parents);
+            if (toRoot && level.size() == 1)
+            {
+                break;
+            }
+        }
+        return level;
+    }
+
+    template <size_t D>
+    void RTree<D>::installRoot(const Entry<D> &top)
+    {
+        Node<D> *root = top.m_childNode;
+        root->setParent(nullptr);
+        m_root = root;
+        m_treeHeight = root->getLevel() + 1;
+    }
+
+    template <size_t D>
+    void RTree<D>::bulkLoadEntries(std::vector<Entry<D>> &entries, BulkLoadStrategy<D> &strategy)
+    {
+        // 收集树中已有的数据条目，与新数据一起重新打包
+        collectDataEntries(entries);
+        destroySubtree(m_root);
+        m_root = nullptr;
+
+        m_size = entries.size();
+        m_treeHeight = 1;
+        if (entries.empty())
         {
-            std::cout << "insert id: " << id << std::endl;
+            m_root = createLeafNode();
+            return;
         }
-        // 第一步：定位叶子节点
-        Node *leafNode = m_root->chooseSubtree(mbr);
 
-        // 第二步：将数据插入叶子节点
-        LeafNode *leaf = static_cast<LeafNode *>(leafNode);
-        leaf->insertData(data, dataSize, mbr, id);
+        // 自底向上逐层打包，直到只剩一个节点
+        HilbertBulkLoadStrategy<D> hilbertStrategy;
+        BulkLoadStrategy<D> *packer = choosePacker(entries, strategy, hilbertStrategy);
+        std::vector<Entry<D>> top = packLevels(std::move(entries), *packer, 0, std::numeric_limits<size_t>::max());
+        installRoot(top[0]);
+        rebuildIdIndex();
+    }
+
+    template <size_t D>
+    void RTree<D>::bulkLoadEntriesParallel(std::vector<Entry<D>> &entries, BulkLoadStrategy<D> &strategy,
+                                           ThreadPool &pool)
+    {
+        collectDataEntries(entries);
+        destroySubtree(m_root);
+        m_root = nullptr;
 
-        // 第三步：如果需要，分裂节点
-        if (leaf->isOverflow(m_maxEntries))
+        m_size = entries.size();
+        m_treeHeight = 1;
+        if (entries.empty())
         {
-            // 创建新条目
-            Entry newEntry(mbr, id, data, dataSize);
+            m_root = createLeafNode();
+            return;
+        }
 
-            // 分裂节点
-            Node *newNode = nullptr;
-            leaf->split(newEntry, newNode, m_maxEntries);
+        HilbertBulkLoadStrategy<D> hilbertStrategy;
+        BulkLoadStrategy<D> *packer = choosePacker(entries, strategy, hilbertStrategy);
 
-            // 调整树
-            adjustTree(leaf, newNode);
+        // 第一步：并行划分。Hilbert模式按Hilbert值排序，否则按第0维中心排序（STR的第一次切片）
+        if (m_insertMode == InsertMode::Hilbert)
+        {
+            const HilbertCurve<D> &curve = m_hilbertCurve;
+            size_t chunks = pool.size();
+            pool.parallelFor(chunks, [&](size_t c)
+                             {
+                                 size_t end = entries.size() * (c + 1) / chunks;
+                                 for (size_t i = entries.size() * c / chunks; i < end; i++)
+                                 {
+                                     entries[i].m_hilbertValue = curve.value(entries[i].m_region);
+                                 } });
+            parallelSort(pool, entries.begin(), entries.end(),
+                         [](const Entry<D> &a, const Entry<D> &b)
+                         { return a.m_hilbertValue < b.m_hilbertValue; });
         }
         else
         {
-            // 没有分裂，只需调整树
-            adjustTree(leaf);
+            parallelSort(pool, entries.begin(), entries.end(),
+                         [](const Entry<D> &a, const Entry<D> &b)
+                         {
+                             return a.m_region.m_low[0] + a.m_region.m_high[0] <
+                                    b.m_region.m_low[0] + b.m_region.m_high[0];
+                         });
+        }
+
+        // 每个分区独立建到stopHeight层，分区数取线程数的4倍以平衡负载。
+        // stopHeight保证每个分区在该层仍有不少于一个满节点的条目
+        size_t partitions = std::max<size_t>(1, pool.size() * 4);
+        size_t perPartition = entries.size() / partitions;
+        size_t stopHeight = 0;
+        size_t subtreeCapacity = 1;
+        while (perPartition / (subtreeCapacity * m_maxEntries) >= m_maxEntries)
+        {
+            subtreeCapacity *= m_maxEntries;
+            stopHeight++;
+        }
+
+        if (stopHeight == 0 || partitions == 1)
+        {
+            std::vector<Entry<D>> top = packLevels(std::move(entries), *packer, 0, std::numeric_limits<size_t>::max());
+            installRoot(top[0]);
+            rebuildIdIndex();
+            return;
+        }
+
+        // 按满子树切分（最后一棵子树可以不满），再把子树尽量平均地分给各分区：
+        // 每个分区得到的子树数相差不超过1，不会有分区吸收大量余数而拖慢整体
+        size_t subtreeEntries = subtreeCapacity * m_maxEntries;
+        size_t subtreeCount = (entries.size() + subtreeEntries - 1) / subtreeEntries;
+        partitions = std::min(partitions, subtreeCount);
+        std::vector<size_t> partitionBegins;
+        for (size_t p = 0; p < partitions; p++)
+        {
+            partitionBegins.push_back(subtreeCount * p / partitions * subtreeEntries);
+        }
+        partitionBegins.push_back(entries.size());
+
+        // 第二步：各分区并行建子树
+        std::vector<std::vector<Entry<D>>> subtrees(partitionBegins.size() - 1);
+        pool.parallelFor(subtrees.size(), [&](size_t p)
+                         {
+                             std::vector<Entry<D>> part(std::make_move_iterator(entries.begin() + partitionBegins[p]),
+                                                        std::make_move_iterator(entries.begin() + partitionBegins[p + 1]));
+                             subtrees[p] = packLevels(std::move(part), *packer, 0, stopHeight); });
+        entries.clear();
+
+        // 第三步：拼接各分区的子树根，顺序打包上层
+        std::vector<Entry<D>> level;
+        for (auto &subtree : subtrees)
+        {
+            level.insert(level.end(), subtree.begin(), subtree.end());
         }
+        std::vector<Entry<D>> top = packLevels(std::move(level), *packer, stopHeight, std::numeric_limits<size_t>::max());
+        installRoot(top[0]);
+        rebuildIdIndex();
     }
 
-    void RTree::adjustTree(Node *node, Node *newNode)
+    template <size_t D>
+    void RTree<D>::setNodeLayout(NodeLayout layout)
     {
-        // 如果是根节点
-        if (node == m_root.get())
+        if (layout != NodeLayout::StructOfArrays && m_concurrencyMode == ConcurrencyMode::Optimistic)
         {
-            if (newNode)
-            {
-                // 创建新的根节点
-                InternalNode *newRoot = new InternalNode(m_treeHeight, this);
-
-                // 添加旧根和新节点作为子节点
-                newRoot->addChild(node, node->getMBR(), generateID());
-                newRoot->addChild(newNode, newNode->getMBR(), generateID());
+            throw std::invalid_argument("optimistic concurrency requires SoA node layout");
+        }
+        if (isQuantizedLayout(layout) && m_concurrencyMode != ConcurrencyMode::None)
+        {
+            throw std::invalid_argument("quantized node layouts require ConcurrencyMode::None");
+        }
+        if (isQuantizedLayout(layout) && m_insertMode == InsertMode::Hilbert)
+        {
+            throw std::invalid_argument("quantized node layouts do not support Hilbert insert mode");
+        }
+        if (hasSnapshots())
+        {
+            throw std::logic_error("cannot change node layout while snapshots exist");
+        }
+        NodeLayout previous = m_nodeLayout;
+        m_nodeLayout = layout;
 
-                // 更新树的高度
-                m_treeHeight++;
+        // 内部节点的存储方式（条目数组或量化编码）改变时按新布局重建全部内部节点
+        if (quantizedBits(layout) != quantizedBits(previous))
+        {
+            m_root = relayoutInternalNodes(m_root);
+            m_root->setParent(nullptr);
+        }
 
-                // 设置新的根节点
-                m_root.reset(newRoot);
+        // 遍历所有节点，按新模式重建或释放SoA边界
+        std::vector<Node<D> *> stack;
+        stack.push_back(m_root);
+        while (!stack.empty())
+        {
+            Node<D> *node = stack.back();
+            stack.pop_back();
+            node->syncBounds();
+            if (!node->isLeaf())
+            {
+                for (size_t i = 0; i < node->getEntryCount(); i++)
+                {
+                    stack.push_back(node->getChild(i));
+                }
             }
-            return;
         }
+    }
 
-        // 获取父节点
-        Node *parent = node->getParent();
+    template <size_t D>
+    Node<D> *RTree<D>::relayoutInternalNodes(Node<D> *node)
+    {
+        if (node->isLeaf())
+        {
+            return node;
+        }
 
-        // 更新父节点中对应条目的MBR
-        for (size_t i = 0; i < parent->getEntryCount(); i++)
+        std::vector<Entry<D>> entries;
+        entries.reserve(node->getEntryCount());
+        for (size_t i = 0; i < node->getEntryCount(); i++)
+        {
+            Node<D> *child = relayoutInternalNodes(node->getChild(i));
+            entries.push_back(Entry<D>(child->getMBR(), generateID(), child));
+        }
+        Node<D> *copy = createInternalNode(node->getLevel());
+        copy->setEntries(entries.data(), entries.size());
+        destroyNode(node);
+        return copy;
+    }
+
+    template <size_t D>
+    void RTree<D>::setIdIndex(bool enable)
+    {
+        if (enable && m_concurrencyMode != ConcurrencyMode::None)
+        {
+            throw std::logic_error("the id index requires ConcurrencyMode::None");
+        }
+        m_idIndexEnabled = enable;
+        rebuildIdIndex();
+    }
+
+    template <size_t D>
+    void RTree<D>::indexLeaf(Node<D> *leaf)
+    {
+        if (m_idIndexEnabled)
         {
-            Entry &entry = parent->getEntryRef(i);
-            if (entry.m_childNode == node)
+            for (size_t i = 0; i < leaf->getEntryCount(); i++)
             {
-                entry.m_region = node->getMBR();
-                break;
+                m_idIndex[leaf->getEntry(i).m_id] = leaf;
             }
         }
+    }
 
-        // 如果有新节点，将其添加到父节点
-        if (newNode)
+    template <size_t D>
+    void RTree<D>::rebuildIdIndex()
+    {
+        m_idIndex.clear();
+        if (!m_idIndexEnabled)
         {
-            // 在父节点中增加新节点
-            InternalNode *internalParent = static_cast<InternalNode *>(parent);
-            internalParent->addChild(newNode, newNode->getMBR(), generateID());
-
-            // 检查父节点是否溢出
-            if (parent->isOverflow(m_maxEntries))
+            return;
+        }
+        m_idIndex.reserve(m_size);
+        std::vector<Node<D> *> stack;
+        stack.push_back(m_root);
+        while (!stack.empty())
+        {
+            Node<D> *node = stack.back();
+            stack.pop_back();
+            if (node->isLeaf())
+            {
+                indexLeaf(node);
+                continue;
+            }
+            for (size_t i = 0; i < node->getEntryCount(); i++)
             {
-                // 创建虚拟条目用于分裂
-                Entry dummyEntry; // 仅用于分裂函数接口
+                stack.push_back(node->getChild(i));
+            }
+        }
+    }
 
-                // 分裂父节点
-                Node *newParent = nullptr;
-                parent->split(dummyEntry, newParent, m_maxEntries);
+    template <size_t D>
+    RTree<D>::~RTree()
+    {
+        for (auto &retired : m_retired)
+        {
+            destroyNode(retired.second);
+        }
+        if (hasSnapshots())
+        {
+            // 快照仍在使用共享的节点和slab：只释放本树的引用，分配器由最后一个快照归还
+            destroySubtree(m_root);
+            return;
+        }
 
-                // 继续向上调整
-                adjustTree(parent, newParent);
-            }
-            else
+        // 固定维度下节点、条目数组和SoA边界都在slab块中，单线程模式下节点也没有同步状态：
+        // 不必遍历树，release()按slab一次性归还全部内存
+        if (std::is_trivially_destructible<Entry<D>>::value && m_concurrencyMode == ConcurrencyMode::None)
+        {
+            m_nodeAllocator->release();
+            return;
+        }
+
+        // 动态维度的坐标数组、并发模式的同步状态在堆上：逐个析构节点后再归还slab
+        std::vector<Node<D> *> stack;
+        if (m_root)
+        {
+            stack.push_back(m_root);
+        }
+        while (!stack.empty())
+        {
+            Node<D> *node = stack.back();
+            stack.pop_back();
+            if (!node->isLeaf())
             {
-                // 没有分裂，继续向上调整
-                adjustTree(parent);
+                for (size_t i = 0; i < node->getEntryCount(); i++)
+                {
+                    stack.push_back(node->getChild(i));
+                }
             }
+            node->~Node<D>();
         }
-        else
+        m_nodeAllocator->release();
+    }
+
+    template <size_t D>
+    size_t RTree<D>::entryOffset()
+    {
+        size_t nodeSize = std::max(sizeof(LeafNode<D>), sizeof(InternalNode<D>));
+        return (nodeSize + NodeAllocator::Alignment - 1) / NodeAllocator::Alignment * NodeAllocator::Alignment;
+    }
+
+    template <size_t D>
+    std::shared_ptr<NodeAllocator> RTree<D>::createNodeAllocator(size_t maxEntries)
+    {
+        auto allocator = std::make_shared<NodeAllocator>(entryOffset() + (maxEntries + 1) * sizeof(Entry<D>));
+        // 动态维度在构造时还不知道维度，SoA边界和量化编码只能借用已有的块或从堆分配；
+        // double与float两种边界数组、16位与8位两种编码各登记一种块大小
+        if (D != DynamicDimension)
         {
-            // 更新父节点的MBR
-            parent->updateMBR();
+            allocator->addSizeClass(NodeBounds<D>::storageBytes(maxEntries + 1, D));
+            allocator->addSizeClass(NodeBounds<D, float>::storageBytes(maxEntries + 1, D));
+            allocator->addSizeClass(QuantizedBounds<D>::storageBytes(maxEntries + 1, D, 16));
+            allocator->addSizeClass(QuantizedBounds<D>::storageBytes(maxEntries + 1, D, 8));
+        }
+        // 量化的内部节点没有条目数组，只占节点对象大小的块；最后登记，大小相同时其他存储优先选用前面的块
+        allocator->addSizeClass(entryOffset());
+        return allocator;
+    }
 
-            // 继续向上调整
-            adjustTree(parent);
+    template <size_t D>
+    Entry<D> *RTree<D>::entryStorage(void *block)
+    {
+        return reinterpret_cast<Entry<D> *>(static_cast<char *>(block) + entryOffset());
+    }
+
+    template <size_t D>
+    LeafNode<D> *RTree<D>::createLeafNode()
+    {
+        void *block = m_nodeAllocator->allocate();
+        typename Node<D>::Storage storage = {entryStorage(block), m_maxEntries + 1, m_nodeAllocator.get(), 0, 0};
+        LeafNode<D> *node = new (block) LeafNode<D>(this, storage);
+        if (m_concurrencyMode != ConcurrencyMode::None)
+        {
+            // 节点发布给其他线程之前分配同步状态
+            node->enableSync();
         }
+        return node;
     }
 
-    std::vector<void *> RTree::search(const Region &query) const
+    template <size_t D>
+    InternalNode<D> *RTree<D>::createInternalNode(size_t level)
     {
-        std::vector<void *> results;
+        // 量化布局的内部节点只存子节点指针和编码（另占一个块），节点本身取不带条目数组的小块
+        size_t codeBits = quantizedBits(m_nodeLayout);
+        size_t blockClass = codeBits ? compactNodeClass() : 0;
+        void *block = m_nodeAllocator->allocate(blockClass);
+        typename Node<D>::Storage storage = {codeBits ? nullptr : entryStorage(block), m_maxEntries + 1,
+                                             m_nodeAllocator.get(), blockClass, codeBits};
+        InternalNode<D> *node = new (block) InternalNode<D>(level, this, storage);
+        if (m_concurrencyMode != ConcurrencyMode::None)
+        {
+            // 节点发布给其他线程之前分配同步状态
+            node->enableSync();
+        }
+        return node;
+    }
 
-        // 如果根节点为空，返回空结果
-        if (!m_root)
+    template <size_t D>
+    void RTree<D>::destroyNode(Node<D> *node)
+    {
+        if (node)
         {
-            return results;
+            size_t blockClass = node->getBlockClass();
+            node->~Node<D>();
+            m_nodeAllocator->deallocate(node, blockClass);
         }
+    }
 
-        // 使用栈进行深度优先搜索
-        std::vector<Node *> stack;
-        stack.push_back(m_root.get());
+    template <size_t D>
+    void RTree<D>::destroySubtree(Node<D> *node)
+    {
+        Node<D>::releaseSubtree(node, *m_nodeAllocator, *m_sharedNodes);
+    }
 
-        while (!stack.empty())
+    template <size_t D>
+    std::shared_ptr<const Snapshot<D>> RTree<D>::snapshot()
+    {
+        if (m_concurrencyMode != ConcurrencyMode::None)
         {
-            Node *node = stack.back();
-            stack.pop_back();
+            throw std::logic_error("snapshots require ConcurrencyMode::None");
+        }
+        m_sharedNodes->addRef(m_root);
+        return std::make_shared<Snapshot<D>>(m_root, m_size, m_treeHeight,
+                                             m_nodeLayout == NodeLayout::StructOfArrays ||
+                                                 m_nodeLayout == NodeLayout::StructOfArraysFloat,
+                                             m_nodeAllocator, m_sharedNodes);
+    }
 
+    template <size_t D>
+    void RTree<D>::save(const std::string &path) const
+    {
+        size_t dimension = D != DynamicDimension ? D : m_root->getMBR().getDimension();
+        PageLayout layout(dimension, m_maxEntries);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("cannot open " + path + " for writing");
+        }
+
+        // 按层序编号：第0页为文件头，根为第1页，写出一个节点时它的子节点依次得到后续页号
+        std::vector<unsigned char> page(layout.getPageSize());
+        out.write(reinterpret_cast<const char *>(page.data()), static_cast<std::streamsize>(page.size()));
+        std::vector<const Node<D> *> order;
+        order.push_back(m_root);
+        uint64_t nextPage = 2;
+        size_t capacity = layout.getCapacity();
+        for (size_t n = 0; n < order.size(); n++)
+        {
+            const Node<D> *node = order[n];
+            if (node->getEntryCount() > capacity)
+            {
+                throw std::logic_error("node exceeds page capacity");
+            }
+
+            std::fill(page.begin(), page.end(), 0);
+            PageHeader *header = reinterpret_cast<PageHeader *>(page.data());
+            header->level = static_cast<uint32_t>(node->getLevel());
+            header->count = static_cast<uint32_t>(node->getEntryCount());
+            double *bounds = layout.bounds(page.data());
+            uint64_t *payload = layout.payload(page.data());
             for (size_t i = 0; i < node->getEntryCount(); i++)
             {
-                const Entry &entry = node->getEntry(i);
+                const Region<D> &region = node->isLeaf() ? node->getEntry(i).m_region : node->getChildMBR(i);
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    bounds[d * capacity + i] = region.m_low[d];
+                    bounds[(dimension + d) * capacity + i] = region.m_high[d];
+                }
+                if (node->isLeaf())
+                {
+                    payload[i] = node->getEntry(i).m_id;
+                }
+                else
+                {
+                    payload[i] = nextPage++;
+                    order.push_back(node->getChild(i));
+                }
+            }
+            out.write(reinterpret_cast<const char *>(page.data()), static_cast<std::streamsize>(page.size()));
+        }
+
+        // 最后回填文件头
+        FileHeader fileHeader;
+        std::memset(&fileHeader, 0, sizeof(fileHeader));
+        PageLayout::writeMagic(fileHeader.magic);
+        fileHeader.version = PageLayout::Version;
+        fileHeader.dimension = static_cast<uint32_t>(dimension);
+        fileHeader.pageSize = layout.getPageSize();
+        fileHeader.capacity = capacity;
+        fileHeader.pageCount = order.size() + 1;
+        fileHeader.rootPage = 1;
+        fileHeader.height = m_treeHeight;
+        fileHeader.size = m_size;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char *>(&fileHeader), sizeof(fileHeader));
+        if (!out.flush())
+        {
+            throw std::runtime_error("failed to write " + path);
+        }
+    }
+
+    template <size_t D>
+    void RTree<D>::load(const std::string &path, const std::function<void *(id_type)> &resolve)
+    {
+        if (m_concurrencyMode != ConcurrencyMode::None || m_insertMode != InsertMode::Guttman)
+        {
+            throw std::logic_error("load requires ConcurrencyMode::None and Guttman insert mode");
+        }
+        if (hasSnapshots())
+        {
+            throw std::logic_error("cannot load while snapshots exist");
+        }
+
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        FileHeader header;
+        in.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!in || !PageLayout::checkMagic(header.magic) || header.version != PageLayout::Version)
+        {
+            throw std::runtime_error("not an R-tree page file: " + path);
+        }
+        if (D != DynamicDimension && header.size > 0 && header.dimension != D)
+        {
+            throw std::runtime_error("page file dimension does not match the tree: " + path);
+        }
+        PageLayout layout(header.dimension, header.capacity);
+        if (layout.getPageSize() != header.pageSize || header.rootPage == 0 || header.rootPage >= header.pageCount)
+        {
+            throw std::runtime_error("corrupt page file: " + path);
+        }
+
+        // 按页号递归读入子树；出错时释放已建好的节点
+        std::vector<Node<D> *> created;
+        std::vector<unsigned char> page(layout.getPageSize());
+        size_t dimension = header.dimension;
+        size_t capacity = layout.getCapacity();
+        id_type maxID = 0;
+        std::function<Node<D> *(uint64_t, size_t)> readNode = [&](uint64_t pageId, size_t expectedLevel) -> Node<D> *
+        {
+            in.seekg(static_cast<std::streamoff>(pageId * header.pageSize));
+            in.read(reinterpret_cast<char *>(page.data()), static_cast<std::streamsize>(page.size()));
+            const PageHeader *pageHeader = reinterpret_cast<const PageHeader *>(page.data());
+            if (!in || pageHeader->level != expectedLevel || pageHeader->count > m_maxEntries)
+            {
+                throw std::runtime_error("corrupt page file or node larger than maxEntries: " + path);
+            }
 
-                // 检查该条目的MBR是否与查询区域相交
-                if (entry.m_region.intersectsRegion(query))
+            Node<D> *node = expectedLevel == 0 ? static_cast<Node<D> *>(createLeafNode())
+                                               : static_cast<Node<D> *>(createInternalNode(expectedLevel));
+            created.push_back(node);
+            std::vector<Entry<D>> entries(pageHeader->count);
+            const double *bounds = layout.bounds(page.data());
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                Region<D> &region = entries[i].m_region;
+                initCoords(region.m_low, dimension, 0.0);
+                initCoords(region.m_high, dimension, 0.0);
+                for (size_t d = 0; d < dimension; d++)
                 {
-                    if (node->isLeaf())
-                    {
-                        // 叶子节点：将数据添加到结果中
-                        results.push_back(entry.m_data);
-                    }
-                    else
+                    region.m_low[d] = bounds[d * capacity + i];
+                    region.m_high[d] = bounds[(dimension + d) * capacity + i];
+                }
+            }
+            // 子页会覆盖page，先复制出payload
+            std::vector<uint64_t> payload(layout.payload(page.data()), layout.payload(page.data()) + entries.size());
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                if (expectedLevel == 0)
+                {
+                    entries[i] = Entry<D>(entries[i].m_region, payload[i], resolve ? resolve(payload[i]) : nullptr, 0);
+                    maxID = std::max(maxID, static_cast<id_type>(payload[i]));
+                }
+                else
+                {
+                    if (payload[i] == 0 || payload[i] >= header.pageCount)
                     {
-                        // 内部节点：将子节点添加到栈中
-                        stack.push_back(entry.m_childNode);
+                        throw std::runtime_error("corrupt page file: " + path);
                     }
+                    Node<D> *child = readNode(payload[i], expectedLevel - 1);
+                    entries[i] = Entry<D>(entries[i].m_region, generateID(), child);
                 }
             }
+            node->setEntries(entries.data(), entries.size());
+            return node;
+        };
+
+        Node<D> *root = nullptr;
+        try
+        {
+            if (header.height == 0)
+            {
+                throw std::runtime_error("corrupt page file: " + path);
+            }
+            root = readNode(header.rootPage, header.height - 1);
+        }
+        catch (...)
+        {
+            for (Node<D> *node : created)
+            {
+                destroyNode(node);
+            }
+            throw;
         }
 
-        return results;
+        destroySubtree(m_root);
+        m_root = root;
+        m_size = header.size;
+        m_treeHeight = header.height;
+        id_type next = m_nextID.load();
+        while (next <= maxID && !m_nextID.compare_exchange_weak(next, maxID + 1))
+        {
+        }
+        rebuildIdIndex();
     }
 
-    Node *RTree::findLeaf(Node *node, id_type id, const Region &mbr) const
+    template <size_t D>
+    Node<D> *RTree<D>::cloneNode(const Node<D> *node)
     {
-        if (!node)
-            return nullptr;
+        Node<D> *copy = nullptr;
+        if (node->isLeaf())
+        {
+            copy = createLeafNode();
+        }
+        else
+        {
+            copy = createInternalNode(node->getLevel());
+        }
 
-        // 递归查找
-        return node->findLeaf(id, mbr);
+        std::vector<Entry<D>> entries;
+        entries.reserve(node->getEntryCount());
+        for (size_t i = 0; i < node->getEntryCount(); i++)
+        {
+            entries.push_back(node->copyEntry(i));
+            if (!node->isLeaf())
+            {
+                // 子节点同时被原节点和副本引用；父指针改指副本（快照的查询不使用父指针）
+                m_sharedNodes->addRef(entries.back().m_childNode);
+            }
+        }
+        copy->setEntries(entries.data(), entries.size());
+        if (copy->isLeaf())
+        {
+            indexLeaf(copy);
+        }
+        return copy;
     }
 
-    bool RTree::remove(id_type id, const Region &mbr)
+    template <size_t D>
+    Node<D> *RTree<D>::unshareChild(Node<D> *parent, size_t index)
     {
-        // 找到包含该条目的叶子节点
-        Node *leaf = findLeaf(m_root.get(), id, mbr);
-        if (!leaf || !leaf->isLeaf())
+        Node<D> *child = parent->getChild(index);
+        // 父节点只属于本树时，子节点未被共享即说明没有快照能到达它
+        if (!m_sharedNodes->isShared(child))
         {
-            return false; // 未找到
+            return child;
         }
+        Node<D> *copy = cloneNode(child);
+        parent->setEntryChild(index, copy);
+        copy->setParent(parent);
+        destroySubtree(child);
+        return copy;
+    }
 
-        // 找到叶子节点中的条目索引
-        int entryIndex = leaf->findEntry(id);
-        if (entryIndex < 0)
+    template <size_t D>
+    Node<D> *RTree<D>::unsharePath(Node<D> *node)
+    {
+        // 沿父指针记录路径（本树的父指针总是正确的），再自上而下替换被共享的节点
+        std::vector<Node<D> *> path;
+        for (Node<D> *current = node; current != m_root; current = current->getParent())
         {
-            return false; // 未找到
+            path.push_back(current);
         }
 
-        // 移除条目
-        leaf->removeEntry(entryIndex);
-        m_size--;
-
-        // 处理下溢（如果需要）
-        if (leaf != m_root.get() && leaf->isUnderflow(m_minEntries))
+        if (m_sharedNodes->isShared(m_root))
         {
-            // 简化版本：不处理下溢，只更新MBR
-            // 完整实现应该处理节点合并或重新分配
+            Node<D> *copy = cloneNode(m_root);
+            destroySubtree(m_root);
+            m_root = copy;
         }
-
-        // 向上更新MBR
-        Node *current = leaf;
-        while (current != m_root.get())
+        Node<D> *parent = m_root;
+        while (!path.empty())
         {
-            Node *parent = current->getParent();
-            parent->updateMBR();
-            current = parent;
+            parent = unshareChild(parent, parent->findChild(path.back()));
+            path.pop_back();
         }
-
-        return true;
+        return parent;
     }
 
-    void RTree::printStats() const
+    template <size_t D>
+    void RTree<D>::printStats() const
     {
         std::cout << "R-Tree Statistics:" << std::endl;
-        std::cout << "  Height: " << m_treeHeight << std::endl;
-        std::cout << "  Size: " << m_size << " items" << std::endl;
+        std::cout << "  Height: " << m_treeHeight.load() << std::endl;
+        std::cout << "  Size: " << m_size.load() << " items" << std::endl;
         std::cout << "  Max Entries: " << m_maxEntries << std::endl;
         std::cout << "  Min Entries: " << m_minEntries << std::endl;
         std::cout << "  Split Strategy: " << m_splitStrategy->getName() << std::endl;
+        const char *insertModeName = "Guttman";
+        if (m_insertMode == InsertMode::Hilbert)
+            insertModeName = "Hilbert";
+        else if (m_insertMode == InsertMode::RStar)
+            insertModeName = "R*";
+        std::cout << "  Insert Mode: " << insertModeName << std::endl;
+        const char *layoutName = "Entries";
+        if (m_nodeLayout == NodeLayout::StructOfArrays)
+            layoutName = "StructOfArrays";
+        else if (m_nodeLayout == NodeLayout::StructOfArraysFloat)
+            layoutName = "StructOfArraysFloat";
+        else if (m_nodeLayout == NodeLayout::Quantized16)
+            layoutName = "Quantized16";
+        else if (m_nodeLayout == NodeLayout::Quantized8)
+            layoutName = "Quantized8";
+        std::cout << "  Node Layout: " << layoutName << std::endl;
+        std::cout << "  SIMD Kernel: " << getSimdLevelName(getSimdLevel()) << std::endl;
+        // 按块大小统计：动态维度的SoA边界和量化编码借用节点块或小块，计入前两项
+        size_t compactClass = compactNodeClass();
+        size_t boundsBlocks = 0;
+        size_t liveBytes = 0;
+        for (size_t i = 0; i < m_nodeAllocator->getSizeClassCount(); i++)
+        {
+            if (i != 0 && i != compactClass)
+            {
+                boundsBlocks += m_nodeAllocator->getLiveBlocks(i);
+            }
+            liveBytes += m_nodeAllocator->getLiveBlocks(i) * m_nodeAllocator->getBlockSize(i);
+        }
+        std::cout << "  Node Allocator: " << m_nodeAllocator->getLiveBlocks() << " node blocks of "
+                  << m_nodeAllocator->getBlockSize() << " bytes, " << m_nodeAllocator->getLiveBlocks(compactClass)
+                  << " compact blocks of " << m_nodeAllocator->getBlockSize(compactClass) << " bytes, "
+                  << boundsBlocks << " bounds/code blocks; " << liveBytes / 1024 << " KB in "
+                  << m_nodeAllocator->getSlabCount() << " slabs ("
+                  << m_nodeAllocator->getHugePageSlabs() << " huge-page)" << std::endl;
     }
 
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class RTree<DynamicDimension>;
+    template class RTree<2>;
+    template class RTree<3>;
+
 } // namespace RTree
@@ -8,101 +8,531 @@
 #include <limits>
 #include <string>
 #include <queue>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
+#include <unordered_map>
+#include <type_traits>
 #include "Point.h"
 #include "Region.h"
 #include "Entry.h"
 #include "SplitStrategy.h"
 #include "Node.h"
+#include "NearestIterator.h"
+#include "BulkLoader.h"
+#include "HilbertCurve.h"
+#include "ThreadPool.h"
+#include "NodeAllocator.h"
+#include "SharedNodeTable.h"
+#include "OptimisticLock.h"
+#include "EpochManager.h"
+#include "Snapshot.h"
 
 namespace RTree
 {
 
     // 前向声明
-    class Node;
-    class Entry;
-    class Point;
-    class Region;
+    template <size_t D>
     class RTree;
-    class SplitStrategy;
-    class LeafNode;
-    class InternalNode;
 
-    typedef std::unique_ptr<Node> NodePtr;
-    typedef size_t id_type;
-
-    // 距离条目 - 用于最近邻查询
-    struct DistanceEntry
+    // 动态插入模式
+    enum class InsertMode
     {
-        double distance;
-        void *data;
-
-        DistanceEntry(double dist, void *d) : distance(dist), data(d) {}
+        Guttman, // 最小面积扩展选择子树，溢出时使用SplitStrategy分裂
+        Hilbert, // Hilbert R-tree：按最大Hilbert值(LHV)选择子树，溢出时与兄弟协作做2-to-3分裂
+        RStar    // R*-tree：叶子的父层按最小重叠扩展选择子树，每层第一次溢出时先强制重插再分裂
+    };
 
-        bool operator<(const DistanceEntry &other) const
-        {
-            return distance > other.distance; // 使用小顶堆
-        }
+    // 并发模式
+    enum class ConcurrencyMode
+    {
+        None, // 单线程使用，不加锁
+        RLink,     // R-link树：节点锁 + 右链 + NSN，insert与search/visit/count/exists可以并发执行
+        Optimistic // 乐观锁耦合：节点版本号 + epoch回收，insert/remove与search/visit/count/exists可以并发执行
     };
+    typedef size_t id_type;
 
     // R-tree主类
+    // D为编译期维度；D == DynamicDimension 时维度由插入的数据决定
+    template <size_t D = DynamicDimension>
     class RTree
     {
     private:
-        std::unique_ptr<Node> m_root; // 根节点
-        size_t m_size;                // 数据项数量
+        std::shared_ptr<NodeAllocator> m_nodeAllocator; // 节点的slab分配器，树与其快照共同持有
+        std::shared_ptr<SharedNodeTable> m_sharedNodes; // 被快照共享节点的引用计数，树与其快照共同持有
+        Node<D> *m_root;              // 根节点
+        std::atomic<size_t> m_size;   // 数据项数量
         size_t m_maxEntries;          // 节点最大条目数
         size_t m_minEntries;          // 节点最小条目数
-        size_t m_treeHeight;          // 树高度
-        id_type m_nextID;             // 下一个可用ID
+        std::atomic<size_t> m_treeHeight; // 树高度
+        std::atomic<id_type> m_nextID; // 下一个可用ID（并行装载时多线程分配）
+        NodeLayout m_nodeLayout;      // 节点存储模式
+        InsertMode m_insertMode;      // 插入模式
+        HilbertCurve<D> m_hilbertCurve; // Hilbert模式使用的曲线
+        ConcurrencyMode m_concurrencyMode;     // 并发模式
+        std::atomic<uint64_t> m_globalNSN;     // R-link模式的全局NSN计数器
+        mutable std::shared_timed_mutex m_rootLatch; // 保护根指针的读取与替换
+        mutable OptimisticLock m_rootVersion;        // 乐观模式下保护根指针的版本锁
+        std::mutex m_retiredMutex;
+        std::vector<std::pair<uint64_t, Node<D> *>> m_retired; // 乐观模式下等待回收的节点（摘除时的epoch, 节点）
+        bool m_idIndexEnabled;                                  // 是否维护ID索引
+        std::unordered_map<id_type, Node<D> *> m_idIndex;       // 数据ID -> 所在叶子
 
         // 调整树方法 (插入后平衡)
-        void adjustTree(Node *node, Node *newNode = nullptr);
+        void adjustTree(Node<D> *node, Node<D> *newNode = nullptr);
 
         // 生成唯一ID
         id_type generateID() { return m_nextID++; }
 
-        std::shared_ptr<SplitStrategy> m_splitStrategy;
+        // 节点块的布局：节点对象（按cache line取整）之后是maxEntries + 1个条目的数组；
+        // SoA边界和量化编码另占同一分配器中按其实际大小登记的块，量化的内部节点只占节点对象大小的块
+        static size_t entryOffset();
+        static std::shared_ptr<NodeAllocator> createNodeAllocator(size_t maxEntries);
+        static Entry<D> *entryStorage(void *block);
+        // 量化的内部节点所用块大小的编号（createNodeAllocator最后登记）
+        size_t compactNodeClass() const { return m_nodeAllocator->getSizeClassCount() - 1; }
+        // 按当前布局重建node下的全部内部节点（叶子保留），返回新的子树根
+        Node<D> *relayoutInternalNodes(Node<D> *node);
+
+        std::shared_ptr<SplitStrategy<D>> m_splitStrategy;
+
+        // Hilbert模式插入
+        void insertHilbert(const Entry<D> &entry);
+        void insertHilbertEntry(Node<D> *node, const Entry<D> &entry);
+        void updateHilbertEntry(Node<D> *parent, Node<D> *child);
+        void propagateHilbert(Node<D> *node);
+        // 确保曲线存在，且mbr的中心在曲线范围内（否则扩大范围并重新打包）
+        void ensureHilbertCurve(const Region<D> &mbr);
+        // required超出曲线范围时扩大范围，返回曲线是否被替换（已有条目的Hilbert值随之失效）
+        bool widenHilbertCurve(const Region<D> &required);
+
+        // R*模式插入：entry放入level层的节点（数据条目为0层）。reinserted记录本次插入中
+        // 已经做过强制重插的层，同一层第二次溢出时直接分裂
+        void insertRStar(const Entry<D> &entry, size_t level, std::vector<bool> &reinserted);
+        Node<D> *chooseNodeRStar(const Region<D> &mbr, size_t level) const;
+        // node（已可修改）放不下entry时的溢出处理：强制重插或分裂，并向上调整
+        void overflowRStar(Node<D> *node, const Entry<D> &entry, std::vector<bool> &reinserted);
+        // 取出node与entry中离节点中心最远的30%，调整树后按由近到远的顺序重新插入
+        void reinsertRStar(Node<D> *node, const Entry<D> &entry, std::vector<bool> &reinserted);
+
+        // R-link模式插入：自顶向下每次只持有一个共享锁选择叶子，分裂和MBR调整自底向上
+        // 持有子节点写锁再锁父节点（锁总是按层级从低到高获取，不会死锁）
+        void insertRLink(const Entry<D> &entry);
+        // 锁住node的父节点并返回；node是根节点时返回nullptr并持有rootLock。
+        // path为下降时经过的内部节点，父节点分裂过时沿右链向右查找
+        Node<D> *lockParent(Node<D> *node, std::vector<Node<D> *> &path,
+                            std::unique_lock<std::shared_timed_mutex> &rootLock);
+
+        // 乐观模式：写者乐观下降，只对要修改的节点加写锁；版本冲突时从根重新开始。
+        // 插入时满节点在下降途中先分裂（同时锁住父节点），因此任何时刻最多持有两个写锁
+        void insertOptimistic(const Entry<D> &entry);
+        bool tryInsertOptimistic(const Entry<D> &entry);
+        void splitOptimistic(Node<D> *node, Node<D> *parent);
+        bool removeOptimistic(id_type id, const Region<D> &mbr);
+        int tryRemoveOptimistic(id_type id, const Region<D> &mbr); // -1 冲突重试，0 未找到，1 已删除
+        // 被删空的节点在epoch回收后才真正释放
+        void retireNode(Node<D> *node);
+
+        // 按策略把数据条目逐层打包成树（替换当前根）
+        void bulkLoadEntries(std::vector<Entry<D>> &entries, BulkLoadStrategy<D> &strategy);
+        void bulkLoadEntriesParallel(std::vector<Entry<D>> &entries, BulkLoadStrategy<D> &strategy, ThreadPool &pool);
+        void collectDataEntries(std::vector<Entry<D>> &entries) const;
+        BulkLoadStrategy<D> *choosePacker(const std::vector<Entry<D>> &entries,
+                                          BulkLoadStrategy<D> &strategy,
+                                          HilbertBulkLoadStrategy<D> &hilbertStrategy);
+        // 从height层开始逐层打包，到stopHeight层（或只剩一个节点）为止，返回最上层节点的父条目
+        std::vector<Entry<D>> packLevels(std::vector<Entry<D>> level, BulkLoadStrategy<D> &strategy,
+                                         size_t height, size_t stopHeight);
+        void installRoot(const Entry<D> &top);
+
+        // 范围查询遍历使用的临时空间：每个线程一份，跨调用复用以避免分配。
+        // 回调中再次查询本树（重入）时改用局部空间
+        struct TraversalScratch
+        {
+            std::vector<Node<D> *> stack;
+            HitMask mask;
+            std::vector<std::pair<const Node<D> *, uint64_t>> linkStack; // R-link遍历：(节点, 读取父节点时的NSN)；乐观遍历：(节点, 版本号)
+            std::vector<void *> hits;                                  // R-link/乐观遍历：复制出来的命中数据
+            bool inUse = false;
+        };
+
+        struct ScratchGuard
+        {
+            TraversalScratch &scratch;
+            ~ScratchGuard()
+            {
+                scratch.stack.clear();
+                scratch.linkStack.clear();
+                scratch.inUse = false;
+            }
+        };
+
+        static TraversalScratch &threadScratch()
+        {
+            static thread_local TraversalScratch scratch;
+            return scratch;
+        }
+
+        // 深度优先遍历与query相交的子树，对每个叶子调用onLeaf(leaf, mask)，
+        // mask为叶子条目的相交位图；onLeaf返回false时停止遍历
+        template <class LeafVisitor>
+        void traverse(const Region<D> &query, LeafVisitor onLeaf) const
+        {
+            TraversalScratch local;
+            TraversalScratch &shared = threadScratch();
+            TraversalScratch &scratch = shared.inUse ? local : shared;
+            scratch.inUse = true;
+            ScratchGuard guard = {scratch};
+
+            if (!m_root)
+            {
+                return;
+            }
+
+            std::vector<Node<D> *> &stack = scratch.stack;
+            HitMask &mask = scratch.mask;
+            stack.push_back(m_root);
+            while (!stack.empty())
+            {
+                const Node<D> *node = stack.back();
+                stack.pop_back();
+                node->intersectMask(query, mask);
+                if (node->isLeaf())
+                {
+                    if (!onLeaf(node, mask))
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    mask.forEach([&](size_t i)
+                                 { stack.push_back(static_cast<Node<D> *>(node->getPayload(i))); });
+                }
+            }
+        }
+
+        // R-link模式的范围遍历：每次只持有一个节点的共享锁，从不等待分裂向上传播完成。
+        // 节点的NSN大于读取其父节点时记下的全局计数器值，说明之后发生过分裂，沿右链补上右兄弟。
+        // 叶子的命中数据先复制出来，释放锁之后再调用visitor（visitor中可以再插入）
+        template <class Visitor>
+        size_t visitRLink(const Region<D> &query, Visitor visitor) const
+        {
+            TraversalScratch local;
+            TraversalScratch &shared = threadScratch();
+            TraversalScratch &scratch = shared.inUse ? local : shared;
+            scratch.inUse = true;
+            ScratchGuard guard = {scratch};
+
+            std::vector<std::pair<const Node<D> *, uint64_t>> &stack = scratch.linkStack;
+            std::vector<void *> &hits = scratch.hits;
+            HitMask &mask = scratch.mask;
+            {
+                std::shared_lock<std::shared_timed_mutex> rootLock(m_rootLatch);
+                stack.push_back(std::make_pair(static_cast<const Node<D> *>(m_root), m_globalNSN.load()));
+            }
+
+            size_t visited = 0;
+            while (!stack.empty())
+            {
+                std::pair<const Node<D> *, uint64_t> frame = stack.back();
+                stack.pop_back();
+                const Node<D> *node = frame.first;
+                hits.clear();
+                {
+                    std::shared_lock<std::shared_timed_mutex> lock(node->getLatch());
+                    if (node->getNSN() > frame.second)
+                    {
+                        stack.push_back(std::make_pair(static_cast<const Node<D> *>(node->getRightLink()), frame.second));
+                    }
+
+                    node->intersectMask(query, mask);
+                    if (node->isLeaf())
+                    {
+                        mask.forEach([&](size_t i)
+                                     { hits.push_back(node->getPayload(i)); });
+                    }
+                    else
+                    {
+                        uint64_t nsn = m_globalNSN.load();
+                        mask.forEach([&](size_t i)
+                                     { stack.push_back(std::make_pair(static_cast<const Node<D> *>(node->getPayload(i)), nsn)); });
+                    }
+                }
+
+                for (void *data : hits)
+                {
+                    visited++;
+                    if (!visitor(data))
+                    {
+                        return visited;
+                    }
+                }
+            }
+            return visited;
+        }
+
+        // 乐观模式的范围遍历：读者不加锁、不写共享内存。读取节点内容后确认版本号未变，
+        // 子节点的版本号在父节点版本有效时读取，之后子节点若被修改（如分裂）则整个查询重来。
+        // 结果收集到scratch.hits；返回false表示发生冲突需要重试
+        bool scanOptimistic(const Region<D> &query, TraversalScratch &scratch, bool stopAtFirst) const;
+
+        template <class Visitor>
+        size_t visitOptimistic(const Region<D> &query, Visitor visitor) const
+        {
+            TraversalScratch local;
+            TraversalScratch &shared = threadScratch();
+            TraversalScratch &scratch = shared.inUse ? local : shared;
+            scratch.inUse = true;
+            ScratchGuard guard = {scratch};
+            {
+                EpochGuard epoch;
+                while (!scanOptimistic(query, scratch, false))
+                {
+                }
+            }
+
+            // 结果已经验证并复制出来，在临界区外调用visitor
+            size_t visited = 0;
+            for (void *data : scratch.hits)
+            {
+                visited++;
+                if (!visitor(data))
+                {
+                    break;
+                }
+            }
+            return visited;
+        }
+
+        // 释放node及其子孙节点的一个引用，不再被快照共享的节点放回空闲链表
+        void destroySubtree(Node<D> *node);
+
+        // 写时复制：修改node之前调用，把从根到node的路径上被快照共享的节点换成副本，返回可修改的node
+        Node<D> *unsharePath(Node<D> *node);
+        // parent已可修改时，保证其第index个子节点也可修改
+        Node<D> *unshareChild(Node<D> *parent, size_t index);
+        Node<D> *cloneNode(const Node<D> *node);
+        // 是否还有快照存在（快照持有分配器的引用）
+        bool hasSnapshots() const { return m_nodeAllocator.use_count() > 1; }
 
         // 查找包含特定ID和MBR的叶子节点
-        Node *findLeaf(Node *node, id_type id, const Region &mbr) const;
+        Node<D> *findLeaf(Node<D> *node, id_type id, const Region<D> &mbr) const;
+
+        // 从叶子中删除条目（不处理下溢），返回被修改的叶子；未找到返回nullptr。
+        // 开启ID索引时直接按ID定位叶子，mbr不再使用（可以为nullptr）
+        Node<D> *removeFromLeaf(id_type id, const Region<D> *mbr);
+        // 把leaf中所有数据条目登记到ID索引（条目整体搬入叶子后调用）
+        void indexLeaf(Node<D> *leaf);
+        void rebuildIdIndex();
+        // CondenseTree：从被修改的节点向上，摘除下溢的节点并收集其条目，收紧其余祖先的MBR，
+        // 把孤儿条目插回原来的层级，最后根节点只剩一个子节点时降低树高
+        void condenseTree(std::vector<Node<D> *> dirty);
+        void reinsertOrphan(const Entry<D> &entry, size_t level);
+        // 自底向上把node缩小后的MBR写回父条目，父条目不再变化时停止
+        void tightenPath(Node<D> *node);
 
     public:
         // 构造函数
         RTree(size_t maxEntries = 8,
-              std::shared_ptr<SplitStrategy> strategy = std::make_shared<QuadraticSplitStrategy>())
-            : m_size(0), m_maxEntries(maxEntries),
+              std::shared_ptr<SplitStrategy<D>> strategy = std::make_shared<QuadraticSplitStrategy<D>>(),
+              NodeLayout layout = NodeLayout::Entries)
+            : m_nodeAllocator(createNodeAllocator(maxEntries)),
+              m_sharedNodes(std::make_shared<SharedNodeTable>()),
+              m_root(nullptr), m_size(0), m_maxEntries(maxEntries),
               m_minEntries(maxEntries / 2), m_treeHeight(1), m_nextID(1),
-              m_splitStrategy(strategy)
+              m_nodeLayout(layout), m_insertMode(InsertMode::Guttman),
+              m_concurrencyMode(ConcurrencyMode::None), m_globalNSN(0), m_idIndexEnabled(false), m_splitStrategy(strategy)
         {
             // 创建根节点
-            m_root = std::unique_ptr<Node>(new LeafNode(this));
+            m_root = createLeafNode();
         }
 
-        // 析构函数
-        ~RTree() {}
+        // 析构函数：节点内存随slab整体归还（只有动态维度或并发模式下才逐个析构节点）
+        ~RTree();
+
+        RTree(const RTree &) = delete;
+        RTree &operator=(const RTree &) = delete;
 
         // 基本信息访问
         size_t getSize() const { return m_size; }
         size_t getHeight() const { return m_treeHeight; }
         size_t getMaxEntries() const { return m_maxEntries; }
         size_t getMinEntries() const { return m_minEntries; }
-        Node *getRoot() const { return m_root.get(); }
+        Node<D> *getRoot() const { return m_root; }
 
         // 分裂策略访问和修改
-        std::shared_ptr<SplitStrategy> getSplitStrategy() const { return m_splitStrategy; }
-        void setSplitStrategy(std::shared_ptr<SplitStrategy> strategy)
+        std::shared_ptr<SplitStrategy<D>> getSplitStrategy() const { return m_splitStrategy; }
+        void setSplitStrategy(std::shared_ptr<SplitStrategy<D>> strategy)
         {
             m_splitStrategy = strategy;
         }
 
-        // 插入数据
-        void insert(void *data, size_t dataSize, const Region &mbr);
+        // 节点存储模式访问和修改（切换时重建所有节点的SoA/float边界；进入或离开量化布局时重建全部内部节点）。
+        // 量化布局只支持ConcurrencyMode::None，且不能与Hilbert插入模式同时使用
+        NodeLayout getNodeLayout() const { return m_nodeLayout; }
+        void setNodeLayout(NodeLayout layout);
+
+        // 插入模式访问和修改；非空树切换到Hilbert模式时按Hilbert顺序重新打包。
+        // R*模式通常与RStarSplitStrategy一起使用（分裂策略不会自动切换）
+        InsertMode getInsertMode() const { return m_insertMode; }
+        void setInsertMode(InsertMode mode);
+
+        // 并发模式；切换时不能有其他线程正在操作本树。两种并发模式都要求Guttman插入模式，
+        // 乐观模式还要求double SoA布局（读者只读取预留好空间的边界数组），启用时自动切换为StructOfArrays，
+        // 乐观模式下不能再切换到其他布局。
+        // R-link模式下insert与search/visit/count/exists可以在多个线程中同时调用，
+        // 乐观模式下remove也可以并发调用；nearest、searchBatch、批量装载等仍需与写操作互斥
+        ConcurrencyMode getConcurrencyMode() const { return m_concurrencyMode; }
+        void setConcurrencyMode(ConcurrencyMode mode);
+
+        // Hilbert模式的曲线（决定数据空间范围）；未设置时取切换模式或首次插入时树的MBR。
+        // 之后插入或批量装载的数据超出范围时范围会成倍扩大，树按新曲线重新打包
+        const HilbertCurve<D> &getHilbertCurve() const { return m_hilbertCurve; }
+        void setHilbertCurve(const HilbertCurve<D> &curve) { m_hilbertCurve = curve; }
+
+        // 节点的创建与销毁都经过树的slab分配器（分裂时由节点调用）
+        LeafNode<D> *createLeafNode();
+        InternalNode<D> *createInternalNode(size_t level);
+        void destroyNode(Node<D> *node);
+
+        // 节点分配器：可选用大页作为slab（只影响之后申请的slab）
+        const NodeAllocator &getNodeAllocator() const { return *m_nodeAllocator; }
+        void setHugePages(bool enable) { m_nodeAllocator->setHugePages(enable); }
+
+        // 创建只读快照：O(1)，之后的写操作只复制被修改的路径，不会阻塞也不会影响快照上的查询。
+        // 需在修改本树的线程上调用，且仅支持ConcurrencyMode::None；快照存在期间不能切换节点布局或并发模式
+        std::shared_ptr<const Snapshot<D>> snapshot();
+
+        // 按定长页格式（见PageFormat.h）写出整棵树，之后可用MappedRTree直接映射查询。
+        // 叶子页保存数据条目的ID而不是数据指针；写出期间不能修改本树。文件无法写入时抛出std::runtime_error
+        void save(const std::string &path) const;
+
+        // 读入save()写出的页文件，替换树中的全部内容。文件中只有数据条目的ID，
+        // resolve(id)给出对应的数据指针（为空时数据指针都是nullptr）；节点条目数不能超过maxEntries。
+        // 仅支持ConcurrencyMode::None与Guttman插入模式；文件无法读取或格式不符时抛出std::runtime_error
+        void load(const std::string &path, const std::function<void *(id_type)> &resolve = nullptr);
+
+        // ID索引：维护数据ID到所在叶子的哈希表，insert、分裂、重插与写时复制都会更新它。
+        // 开启后remove按ID直接定位叶子，不再搜索MBR相交的子树；每个数据多占一个哈希表项。
+        // 仅支持ConcurrencyMode::None，开启时为已有数据建立索引
+        bool hasIdIndex() const { return m_idIndexEnabled; }
+        void setIdIndex(bool enable);
+        // 叶子节点加入数据条目时调用；未开启ID索引时什么也不做
+        void updateIdIndex(id_type id, Node<D> *leaf)
+        {
+            if (m_idIndexEnabled)
+            {
+                m_idIndex[id] = leaf;
+            }
+        }
+
+        // 插入数据，返回生成的ID（remove/update使用）
+        id_type insert(void *data, size_t dataSize, const Region<D> &mbr);
+        // 以指定ID插入（如重放日志时恢复原有ID），之后生成的ID都大于id；调用者保证ID不重复
+        void insert(id_type id, void *data, size_t dataSize, const Region<D> &mbr);
+
+        // 批量装载：[first, last) 的元素为 std::pair<Region<D>, void *>（MBR, 数据）。
+        // 树中已有的数据会与新数据一起重新打包；默认使用STR，Hilbert模式下总是按Hilbert顺序打包
+        template <class Iter>
+        void bulkLoad(Iter first, Iter last,
+                      std::shared_ptr<BulkLoadStrategy<D>> strategy = std::make_shared<STRBulkLoadStrategy<D>>())
+        {
+            std::vector<Entry<D>> entries;
+            entries.reserve(std::distance(first, last));
+            for (Iter it = first; it != last; ++it)
+            {
+                entries.push_back(Entry<D>(it->first, generateID(), it->second, 0));
+            }
+            bulkLoadEntries(entries, *strategy);
+        }
+
+        template <class Range>
+        void bulkLoad(const Range &items,
+                      std::shared_ptr<BulkLoadStrategy<D>> strategy = std::make_shared<STRBulkLoadStrategy<D>>())
+        {
+            bulkLoad(std::begin(items), std::end(items), strategy);
+        }
+
+        // 并行批量装载：在pool上并行排序划分输入、各分区独立建子树，最后拼接上层。
+        // 结果与普通树相同，search/remove等操作照常使用
+        template <class Iter>
+        void bulkLoadParallel(Iter first, Iter last, ThreadPool &pool,
+                              std::shared_ptr<BulkLoadStrategy<D>> strategy = std::make_shared<STRBulkLoadStrategy<D>>())
+        {
+            std::vector<Entry<D>> entries;
+            entries.reserve(std::distance(first, last));
+            for (Iter it = first; it != last; ++it)
+            {
+                entries.push_back(Entry<D>(it->first, generateID(), it->second, 0));
+            }
+            bulkLoadEntriesParallel(entries, *strategy, pool);
+        }
+
+        template <class Range>
+        void bulkLoadParallel(const Range &items, ThreadPool &pool,
+                              std::shared_ptr<BulkLoadStrategy<D>> strategy = std::make_shared<STRBulkLoadStrategy<D>>())
+        {
+            bulkLoadParallel(std::begin(items), std::end(items), pool, strategy);
+        }
 
         // 搜索操作
-        std::vector<void *> search(const Region &query) const;
+        std::vector<void *> search(const Region<D> &query) const;
+
+        // 批量查询：整批查询只遍历一次树，每个节点上检测所有仍活跃的查询并把命中的查询下传给子节点。
+        // 返回值与queries一一对应，每个结果集合与search相同（顺序可能不同）
+        std::vector<std::vector<void *>> searchBatch(const std::vector<Region<D>> &queries) const;
+
+        // 访问者查询：对每个与query相交的数据调用visitor(void *data)，visitor返回false时立即停止。
+        // 不构造结果数组，返回调用visitor的次数
+        template <class Visitor>
+        size_t visit(const Region<D> &query, Visitor visitor) const
+        {
+            if (m_concurrencyMode == ConcurrencyMode::RLink)
+            {
+                return visitRLink(query, visitor);
+            }
+            if (m_concurrencyMode == ConcurrencyMode::Optimistic)
+            {
+                return visitOptimistic(query, visitor);
+            }
+
+            size_t visited = 0;
+            traverse(query, [&](const Node<D> *leaf, const HitMask &mask)
+                     { return mask.forEachWhile([&](size_t i)
+                                                {
+                                                    visited++;
+                                                    return visitor(leaf->getPayload(i)); }); });
+            return visited;
+        }
+
+        // 只统计与query相交的数据个数（叶子上直接数命中位）
+        size_t count(const Region<D> &query) const;
+
+        // 是否存在与query相交的数据（找到第一个即返回）
+        bool exists(const Region<D> &query) const;
+
+        // 最近邻查询：返回距离point最近的k个数据（按距离升序）
+        std::vector<DistanceEntry> nearest(const Point<D> &point, size_t k) const;
+
+        // 增量最近邻：逐个取出下一个最近的数据，树被修改后失效
+        NearestIterator<D> nearestIterator(const Point<D> &point) const
+        {
+            return NearestIterator<D>(m_root, point);
+        }
+
+        // 删除操作：下溢的节点被摘除，其条目重新插入，根节点只剩一个子节点时树高降低
+        bool remove(id_type id, const Region<D> &mbr);
+        // 按ID删除，不需要MBR：沿ID索引找到叶子，代价与树高成正比。未开启ID索引时抛出std::logic_error
+        bool remove(id_type id);
+        // 移动数据：自底向上修改ID为id的条目的MBR。新MBR仍在叶子的MBR内时原地修改；否则移入同一父节点下
+        // 能容纳它且未满的兄弟叶子（原叶子不能因此下溢）；都不行时才删除后从根重新插入（Hilbert模式总是如此）。
+        // 需要开启ID索引（否则抛出std::logic_error），未找到时返回false
+        bool update(id_type id, const Region<D> &mbr);
 
-        // 删除操作
-        bool remove(id_type id, const Region &mbr);
+        // 批量删除：[id, MBR]逐个从叶子中删除后只做一次CondenseTree，返回删除的条目数
+        size_t removeBatch(const std::vector<std::pair<id_type, Region<D>>> &items);
 
         // 统计信息
         void printStats() const;
@@ -6,7 +6,8 @@
 namespace RTree
 {
 
-    Region::Region(const Point &low, const Point &high)
+    template <size_t D>
+    Region<D>::Region(const Point<D> &low, const Point<D> &high)
     {
         if (low.getDimension() != high.getDimension())
         {
@@ -17,15 +18,17 @@ namespace RTree
         m_high = high.m_coords;
     }
 
-    Region::Region(const Point &p)
+    template <size_t D>
+    Region<D>::Region(const Point<D> &p)
     {
         m_low = p.m_coords;
         m_high = p.m_coords;
     }
 
-    double Region::getArea() const
+    template <size_t D>
+    double Region<D>::getArea() const
     {
-        if (m_low.empty())
+        if (isEmpty())
             return 0.0;
 
         double area = 1.0;
@@ -36,7 +39,8 @@ namespace RTree
         return area;
     }
 
-    bool Region::containsPoint(const Point &p) const
+    template <size_t D>
+    bool Region<D>::containsPoint(const Point<D> &p) const
     {
         if (m_low.size() != p.getDimension())
             return false;
@@ -51,7 +55,8 @@ namespace RTree
         return true;
     }
 
-    bool Region::containsRegion(const Region &r) const
+    template <size_t D>
+    bool Region<D>::containsRegion(const Region &r) const
     {
         if (m_low.size() != r.getDimension())
             return false;
@@ -66,8 +71,10 @@ namespace RTree
         return true;
     }
 
-    bool Region::intersectsRegion(const Region &r) const
+    template <size_t D>
+    bool Region<D>::intersectsRegion(const Region &r) const
     {
+        // 固定维度下该比较在编译期即为false
         if (m_low.size() != r.getDimension())
             return false;
 
@@ -81,7 +88,8 @@ namespace RTree
         return true;
     }
 
-    double Region::getIntersectingArea(const Region &r) const
+    template <size_t D>
+    double Region<D>::getIntersectingArea(const Region &r) const
     {
         if (!intersectsRegion(r))
             return 0.0;
@@ -96,9 +104,10 @@ namespace RTree
         return area;
     }
 
-    void Region::combineRegion(const Region &r)
+    template <size_t D>
+    void Region<D>::combineRegion(const Region &r)
     {
-        if (m_low.empty())
+        if (isEmpty())
         {
             m_low = r.m_low;
             m_high = r.m_high;
@@ -117,17 +126,20 @@ namespace RTree
         }
     }
 
-    Point Region::getCenter() const
+    template <size_t D>
+    Point<D> Region<D>::getCenter() const
     {
-        std::vector<double> center(m_low.size());
+        Point<D> center;
+        initCoords(center.m_coords, m_low.size(), 0.0);
         for (size_t i = 0; i < m_low.size(); i++)
         {
-            center[i] = (m_low[i] + m_high[i]) / 2.0;
+            center.m_coords[i] = (m_low[i] + m_high[i]) / 2.0;
         }
-        return Point(center);
+        return center;
     }
 
-    double Region::getMinDistance(const Region &r) const
+    template <size_t D>
+    double Region<D>::getMinDistance(const Region &r) const
     {
         if (intersectsRegion(r))
             return 0.0;
@@ -149,9 +161,10 @@ namespace RTree
         return std::sqrt(distance);
     }
 
-    double Region::getMargin() const
+    template <size_t D>
+    double Region<D>::getMargin() const
     {
-        if (m_low.empty())
+        if (isEmpty())
             return 0.0;
 
         double margin = 0.0;
@@ -162,4 +175,9 @@ namespace RTree
         return 2.0 * margin; // 周长是边长的2倍
     }
 
-} // namespace RTree
\ No newline at end of file
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class Region<DynamicDimension>;
+    template class Region<2>;
+    template class Region<3>;
+
+} // namespace RTree
@@ -2,36 +2,49 @@
 #define RTREE_REGION_H
 
 #include <vector>
+#include <limits>
 #include "Point.h"
 
 namespace RTree
 {
 
     // 区域类 - 表示MBR(最小边界矩形)
+    // 固定维度的空区域用 low=+inf, high=-inf 表示，动态维度的空区域坐标为空
+    template <size_t D = DynamicDimension>
     class Region
     {
     public:
-        std::vector<double> m_low;  // 每个维度的下边界
-        std::vector<double> m_high; // 每个维度的上边界
+        typedef typename CoordinateArray<D>::type Coords;
 
-        Region() {}
-        Region(const Point &low, const Point &high);
+        Coords m_low;  // 每个维度的下边界
+        Coords m_high; // 每个维度的上边界
+
+        Region()
+        {
+            initCoords(m_low, 0, std::numeric_limits<double>::infinity());
+            initCoords(m_high, 0, -std::numeric_limits<double>::infinity());
+        }
+        Region(const Point<D> &low, const Point<D> &high);
         Region(const std::vector<double> &low, const std::vector<double> &high)
-            : m_low(low), m_high(high) {}
-        explicit Region(const Point &p);
+        {
+            assignCoords(m_low, low.begin(), low.end());
+            assignCoords(m_high, high.begin(), high.end());
+        }
+        explicit Region(const Point<D> &p);
 
         size_t getDimension() const { return m_low.size(); }
+        bool isEmpty() const { return m_low.empty() || m_low[0] > m_high[0]; }
         double getArea() const;
-        bool containsPoint(const Point &p) const;
+        bool containsPoint(const Point<D> &p) const;
         bool containsRegion(const Region &r) const;
         bool intersectsRegion(const Region &r) const;
         double getIntersectingArea(const Region &r) const;
         void combineRegion(const Region &r);
-        Point getCenter() const;
+        Point<D> getCenter() const;
         double getMinDistance(const Region &r) const;
         double getMargin() const; // R*-tree分裂会用到的周长计算
     };
 
 } // namespace RTree
 
-#endif // RTREE_REGION_H
\ No newline at end of file
+#endif // RTREE_REGION_H
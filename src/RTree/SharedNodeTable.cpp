@@ -0,0 +1,44 @@
+#include "SharedNodeTable.h"
+
+namespace RTree
+{
+
+    void SharedNodeTable::addRef(const void *node)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_extraRefs[node]++;
+        m_sharedCount.store(m_extraRefs.size(), std::memory_order_release);
+    }
+
+    bool SharedNodeTable::release(const void *node)
+    {
+        // 只有唯一引用者能释放未共享的节点，此时无需查表
+        if (getSharedCount() == 0)
+        {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_extraRefs.find(node);
+        if (it == m_extraRefs.end())
+        {
+            return true;
+        }
+        if (--it->second == 0)
+        {
+            m_extraRefs.erase(it);
+            m_sharedCount.store(m_extraRefs.size(), std::memory_order_release);
+        }
+        return false;
+    }
+
+    bool SharedNodeTable::isShared(const void *node) const
+    {
+        if (getSharedCount() == 0)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_extraRefs.find(node) != m_extraRefs.end();
+    }
+
+} // namespace RTree
@@ -0,0 +1,41 @@
+#ifndef RTREE_SHARED_NODE_TABLE_H
+#define RTREE_SHARED_NODE_TABLE_H
+
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace RTree
+{
+
+    // 被共享节点的引用计数表 - 快照与树共享节点时，只为引用数大于1的节点记录额外引用数，
+    // 表中没有的节点恰好有一个引用。不创建快照的树不为引用计数付出任何内存。
+    // 树与其快照共同持有同一张表；快照可能在其他线程上释放，因此表的修改有锁保护。
+    class SharedNodeTable
+    {
+    public:
+        SharedNodeTable() : m_sharedCount(0) {}
+
+        SharedNodeTable(const SharedNodeTable &) = delete;
+        SharedNodeTable &operator=(const SharedNodeTable &) = delete;
+
+        // 增加node的一个引用
+        void addRef(const void *node);
+        // 释放node的一个引用，返回true表示这是最后一个引用（调用者负责释放节点）
+        bool release(const void *node);
+        // node是否被多于一个父条目或根引用共享
+        bool isShared(const void *node) const;
+
+        size_t getSharedCount() const { return m_sharedCount.load(std::memory_order_acquire); }
+
+    private:
+        std::unordered_map<const void *, uint32_t> m_extraRefs; // 节点 -> 引用数减1
+        std::atomic<size_t> m_sharedCount;                      // m_extraRefs的大小，表为空时免去加锁
+        mutable std::mutex m_mutex;
+    };
+
+} // namespace RTree
+
+#endif // RTREE_SHARED_NODE_TABLE_H
@@ -0,0 +1,293 @@
+#include "SimdKernel.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RTREE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace RTree
+{
+
+    namespace
+    {
+
+        // 清除位图中count之后的无效位（填充区的比较结果）
+        inline void trimMask(size_t count, uint64_t *mask)
+        {
+            if (count & 63)
+            {
+                mask[count >> 6] &= (uint64_t(1) << (count & 63)) - 1;
+            }
+        }
+
+        template <class T>
+        void intersectScalar(const T *bounds, size_t capacity, size_t count, size_t dimension,
+                             const T *queryLow, const T *queryHigh, uint64_t *mask)
+        {
+            std::memset(mask, 0, maskWords(count) * sizeof(uint64_t));
+            const T *high = bounds + dimension * capacity;
+            for (size_t i = 0; i < count; i++)
+            {
+                bool hit = true;
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    hit &= (bounds[d * capacity + i] <= queryHigh[d]) & (high[d * capacity + i] >= queryLow[d]);
+                }
+                mask[i >> 6] |= uint64_t(hit) << (i & 63);
+            }
+        }
+
+#ifdef RTREE_SIMD_X86
+        __attribute__((target("sse2"))) void intersectSSE2(const double *bounds, size_t capacity, size_t count,
+                                                           size_t dimension, const double *queryLow,
+                                                           const double *queryHigh, uint64_t *mask)
+        {
+            std::memset(mask, 0, maskWords(count) * sizeof(uint64_t));
+            const double *high = bounds + dimension * capacity;
+            const __m128d allOnes = _mm_castsi128_pd(_mm_set1_epi32(-1));
+            for (size_t i = 0; i < count; i += 2)
+            {
+                __m128d hit = allOnes;
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    __m128d lo = _mm_load_pd(bounds + d * capacity + i);
+                    __m128d hi = _mm_load_pd(high + d * capacity + i);
+                    hit = _mm_and_pd(hit, _mm_cmple_pd(lo, _mm_set1_pd(queryHigh[d])));
+                    hit = _mm_and_pd(hit, _mm_cmpge_pd(hi, _mm_set1_pd(queryLow[d])));
+                }
+                mask[i >> 6] |= uint64_t(_mm_movemask_pd(hit)) << (i & 63);
+            }
+            trimMask(count, mask);
+        }
+
+        __attribute__((target("avx2"))) void intersectAVX2(const double *bounds, size_t capacity, size_t count,
+                                                           size_t dimension, const double *queryLow,
+                                                           const double *queryHigh, uint64_t *mask)
+        {
+            std::memset(mask, 0, maskWords(count) * sizeof(uint64_t));
+            const double *high = bounds + dimension * capacity;
+            const __m256d allOnes = _mm256_castsi256_pd(_mm256_set1_epi32(-1));
+            for (size_t i = 0; i < count; i += 4)
+            {
+                __m256d hit = allOnes;
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    __m256d lo = _mm256_load_pd(bounds + d * capacity + i);
+                    __m256d hi = _mm256_load_pd(high + d * capacity + i);
+                    hit = _mm256_and_pd(hit, _mm256_cmp_pd(lo, _mm256_set1_pd(queryHigh[d]), _CMP_LE_OQ));
+                    hit = _mm256_and_pd(hit, _mm256_cmp_pd(hi, _mm256_set1_pd(queryLow[d]), _CMP_GE_OQ));
+                }
+                mask[i >> 6] |= uint64_t(_mm256_movemask_pd(hit)) << (i & 63);
+            }
+            trimMask(count, mask);
+        }
+
+        __attribute__((target("avx512f"))) void intersectAVX512(const double *bounds, size_t capacity, size_t count,
+                                                                size_t dimension, const double *queryLow,
+                                                                const double *queryHigh, uint64_t *mask)
+        {
+            std::memset(mask, 0, maskWords(count) * sizeof(uint64_t));
+            const double *high = bounds + dimension * capacity;
+            for (size_t i = 0; i < count; i += 8)
+            {
+                __mmask8 hit = 0xFF;
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    __m512d lo = _mm512_load_pd(bounds + d * capacity + i);
+                    __m512d hi = _mm512_load_pd(high + d * capacity + i);
+                    hit = _mm512_mask_cmp_pd_mask(hit, lo, _mm512_set1_pd(queryHigh[d]), _CMP_LE_OQ);
+                    hit = _mm512_mask_cmp_pd_mask(hit, hi, _mm512_set1_pd(queryLow[d]), _CMP_GE_OQ);
+                }
+                mask[i >> 6] |= uint64_t(hit) << (i & 63);
+            }
+            trimMask(count, mask);
+        }
+
+        __attribute__((target("sse2"))) void intersectFloatSSE2(const float *bounds, size_t capacity, size_t count,
+                                                                size_t dimension, const float *queryLow,
+                                                                const float *queryHigh, uint64_t *mask)
+        {
+            std::memset(mask, 0, maskWords(count) * sizeof(uint64_t));
+            const float *high = bounds + dimension * capacity;
+            const __m128 allOnes = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (size_t i = 0; i < count; i += 4)
+            {
+                __m128 hit = allOnes;
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    __m128 lo = _mm_load_ps(bounds + d * capacity + i);
+                    __m128 hi = _mm_load_ps(high + d * capacity + i);
+                    hit = _mm_and_ps(hit, _mm_cmple_ps(lo, _mm_set1_ps(queryHigh[d])));
+                    hit = _mm_and_ps(hit, _mm_cmpge_ps(hi, _mm_set1_ps(queryLow[d])));
+                }
+                mask[i >> 6] |= uint64_t(_mm_movemask_ps(hit)) << (i & 63);
+            }
+            trimMask(count, mask);
+        }
+
+        __attribute__((target("avx2"))) void intersectFloatAVX2(const float *bounds, size_t capacity, size_t count,
+                                                                size_t dimension, const float *queryLow,
+                                                                const float *queryHigh, uint64_t *mask)
+        {
+            std::memset(mask, 0, maskWords(count) * sizeof(uint64_t));
+            const float *high = bounds + dimension * capacity;
+            const __m256 allOnes = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (size_t i = 0; i < count; i += 8)
+            {
+                __m256 hit = allOnes;
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    __m256 lo = _mm256_load_ps(bounds + d * capacity + i);
+                    __m256 hi = _mm256_load_ps(high + d * capacity + i);
+                    hit = _mm256_and_ps(hit, _mm256_cmp_ps(lo, _mm256_set1_ps(queryHigh[d]), _CMP_LE_OQ));
+                    hit = _mm256_and_ps(hit, _mm256_cmp_ps(hi, _mm256_set1_ps(queryLow[d]), _CMP_GE_OQ));
+                }
+                mask[i >> 6] |= uint64_t(_mm256_movemask_ps(hit)) << (i & 63);
+            }
+            trimMask(count, mask);
+        }
+
+        __attribute__((target("avx512f"))) void intersectFloatAVX512(const float *bounds, size_t capacity,
+                                                                     size_t count, size_t dimension,
+                                                                     const float *queryLow, const float *queryHigh,
+                                                                     uint64_t *mask)
+        {
+            std::memset(mask, 0, maskWords(count) * sizeof(uint64_t));
+            const float *high = bounds + dimension * capacity;
+            for (size_t i = 0; i < count; i += 16)
+            {
+                __mmask16 hit = 0xFFFF;
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    __m512 lo = _mm512_load_ps(bounds + d * capacity + i);
+                    __m512 hi = _mm512_load_ps(high + d * capacity + i);
+                    hit = _mm512_mask_cmp_ps_mask(hit, lo, _mm512_set1_ps(queryHigh[d]), _CMP_LE_OQ);
+                    hit = _mm512_mask_cmp_ps_mask(hit, hi, _mm512_set1_ps(queryLow[d]), _CMP_GE_OQ);
+                }
+                mask[i >> 6] |= uint64_t(hit) << (i & 63);
+            }
+            trimMask(count, mask);
+        }
+#endif
+
+        IntersectKernel kernelFor(SimdLevel level)
+        {
+            switch (level)
+            {
+#ifdef RTREE_SIMD_X86
+            case SimdLevel::AVX512:
+                return intersectAVX512;
+            case SimdLevel::AVX2:
+                return intersectAVX2;
+            case SimdLevel::SSE2:
+                return intersectSSE2;
+#endif
+            default:
+                return intersectScalar<double>;
+            }
+        }
+
+        IntersectKernelFloat floatKernelFor(SimdLevel level)
+        {
+            switch (level)
+            {
+#ifdef RTREE_SIMD_X86
+            case SimdLevel::AVX512:
+                return intersectFloatAVX512;
+            case SimdLevel::AVX2:
+                return intersectFloatAVX2;
+            case SimdLevel::SSE2:
+                return intersectFloatSSE2;
+#endif
+            default:
+                return intersectScalar<float>;
+            }
+        }
+
+        struct KernelSlot
+        {
+            SimdLevel level;
+            IntersectKernel kernel;
+            IntersectKernelFloat floatKernel;
+
+            KernelSlot() : level(detectSimdLevel()), kernel(kernelFor(level)), floatKernel(floatKernelFor(level)) {}
+        };
+
+        KernelSlot &activeKernel()
+        {
+            static KernelSlot slot;
+            return slot;
+        }
+
+    } // namespace
+
+    SimdLevel detectSimdLevel()
+    {
+#ifdef RTREE_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2"))
+            return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse2"))
+            return SimdLevel::SSE2;
+#endif
+        return SimdLevel::Scalar;
+    }
+
+    SimdLevel getSimdLevel()
+    {
+        return activeKernel().level;
+    }
+
+    void setSimdLevel(SimdLevel level)
+    {
+        SimdLevel supported = detectSimdLevel();
+        if (static_cast<int>(level) > static_cast<int>(supported))
+        {
+            level = supported;
+        }
+
+        KernelSlot &slot = activeKernel();
+        slot.level = level;
+        slot.kernel = kernelFor(level);
+        slot.floatKernel = floatKernelFor(level);
+    }
+
+    const char *getSimdLevelName(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::AVX512:
+            return "AVX-512";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::SSE2:
+            return "SSE2";
+        default:
+            return "Scalar";
+        }
+    }
+
+    void intersectBatch(const double *bounds, size_t capacity, size_t count, size_t dimension,
+                        const double *queryLow, const double *queryHigh, uint64_t *mask)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        activeKernel().kernel(bounds, capacity, count, dimension, queryLow, queryHigh, mask);
+    }
+
+    void intersectBatch(const float *bounds, size_t capacity, size_t count, size_t dimension,
+                        const float *queryLow, const float *queryHigh, uint64_t *mask)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        activeKernel().floatKernel(bounds, capacity, count, dimension, queryLow, queryHigh, mask);
+    }
+
+} // namespace RTree
@@ -0,0 +1,152 @@
+#ifndef RTREE_SIMD_KERNEL_H
+#define RTREE_SIMD_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RTree
+{
+
+    // 批量相交检测可用的指令集级别
+    enum class SimdLevel
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    // 批量相交检测内核：
+    //   bounds   - NodeBounds的SoA边界数组（第d维下界在 bounds + d*capacity，上界在 bounds + (dimension+d)*capacity）
+    //   capacity - 每段长度，必须是8的倍数且bounds按64字节对齐
+    //   count    - 有效条目数
+    //   mask     - 输出位图，共 (count+63)/64 个字，第i位为1表示第i个条目与查询相交
+    typedef void (*IntersectKernel)(const double *bounds, size_t capacity, size_t count, size_t dimension,
+                                    const double *queryLow, const double *queryHigh, uint64_t *mask);
+    // float版本：capacity必须是16的倍数，每条指令比较的条目数是double的两倍
+    typedef void (*IntersectKernelFloat)(const float *bounds, size_t capacity, size_t count, size_t dimension,
+                                         const float *queryLow, const float *queryHigh, uint64_t *mask);
+
+    // CPU支持的最高级别（运行时检测）
+    SimdLevel detectSimdLevel();
+
+    // 当前使用的级别；setSimdLevel可强制降级（超过CPU支持的级别时取支持的最高级别）
+    SimdLevel getSimdLevel();
+    void setSimdLevel(SimdLevel level);
+    const char *getSimdLevelName(SimdLevel level);
+
+    // 使用当前级别的内核计算相交位图
+    void intersectBatch(const double *bounds, size_t capacity, size_t count, size_t dimension,
+                        const double *queryLow, const double *queryHigh, uint64_t *mask);
+    void intersectBatch(const float *bounds, size_t capacity, size_t count, size_t dimension,
+                        const float *queryLow, const float *queryHigh, uint64_t *mask);
+
+    // 位图所需的字数
+    inline size_t maskWords(size_t count) { return (count + 63) / 64; }
+
+    // 依次取出位图中为1的位（低位优先）
+    inline size_t nextSetBit(uint64_t &word)
+    {
+        size_t bit = static_cast<size_t>(__builtin_ctzll(word));
+        word &= word - 1;
+        return bit;
+    }
+
+    // 相交位图缓冲区 - 小节点使用内嵌空间，大扇出节点才退化为堆分配
+    class HitMask
+    {
+    public:
+        HitMask() : m_words(m_local), m_count(0) {}
+        HitMask(const HitMask &) = delete;
+        HitMask &operator=(const HitMask &) = delete;
+
+        // 为count个条目准备位图，返回可写入的字数组
+        uint64_t *reset(size_t count)
+        {
+            size_t words = maskWords(count);
+            if (words > LocalWords)
+            {
+                m_heap.resize(words);
+                m_words = m_heap.data();
+            }
+            else
+            {
+                m_words = m_local;
+            }
+            m_count = count;
+            return m_words;
+        }
+
+        bool test(size_t index) const { return (m_words[index >> 6] >> (index & 63)) & 1; }
+        void clear(size_t index) { m_words[index >> 6] &= ~(uint64_t(1) << (index & 63)); }
+
+        // 按条目顺序对每个命中位调用f(index)
+        template <class F>
+        void forEach(F f) const
+        {
+            size_t words = maskWords(m_count);
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t word = m_words[w];
+                while (word)
+                {
+                    f(w * 64 + nextSetBit(word));
+                }
+            }
+        }
+
+        // 同forEach，但f返回false时立即停止；全部访问完返回true
+        template <class F>
+        bool forEachWhile(F f) const
+        {
+            size_t words = maskWords(m_count);
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t word = m_words[w];
+                while (word)
+                {
+                    if (!f(w * 64 + nextSetBit(word)))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // 命中个数
+        size_t popcount() const
+        {
+            size_t hits = 0;
+            for (size_t w = 0; w < maskWords(m_count); w++)
+            {
+                hits += static_cast<size_t>(__builtin_popcountll(m_words[w]));
+            }
+            return hits;
+        }
+
+        bool any() const
+        {
+            for (size_t w = 0; w < maskWords(m_count); w++)
+            {
+                if (m_words[w])
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        static const size_t LocalWords = 4; // 覆盖256个条目
+
+        uint64_t m_local[LocalWords];
+        std::vector<uint64_t> m_heap;
+        uint64_t *m_words;
+        size_t m_count;
+    };
+
+} // namespace RTree
+
+#endif // RTREE_SIMD_KERNEL_H
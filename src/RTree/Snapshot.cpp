@@ -0,0 +1,51 @@
+#include "Snapshot.h"
+
+namespace RTree
+{
+
+    template <size_t D>
+    Snapshot<D>::~Snapshot()
+    {
+        // 只释放本快照的引用：仍被树或其他快照共享的节点保留
+        Node<D>::releaseSubtree(m_root, *m_allocator, *m_sharedNodes);
+    }
+
+    template <size_t D>
+    std::vector<void *> Snapshot<D>::search(const Region<D> &query) const
+    {
+        std::vector<void *> results;
+        visit(query, [&](void *data)
+              {
+                  results.push_back(data);
+                  return true; });
+        return results;
+    }
+
+    template <size_t D>
+    size_t Snapshot<D>::count(const Region<D> &query) const
+    {
+        size_t hits = 0;
+        traverse(query, [&](const Node<D> *, const HitMask &mask)
+                 {
+                     hits += mask.popcount();
+                     return true; });
+        return hits;
+    }
+
+    template <size_t D>
+    bool Snapshot<D>::exists(const Region<D> &query) const
+    {
+        bool found = false;
+        traverse(query, [&](const Node<D> *, const HitMask &mask)
+                 {
+                     found = mask.any();
+                     return !found; });
+        return found;
+    }
+
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class Snapshot<DynamicDimension>;
+    template class Snapshot<2>;
+    template class Snapshot<3>;
+
+} // namespace RTree
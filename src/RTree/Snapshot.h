@@ -0,0 +1,89 @@
+#ifndef RTREE_SNAPSHOT_H
+#define RTREE_SNAPSHOT_H
+
+#include <vector>
+#include <memory>
+#include "Region.h"
+#include "Node.h"
+#include "NodeAllocator.h"
+#include "SharedNodeTable.h"
+
+namespace RTree
+{
+
+    // 树的只读快照 - 由RTree::snapshot()创建，创建代价与树的大小无关。
+    // 快照与树共享所有节点（被共享节点的引用计数记在SharedNodeTable中），之后树的插入/删除先复制从根到被修改节点的路径
+    // （路径复制），快照看到的内容保持不变。快照可以在其他线程上与树的写操作并发查询，
+    // 也可以比树活得更久：它持有分配器的引用，最后一个引用者负责归还节点内存。
+    template <size_t D = DynamicDimension>
+    class Snapshot
+    {
+    public:
+        // root的引用已由调用者增加，快照析构时释放
+        Snapshot(Node<D> *root, size_t size, size_t height, bool useBounds,
+                 std::shared_ptr<NodeAllocator> allocator, std::shared_ptr<SharedNodeTable> sharedNodes)
+            : m_root(root), m_size(size), m_height(height), m_useBounds(useBounds), m_allocator(allocator),
+              m_sharedNodes(sharedNodes) {}
+        ~Snapshot();
+
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        const Node<D> *getRoot() const { return m_root; }
+        size_t getSize() const { return m_size; }
+        size_t getHeight() const { return m_height; }
+
+        // 与RTree的同名查询语义相同：visitor返回false时停止，返回已访问的数据数
+        template <class Visitor>
+        size_t visit(const Region<D> &query, Visitor visitor) const
+        {
+            size_t visited = 0;
+            traverse(query, [&](const Node<D> *leaf, const HitMask &mask)
+                     { return mask.forEachWhile([&](size_t i)
+                                                {
+                                                    visited++;
+                                                    return visitor(leaf->getPayload(i)); }); });
+            return visited;
+        }
+
+        std::vector<void *> search(const Region<D> &query) const;
+        size_t count(const Region<D> &query) const;
+        bool exists(const Region<D> &query) const;
+
+    private:
+        Node<D> *m_root;
+        size_t m_size;
+        size_t m_height;
+        bool m_useBounds; // 创建时树的节点是否维护SoA/float边界（快照存在期间树不能切换布局）
+        std::shared_ptr<NodeAllocator> m_allocator;
+        std::shared_ptr<SharedNodeTable> m_sharedNodes;
+
+        // 深度优先遍历，onLeaf(leaf, mask)返回false时停止
+        template <class OnLeaf>
+        void traverse(const Region<D> &query, OnLeaf onLeaf) const
+        {
+            std::vector<const Node<D> *> stack;
+            HitMask mask;
+            stack.push_back(m_root);
+            while (!stack.empty())
+            {
+                const Node<D> *node = stack.back();
+                stack.pop_back();
+                node->intersectMask(query, mask, m_useBounds);
+                if (node->isLeaf())
+                {
+                    if (!onLeaf(node, mask))
+                    {
+                        return;
+                    }
+                    continue;
+                }
+                mask.forEach([&](size_t i)
+                             { stack.push_back(static_cast<const Node<D> *>(node->getPayload(i))); });
+            }
+        }
+    };
+
+} // namespace RTree
+
+#endif // RTREE_SNAPSHOT_H
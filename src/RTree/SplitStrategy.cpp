@@ -1,15 +1,173 @@
 #include "SplitStrategy.h"
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 namespace RTree
 {
 
+    namespace
+    {
+        // 分裂时新条目视为第entries.size()个条目；按下标取区域，不复制条目数组
+        template <size_t D>
+        inline const Region<D> &regionAt(EntrySpan<D> entries, const Entry<D> &newEntry, size_t i)
+        {
+            return i < entries.size() ? entries[i].m_region : newEntry.m_region;
+        }
+
+        // a与b合并后的面积（不构造合并后的区域），a、b均非空
+        template <size_t D>
+        inline double combinedArea(const Region<D> &a, const Region<D> &b)
+        {
+            double area = 1.0;
+            for (size_t d = 0; d < a.getDimension(); d++)
+            {
+                area *= std::max(a.m_high[d], b.m_high[d]) - std::min(a.m_low[d], b.m_low[d]);
+            }
+            return area;
+        }
+
+        // 按order的顺序扫描前缀与后缀MBR：prefix的第k个槽位是前k+1个条目的MBR，suffix的第k个槽位是
+        // 第k个起所有条目的MBR。每个槽位平铺dim个下界和dim个上界，扫描一次即得到所有分割位置两侧的MBR
+        template <size_t D>
+        void sweepBounds(EntrySpan<D> entries, const Entry<D> &newEntry,
+                         const std::vector<size_t> &order, size_t dim,
+                         std::vector<double> &prefix, std::vector<double> &suffix)
+        {
+            size_t size = order.size();
+            size_t stride = 2 * dim;
+            prefix.resize(size * stride);
+            suffix.resize(size * stride);
+            for (size_t k = 0; k < size; k++)
+            {
+                const Region<D> &region = regionAt(entries, newEntry, order[k]);
+                double *slot = &prefix[k * stride];
+                for (size_t d = 0; d < dim; d++)
+                {
+                    slot[d] = k == 0 ? region.m_low[d] : std::min(slot[d - stride], region.m_low[d]);
+                    slot[dim + d] = k == 0 ? region.m_high[d] : std::max(slot[dim + d - stride], region.m_high[d]);
+                }
+            }
+            for (size_t k = size; k-- > 0;)
+            {
+                const Region<D> &region = regionAt(entries, newEntry, order[k]);
+                double *slot = &suffix[k * stride];
+                for (size_t d = 0; d < dim; d++)
+                {
+                    slot[d] = k + 1 == size ? region.m_low[d] : std::min(slot[d + stride], region.m_low[d]);
+                    slot[dim + d] = k + 1 == size ? region.m_high[d] : std::max(slot[dim + d + stride], region.m_high[d]);
+                }
+            }
+        }
+
+        // 平铺边界（dim个下界 + dim个上界）的周长、面积与重叠面积
+        inline double boundsMargin(const double *bounds, size_t dim)
+        {
+            double margin = 0.0;
+            for (size_t d = 0; d < dim; d++)
+            {
+                margin += bounds[dim + d] - bounds[d];
+            }
+            return 2.0 * margin;
+        }
+
+        inline double boundsArea(const double *bounds, size_t dim)
+        {
+            double area = 1.0;
+            for (size_t d = 0; d < dim; d++)
+            {
+                area *= bounds[dim + d] - bounds[d];
+            }
+            return area;
+        }
+
+        inline double boundsOverlap(const double *a, const double *b, size_t dim)
+        {
+            double area = 1.0;
+            for (size_t d = 0; d < dim; d++)
+            {
+                double low = std::max(a[d], b[d]);
+                double high = std::min(a[dim + d], b[dim + d]);
+                if (high < low)
+                {
+                    return 0.0;
+                }
+                area *= high - low;
+            }
+            return area;
+        }
+
+        // 一个轴上按下界(0)、上界(1)两种排序的条目顺序，以及各自的前缀/后缀MBR
+        struct AxisSweep
+        {
+            std::vector<size_t> order[2];
+            std::vector<double> prefix[2];
+            std::vector<double> suffix[2];
+        };
+
+        // R*选轴：每个轴按下界和上界各排序一次并扫描，累加所有分割位置（每组至少minFanout个）两侧的周长，
+        // 周长和最小的轴的排序与扫描结果留在best中。总代价O(D·M log M)
+        template <size_t D>
+        void chooseSplitAxis(EntrySpan<D> entries, const Entry<D> &newEntry,
+                             size_t dim, size_t minFanout, AxisSweep &best)
+        {
+            size_t size = entries.size() + 1;
+            size_t stride = 2 * dim;
+            AxisSweep current;
+            double minMargin = std::numeric_limits<double>::max();
+
+            for (size_t d = 0; d < dim; d++)
+            {
+                for (int side = 0; side < 2; side++)
+                {
+                    std::vector<size_t> &order = current.order[side];
+                    order.resize(size);
+                    for (size_t i = 0; i < size; i++)
+                    {
+                        order[i] = i;
+                    }
+                    std::sort(order.begin(), order.end(),
+                              [&](size_t i1, size_t i2)
+                              {
+                                  const Region<D> &r1 = regionAt(entries, newEntry, i1);
+                                  const Region<D> &r2 = regionAt(entries, newEntry, i2);
+                                  return side == 0 ? r1.m_low[d] < r2.m_low[d] : r1.m_high[d] < r2.m_high[d];
+                              });
+                    sweepBounds(entries, newEntry, order, dim, current.prefix[side], current.suffix[side]);
+                }
+
+                // 考虑所有可能的分割：前k个与其余
+                double margin = 0.0;
+                for (size_t k = minFanout; k <= size - minFanout; k++)
+                {
+                    for (int side = 0; side < 2; side++)
+                    {
+                        margin += boundsMargin(&current.prefix[side][(k - 1) * stride], dim) +
+                                  boundsMargin(&current.suffix[side][k * stride], dim);
+                    }
+                }
+
+                // 选周长和最小的轴
+                if (margin < minMargin)
+                {
+                    minMargin = margin;
+                    for (int side = 0; side < 2; side++)
+                    {
+                        best.order[side].swap(current.order[side]);
+                        best.prefix[side].swap(current.prefix[side]);
+                        best.suffix[side].swap(current.suffix[side]);
+                    }
+                }
+            }
+        }
+    } // namespace
+
     // LinearSplitStrategy实现
-    void LinearSplitStrategy::split(const std::vector<Entry> &entries,
-                                    const Entry &newEntry,
-                                    std::vector<size_t> &group1,
-                                    std::vector<size_t> &group2)
+    template <size_t D>
+    void LinearSplitStrategy<D>::split(EntrySpan<D> entries,
+                                       const Entry<D> &newEntry,
+                                       std::vector<size_t> &group1,
+                                       std::vector<size_t> &group2)
     {
         // 清空输出分组
         group1.clear();
@@ -21,46 +179,41 @@ namespace RTree
             return;
         }
 
-        // 所有条目，包括新条目
-        std::vector<Entry> allEntries = entries;
-        allEntries.push_back(newEntry);
+        // 所有条目（包括新条目）按下标访问
+        size_t size = entries.size() + 1;
+        auto region = [&](size_t i) -> const Region<D> &
+        { return regionAt(entries, newEntry, i); };
 
         // 找到沿某个轴距离最远的两个条目作为种子
-        size_t dim = allEntries[0].m_region.getDimension();
+        size_t dim = entries[0].m_region.getDimension();
         double maxNormSep = -1.0;
         size_t seed1 = 0, seed2 = 0;
 
         for (size_t d = 0; d < dim; d++)
         {
-            // 在当前维度上找最低和最高的索引
+            // 在当前维度上找最低和最高的索引，同时求最大宽度
             size_t minIdx = 0, maxIdx = 0;
+            double width = std::max(0.0, region(0).m_high[d] - region(0).m_low[d]);
 
-            for (size_t i = 1; i < allEntries.size(); i++)
+            for (size_t i = 1; i < size; i++)
             {
-                if (allEntries[i].m_region.m_low[d] < allEntries[minIdx].m_region.m_low[d])
+                const Region<D> &r = region(i);
+                if (r.m_low[d] < region(minIdx).m_low[d])
                 {
                     minIdx = i;
                 }
-                if (allEntries[i].m_region.m_high[d] > allEntries[maxIdx].m_region.m_high[d])
+                if (r.m_high[d] > region(maxIdx).m_high[d])
                 {
                     maxIdx = i;
                 }
+                width = std::max(width, r.m_high[d] - r.m_low[d]);
             }
 
             // 计算归一化分离度
-            double minEntryWidth = allEntries[minIdx].m_region.m_high[d] - allEntries[minIdx].m_region.m_low[d];
-            double maxEntryWidth = allEntries[maxIdx].m_region.m_high[d] - allEntries[maxIdx].m_region.m_low[d];
-            double width = 0;
-
-            for (const auto &entry : allEntries)
-            {
-                width = std::max(width, entry.m_region.m_high[d] - entry.m_region.m_low[d]);
-            }
-
             double normSep = 0;
             if (width > 0)
             {
-                normSep = (allEntries[maxIdx].m_region.m_low[d] - allEntries[minIdx].m_region.m_high[d]) / width;
+                normSep = (region(maxIdx).m_low[d] - region(minIdx).m_high[d]) / width;
             }
 
             if (normSep > maxNormSep)
@@ -75,75 +228,47 @@ namespace RTree
         if (maxNormSep < 0)
         {
             seed1 = 0;
-            seed2 = allEntries.size() - 1;
+            seed2 = size - 1;
         }
 
-        // 分配种子
+        // 分配种子，两组的MBR随分配增量更新
         group1.push_back(seed1);
         group2.push_back(seed2);
-
-        // 分配其余条目
-        std::vector<bool> assigned(allEntries.size(), false);
-        assigned[seed1] = assigned[seed2] = true;
+        Region<D> mbr1 = region(seed1), mbr2 = region(seed2);
+        double area1 = mbr1.getArea(), area2 = mbr2.getArea();
 
         // 为剩余每个条目选择扩展面积最小的组
-        for (size_t i = 0; i < allEntries.size(); i++)
+        for (size_t i = 0; i < size; i++)
         {
-            if (assigned[i])
+            if (i == seed1 || i == seed2)
                 continue;
 
-            // 计算MBR
-            Region mbr1, mbr2;
-            if (!group1.empty())
-            {
-                mbr1 = allEntries[group1[0]].m_region;
-                for (size_t j = 1; j < group1.size(); j++)
-                {
-                    mbr1.combineRegion(allEntries[group1[j]].m_region);
-                }
-            }
-
-            if (!group2.empty())
-            {
-                mbr2 = allEntries[group2[0]].m_region;
-                for (size_t j = 1; j < group2.size(); j++)
-                {
-                    mbr2.combineRegion(allEntries[group2[j]].m_region);
-                }
-            }
-
             // 计算扩展面积
-            double area1 = mbr1.getArea();
-            double area2 = mbr2.getArea();
-
-            Region expandedMbr1 = mbr1;
-            expandedMbr1.combineRegion(allEntries[i].m_region);
-
-            Region expandedMbr2 = mbr2;
-            expandedMbr2.combineRegion(allEntries[i].m_region);
-
-            double increase1 = expandedMbr1.getArea() - area1;
-            double increase2 = expandedMbr2.getArea() - area2;
+            double increase1 = combinedArea(mbr1, region(i)) - area1;
+            double increase2 = combinedArea(mbr2, region(i)) - area2;
 
             // 选择扩展面积较小的组
             if (increase1 < increase2 || (increase1 == increase2 && group1.size() < group2.size()))
             {
                 group1.push_back(i);
+                mbr1.combineRegion(region(i));
+                area1 = mbr1.getArea();
             }
             else
             {
                 group2.push_back(i);
+                mbr2.combineRegion(region(i));
+                area2 = mbr2.getArea();
             }
-
-            assigned[i] = true;
         }
     }
 
     // QuadraticSplitStrategy实现
-    void QuadraticSplitStrategy::split(const std::vector<Entry> &entries,
-                                       const Entry &newEntry,
-                                       std::vector<size_t> &group1,
-                                       std::vector<size_t> &group2)
+    template <size_t D>
+    void QuadraticSplitStrategy<D>::split(EntrySpan<D> entries,
+                                          const Entry<D> &newEntry,
+                                          std::vector<size_t> &group1,
+                                          std::vector<size_t> &group2)
     {
         // 清空输出分组
         group1.clear();
@@ -155,23 +280,21 @@ namespace RTree
             return;
         }
 
-        // 所有条目，包括新条目
-        std::vector<Entry> allEntries = entries;
-        allEntries.push_back(newEntry);
+        // 所有条目（包括新条目）按下标访问
+        size_t size = entries.size() + 1;
+        auto region = [&](size_t i) -> const Region<D> &
+        { return regionAt(entries, newEntry, i); };
 
         // 找到两个条目，它们一起构成的MBR比分别构成的MBR的面积和要大
         double maxWaste = -1.0;
         size_t seed1 = 0, seed2 = 0;
 
-        for (size_t i = 0; i < allEntries.size(); i++)
+        for (size_t i = 0; i < size; i++)
         {
-            for (size_t j = i + 1; j < allEntries.size(); j++)
+            double areaI = region(i).getArea();
+            for (size_t j = i + 1; j < size; j++)
             {
-                Region combined;
-                combined = allEntries[i].m_region;
-                combined.combineRegion(allEntries[j].m_region);
-
-                double waste = combined.getArea() - allEntries[i].m_region.getArea() - allEntries[j].m_region.getArea();
+                double waste = combinedArea(region(i), region(j)) - areaI - region(j).getArea();
 
                 if (waste > maxWaste)
                 {
@@ -182,72 +305,35 @@ namespace RTree
             }
         }
 
-        // 初始化两个组
+        // 初始化两个组，两组的MBR随分配增量更新，不再每轮重算
         group1.push_back(seed1);
         group2.push_back(seed2);
+        Region<D> mbr1 = region(seed1), mbr2 = region(seed2);
+        double area1 = mbr1.getArea(), area2 = mbr2.getArea();
 
-        std::vector<bool> assigned(allEntries.size(), false);
+        std::vector<bool> assigned(size, false);
         assigned[seed1] = assigned[seed2] = true;
 
         // 逐个分配剩余条目
-        while (true)
+        for (size_t remaining = size - 2; remaining > 0; remaining--)
         {
-            // 检查是否所有条目都已分配
-            bool allAssigned = true;
-            for (size_t i = 0; i < allEntries.size(); i++)
-            {
-                if (!assigned[i])
-                {
-                    allAssigned = false;
-                    break;
-                }
-            }
-
-            if (allAssigned)
-                break;
-
-            // 计算当前MBR
-            Region mbr1, mbr2;
-            if (!group1.empty())
-            {
-                mbr1 = allEntries[group1[0]].m_region;
-                for (size_t i = 1; i < group1.size(); i++)
-                {
-                    mbr1.combineRegion(allEntries[group1[i]].m_region);
-                }
-            }
-
-            if (!group2.empty())
-            {
-                mbr2 = allEntries[group2[0]].m_region;
-                for (size_t i = 1; i < group2.size(); i++)
-                {
-                    mbr2.combineRegion(allEntries[group2[i]].m_region);
-                }
-            }
-
             // 找下一个条目：它对两组MBR的面积扩展差异最大
             double maxDiff = -1.0;
             size_t next = 0;
             int preferred = -1; // 1表示组1, 2表示组2
 
-            for (size_t i = 0; i < allEntries.size(); i++)
+            for (size_t i = 0; i < size; i++)
             {
                 if (assigned[i])
                     continue;
 
                 // 计算将该条目加入各组后的面积扩展
-                Region newMbr1 = mbr1;
-                newMbr1.combineRegion(allEntries[i].m_region);
-                double increase1 = newMbr1.getArea() - mbr1.getArea();
-
-                Region newMbr2 = mbr2;
-                newMbr2.combineRegion(allEntries[i].m_region);
-                double increase2 = newMbr2.getArea() - mbr2.getArea();
+                double increase1 = combinedArea(mbr1, region(i)) - area1;
+                double increase2 = combinedArea(mbr2, region(i)) - area2;
 
                 double diff = std::abs(increase1 - increase2);
 
-                if (diff > maxDiff)
+                if (diff > maxDiff || preferred < 0)
                 {
                     maxDiff = diff;
                     next = i;
@@ -255,22 +341,18 @@ namespace RTree
                 }
             }
 
-            // 分配到首选组，除非这会导致某组元素太少
-            if (preferred == 2 && group1.size() >= 1)
-            {
-                group2.push_back(next);
-            }
-            else if (preferred == 1 && group2.size() >= 1)
-            {
-                group1.push_back(next);
-            }
-            else if (group1.size() < group2.size())
+            // 分配到首选组（两组都已有种子，首选总是可行）
+            if (preferred == 1)
             {
                 group1.push_back(next);
+                mbr1.combineRegion(region(next));
+                area1 = mbr1.getArea();
             }
             else
             {
                 group2.push_back(next);
+                mbr2.combineRegion(region(next));
+                area2 = mbr2.getArea();
             }
 
             assigned[next] = true;
@@ -278,10 +360,11 @@ namespace RTree
     }
 
     // RStarSplitStrategy实现
-    void RStarSplitStrategy::split(const std::vector<Entry> &entries,
-                                   const Entry &newEntry,
-                                   std::vector<size_t> &group1,
-                                   std::vector<size_t> &group2)
+    template <size_t D>
+    void RStarSplitStrategy<D>::split(EntrySpan<D> entries,
+                                      const Entry<D> &newEntry,
+                                      std::vector<size_t> &group1,
+                                      std::vector<size_t> &group2)
     {
         // 清空输出分组
         group1.clear();
@@ -293,243 +376,312 @@ namespace RTree
             return;
         }
 
-        // 所有条目，包括新条目
-        std::vector<Entry> allEntries = entries;
-        allEntries.push_back(newEntry);
+        // 所有条目（包括新条目）按下标访问
+        size_t dim = entries[0].m_region.getDimension();
+        size_t size = entries.size() + 1;
+        size_t minFanout = std::max<size_t>(1, static_cast<size_t>(size * 0.4)); // 40%
+        size_t stride = 2 * dim;
 
-        size_t dim = allEntries[0].m_region.getDimension();
-        size_t size = allEntries.size();
+        // 周长和最小的轴
+        AxisSweep axis;
+        chooseSplitAxis(entries, newEntry, dim, minFanout, axis);
 
-        // 确定沿哪个维度分割
-        double minMargin = std::numeric_limits<double>::max();
-        size_t splitAxis = 0;
+        // 在选定的轴上寻找重叠最小（其次面积和最小）的分割，先试下界排序再试上界排序
+        double minOverlap = std::numeric_limits<double>::max();
+        double minArea = std::numeric_limits<double>::max();
+        size_t splitIndex = 0;
+        int splitSide = 0;
 
-        for (size_t d = 0; d < dim; d++)
+        for (int side = 0; side < 2; side++)
         {
-            // 按下界和上界排序
-            std::vector<size_t> sortedByLow(size);
-            std::vector<size_t> sortedByHigh(size);
-
-            for (size_t i = 0; i < size; i++)
-            {
-                sortedByLow[i] = i;
-                sortedByHigh[i] = i;
-            }
-
-            std::sort(sortedByLow.begin(), sortedByLow.end(),
-                      [&allEntries, d](size_t i1, size_t i2)
-                      {
-                          return allEntries[i1].m_region.m_low[d] < allEntries[i2].m_region.m_low[d];
-                      });
-
-            std::sort(sortedByHigh.begin(), sortedByHigh.end(),
-                      [&allEntries, d](size_t i1, size_t i2)
-                      {
-                          return allEntries[i1].m_region.m_high[d] < allEntries[i2].m_region.m_high[d];
-                      });
-
-            // 考虑所有可能的分割
-            size_t minFanout = size * 0.4; // 40%
-            double margin = 0.0;
-
             for (size_t k = minFanout; k <= size - minFanout; k++)
             {
-                // 分割基于下界
-                Region mbr1Low, mbr2Low;
-                for (size_t i = 0; i < k; i++)
-                {
-                    if (i == 0)
-                    {
-                        mbr1Low = allEntries[sortedByLow[i]].m_region;
-                    }
-                    else
-                    {
-                        mbr1Low.combineRegion(allEntries[sortedByLow[i]].m_region);
-                    }
-                }
-
-                for (size_t i = k; i < size; i++)
-                {
-                    if (i == k)
-                    {
-                        mbr2Low = allEntries[sortedByLow[i]].m_region;
-                    }
-                    else
-                    {
-                        mbr2Low.combineRegion(allEntries[sortedByLow[i]].m_region);
-                    }
-                }
+                const double *mbr1 = &axis.prefix[side][(k - 1) * stride];
+                const double *mbr2 = &axis.suffix[side][k * stride];
 
-                // 分割基于上界
-                Region mbr1High, mbr2High;
-                for (size_t i = 0; i < k; i++)
-                {
-                    if (i == 0)
-                    {
-                        mbr1High = allEntries[sortedByHigh[i]].m_region;
-                    }
-                    else
-                    {
-                        mbr1High.combineRegion(allEntries[sortedByHigh[i]].m_region);
-                    }
-                }
+                // 计算重叠和面积总和
+                double overlap = boundsOverlap(mbr1, mbr2, dim);
+                double area = boundsArea(mbr1, dim) + boundsArea(mbr2, dim);
 
-                for (size_t i = k; i < size; i++)
+                if (overlap < minOverlap || (overlap == minOverlap && area < minArea))
                 {
-                    if (i == k)
-                    {
-                        mbr2High = allEntries[sortedByHigh[i]].m_region;
-                    }
-                    else
-                    {
-                        mbr2High.combineRegion(allEntries[sortedByHigh[i]].m_region);
-                    }
+                    minOverlap = overlap;
+                    minArea = area;
+                    splitIndex = k;
+                    splitSide = side;
                 }
-
-                // 计算周长总和
-                margin += mbr1Low.getMargin() + mbr2Low.getMargin();
-                margin += mbr1High.getMargin() + mbr2High.getMargin();
-            }
-
-            // 选周长和最小的轴
-            if (margin < minMargin)
-            {
-                minMargin = margin;
-                splitAxis = d;
             }
         }
 
-        // 分割轴确定后，选择最佳分割索引
-        // 按下界和上界排序
-        std::vector<size_t> sortedByLow(size);
-        std::vector<size_t> sortedByHigh(size);
+        // 应用最终分割
+        const std::vector<size_t> &sortedIndices = axis.order[splitSide];
+        group1.assign(sortedIndices.begin(), sortedIndices.begin() + splitIndex);
+        group2.assign(sortedIndices.begin() + splitIndex, sortedIndices.end());
+    }
 
-        for (size_t i = 0; i < size; i++)
+    // AngTanSplitStrategy实现
+    template <size_t D>
+    void AngTanSplitStrategy<D>::split(EntrySpan<D> entries,
+                                       const Entry<D> &newEntry,
+                                       std::vector<size_t> &group1,
+                                       std::vector<size_t> &group2)
+    {
+        group1.clear();
+        group2.clear();
+
+        if (entries.empty())
         {
-            sortedByLow[i] = i;
-            sortedByHigh[i] = i;
+            group1.push_back(0); // 只有新条目
+            return;
         }
 
-        std::sort(sortedByLow.begin(), sortedByLow.end(),
-                  [&allEntries, splitAxis](size_t i1, size_t i2)
-                  {
-                      return allEntries[i1].m_region.m_low[splitAxis] <
-                             allEntries[i2].m_region.m_low[splitAxis];
-                  });
-
-        std::sort(sortedByHigh.begin(), sortedByHigh.end(),
-                  [&allEntries, splitAxis](size_t i1, size_t i2)
-                  {
-                      return allEntries[i1].m_region.m_high[splitAxis] <
-                             allEntries[i2].m_region.m_high[splitAxis];
-                  });
-
-        // 寻找最小重叠的分割
-        double minOverlap = std::numeric_limits<double>::max();
-        double minArea = std::numeric_limits<double>::max();
-        size_t splitIndex = 0;
-        bool useSortedByLow = true;
-
-        size_t minFanout = size * 0.4; // 40%
+        size_t size = entries.size() + 1;
+        size_t dim = entries[0].m_region.getDimension();
+        auto region = [&](size_t i) -> const Region<D> &
+        { return regionAt(entries, newEntry, i); };
 
-        // 尝试基于下界的所有分割点
-        for (size_t k = minFanout; k <= size - minFanout; k++)
+        // 节点（含新条目）的MBR
+        Region<D> bounds = region(0);
+        for (size_t i = 1; i < size; i++)
         {
-            Region mbr1, mbr2;
+            bounds.combineRegion(region(i));
+        }
 
-            // 计算两个MBR
-            for (size_t i = 0; i < k; i++)
+        // 每个轴上条目离MBR的下边更近则归入左组，否则归入右组。较小一组不足最小填充的轴不可用
+        // （最小填充与树的最小条目数maxEntries/2一致）；可用的轴中选重叠最小、其次面积和最小的一个
+        size_t minFill = std::max<size_t>(1, (size - 1) / 2);
+        std::vector<size_t> left, right;
+        size_t widestAxis = 0; // 节点MBR最长的轴，所有轴都不可用时在其上按中位切开
+        double bestOverlap = std::numeric_limits<double>::max();
+        double bestArea = std::numeric_limits<double>::max();
+        for (size_t d = 0; d < dim; d++)
+        {
+            left.clear();
+            right.clear();
+            for (size_t i = 0; i < size; i++)
             {
-                if (i == 0)
-                {
-                    mbr1 = allEntries[sortedByLow[i]].m_region;
-                }
-                else
-                {
-                    mbr1.combineRegion(allEntries[sortedByLow[i]].m_region);
-                }
+                const Region<D> &r = region(i);
+                (r.m_low[d] - bounds.m_low[d] < bounds.m_high[d] - r.m_high[d] ? left : right).push_back(i);
             }
-
-            for (size_t i = k; i < size; i++)
+            if (bounds.m_high[d] - bounds.m_low[d] > bounds.m_high[widestAxis] - bounds.m_low[widestAxis])
             {
-                if (i == k)
-                {
-                    mbr2 = allEntries[sortedByLow[i]].m_region;
-                }
-                else
-                {
-                    mbr2.combineRegion(allEntries[sortedByLow[i]].m_region);
-                }
+                widestAxis = d;
+            }
+            if (std::min(left.size(), right.size()) < minFill)
+            {
+                continue;
             }
 
-            // 计算重叠和面积总和
+            Region<D> mbr1 = region(left[0]), mbr2 = region(right[0]);
+            for (size_t i = 1; i < left.size(); i++)
+            {
+                mbr1.combineRegion(region(left[i]));
+            }
+            for (size_t i = 1; i < right.size(); i++)
+            {
+                mbr2.combineRegion(region(right[i]));
+            }
             double overlap = mbr1.getIntersectingArea(mbr2);
             double area = mbr1.getArea() + mbr2.getArea();
+            if (overlap < bestOverlap || (overlap == bestOverlap && area < bestArea))
+            {
+                bestOverlap = overlap;
+                bestArea = area;
+                group1.swap(left);
+                group2.swap(right);
+            }
+        }
 
-            if (overlap < minOverlap || (overlap == minOverlap && area < minArea))
+        // 没有可用的轴（条目集中在MBR一侧或MBR完全相同）时，在最长的轴上按中心排序，从中位处切开
+        if (group1.empty())
+        {
+            std::vector<size_t> order(size);
+            for (size_t i = 0; i < size; i++)
             {
-                minOverlap = overlap;
-                minArea = area;
-                splitIndex = k;
-                useSortedByLow = true;
+                order[i] = i;
             }
+            std::sort(order.begin(), order.end(),
+                      [&](size_t i1, size_t i2)
+                      {
+                          const Region<D> &r1 = region(i1);
+                          const Region<D> &r2 = region(i2);
+                          return r1.m_low[widestAxis] + r1.m_high[widestAxis] <
+                                 r2.m_low[widestAxis] + r2.m_high[widestAxis];
+                      });
+            group1.assign(order.begin(), order.begin() + size / 2);
+            group2.assign(order.begin() + size / 2, order.end());
         }
+    }
+
+    // RevisedRStarSplitStrategy实现
+    template <size_t D>
+    void RevisedRStarSplitStrategy<D>::split(EntrySpan<D> entries,
+                                             const Entry<D> &newEntry,
+                                             std::vector<size_t> &group1,
+                                             std::vector<size_t> &group2)
+    {
+        group1.clear();
+        group2.clear();
 
-        // 尝试基于上界的所有分割点
-        for (size_t k = minFanout; k <= size - minFanout; k++)
+        if (entries.empty())
         {
-            Region mbr1, mbr2;
+            group1.push_back(0); // 只有新条目
+            return;
+        }
+
+        size_t dim = entries[0].m_region.getDimension();
+        size_t size = entries.size() + 1;
+        size_t minFill = std::max<size_t>(1, static_cast<size_t>(size * 0.3)); // 30%
+        size_t stride = 2 * dim;
 
-            // 计算两个MBR
-            for (size_t i = 0; i < k; i++)
+        // 与R*相同按周长和选轴
+        AxisSweep axis;
+        chooseSplitAxis(entries, newEntry, dim, minFill, axis);
+
+        // 权重函数：分割位置映射到(-1, 1)，中间为1、两端趋近0的截断高斯（s = 0.5）
+        const double s = 0.5;
+        const double y1 = std::exp(-1.0 / (s * s));
+        const double ys = 1.0 / (1.0 - y1);
+        auto weight = [&](size_t k)
+        {
+            double x = 2.0 * k / size - 1.0;
+            return ys * (std::exp(-(x / s) * (x / s)) - y1);
+        };
+
+        // 存在无重叠的分割时只在它们之中选择，目标为周长和减去其上界（负值，越小越好）乘以权重；
+        // 否则目标为重叠面积除以权重。两种排序的所有分割位置一起比较
+        const double *full = &axis.prefix[0][(size - 1) * stride];
+        double perimeterMax = 2.0 * boundsMargin(full, dim);
+        bool overlapFree = false;
+        for (int side = 0; side < 2 && !overlapFree; side++)
+        {
+            for (size_t k = minFill; k <= size - minFill; k++)
             {
-                if (i == 0)
-                {
-                    mbr1 = allEntries[sortedByHigh[i]].m_region;
-                }
-                else
+                if (boundsOverlap(&axis.prefix[side][(k - 1) * stride], &axis.suffix[side][k * stride], dim) == 0.0)
                 {
-                    mbr1.combineRegion(allEntries[sortedByHigh[i]].m_region);
+                    overlapFree = true;
+                    break;
                 }
             }
+        }
 
-            for (size_t i = k; i < size; i++)
+        double bestGoal = std::numeric_limits<double>::max();
+        size_t splitIndex = minFill;
+        int splitSide = 0;
+        for (int side = 0; side < 2; side++)
+        {
+            for (size_t k = minFill; k <= size - minFill; k++)
             {
-                if (i == k)
+                const double *mbr1 = &axis.prefix[side][(k - 1) * stride];
+                const double *mbr2 = &axis.suffix[side][k * stride];
+                double overlap = boundsOverlap(mbr1, mbr2, dim);
+                double goal;
+                if (overlapFree)
                 {
-                    mbr2 = allEntries[sortedByHigh[i]].m_region;
+                    if (overlap > 0.0)
+                    {
+                        continue;
+                    }
+                    goal = (boundsMargin(mbr1, dim) + boundsMargin(mbr2, dim) - perimeterMax) * weight(k);
                 }
                 else
                 {
-                    mbr2.combineRegion(allEntries[sortedByHigh[i]].m_region);
+                    goal = overlap / weight(k);
+                }
+                if (goal < bestGoal)
+                {
+                    bestGoal = goal;
+                    splitIndex = k;
+                    splitSide = side;
                 }
-            }
-
-            // 计算重叠和面积总和
-            double overlap = mbr1.getIntersectingArea(mbr2);
-            double area = mbr1.getArea() + mbr2.getArea();
-
-            if (overlap < minOverlap || (overlap == minOverlap && area < minArea))
-            {
-                minOverlap = overlap;
-                minArea = area;
-                splitIndex = k;
-                useSortedByLow = false;
             }
         }
 
-        // 应用最终分割
-        std::vector<size_t> &sortedIndices = useSortedByLow ? sortedByLow : sortedByHigh;
+        const std::vector<size_t> &sortedIndices = axis.order[splitSide];
+        group1.assign(sortedIndices.begin(), sortedIndices.begin() + splitIndex);
+        group2.assign(sortedIndices.begin() + splitIndex, sortedIndices.end());
+    }
+
+    // TopologicalSplitStrategy实现
+    template <size_t D>
+    void TopologicalSplitStrategy<D>::split(EntrySpan<D> entries,
+                                            const Entry<D> &newEntry,
+                                            std::vector<size_t> &group1,
+                                            std::vector<size_t> &group2)
+    {
+        group1.clear();
+        group2.clear();
 
-        for (size_t i = 0; i < splitIndex; i++)
+        if (entries.empty())
         {
-            group1.push_back(sortedIndices[i]);
+            group1.push_back(0); // 只有新条目
+            return;
         }
 
-        for (size_t i = splitIndex; i < size; i++)
+        size_t dim = entries[0].m_region.getDimension();
+        size_t size = entries.size() + 1;
+        size_t half = size / 2;
+        auto region = [&](size_t i) -> const Region<D> &
+        { return regionAt(entries, newEntry, i); };
+
+        std::vector<size_t> order(size), bestOrder;
+        double bestOverlap = std::numeric_limits<double>::max();
+        double bestMargin = std::numeric_limits<double>::max();
+        for (size_t d = 0; d < dim; d++)
         {
-            group2.push_back(sortedIndices[i]);
+            for (size_t i = 0; i < size; i++)
+            {
+                order[i] = i;
+            }
+            // 按中心排序（下界与上界之和与中心同序）
+            std::sort(order.begin(), order.end(),
+                      [&](size_t i1, size_t i2)
+                      {
+                          return region(i1).m_low[d] + region(i1).m_high[d] < region(i2).m_low[d] + region(i2).m_high[d];
+                      });
+
+            Region<D> mbr1 = region(order[0]), mbr2 = region(order[half]);
+            for (size_t i = 1; i < half; i++)
+            {
+                mbr1.combineRegion(region(order[i]));
+            }
+            for (size_t i = half + 1; i < size; i++)
+            {
+                mbr2.combineRegion(region(order[i]));
+            }
+            double overlap = mbr1.getIntersectingArea(mbr2);
+            double margin = mbr1.getMargin() + mbr2.getMargin();
+            if (overlap < bestOverlap || (overlap == bestOverlap && margin < bestMargin))
+            {
+                bestOverlap = overlap;
+                bestMargin = margin;
+                bestOrder.swap(order);
+                order.resize(size);
+            }
         }
+
+        group1.assign(bestOrder.begin(), bestOrder.begin() + half);
+        group2.assign(bestOrder.begin() + half, bestOrder.end());
     }
 
+    // 显式实例化：动态维度以及常用的2D/3D
+    template class LinearSplitStrategy<DynamicDimension>;
+    template class LinearSplitStrategy<2>;
+    template class LinearSplitStrategy<3>;
+    template class QuadraticSplitStrategy<DynamicDimension>;
+    template class QuadraticSplitStrategy<2>;
+    template class QuadraticSplitStrategy<3>;
+    template class RStarSplitStrategy<DynamicDimension>;
+    template class RStarSplitStrategy<2>;
+    template class RStarSplitStrategy<3>;
+    template class AngTanSplitStrategy<DynamicDimension>;
+    template class AngTanSplitStrategy<2>;
+    template class AngTanSplitStrategy<3>;
+    template class RevisedRStarSplitStrategy<DynamicDimension>;
+    template class RevisedRStarSplitStrategy<2>;
+    template class RevisedRStarSplitStrategy<3>;
+    template class TopologicalSplitStrategy<DynamicDimension>;
+    template class TopologicalSplitStrategy<2>;
+    template class TopologicalSplitStrategy<3>;
+
 } // namespace RTree
\ No newline at end of file
@@ -3,56 +3,102 @@
 
 #include <vector>
 #include <string>
-#include "Entry.h"
+#include "EntryArray.h"
 
 namespace RTree
 {
 
-    // 分裂策略接口
+    // 分裂策略接口：entries为节点现有条目（节点的EntryArray或任意std::vector），
+    // 结果以下标表示，下标entries.size()指newEntry
+    template <size_t D = DynamicDimension>
     class SplitStrategy
     {
     public:
         virtual ~SplitStrategy() = default;
-        virtual void split(const std::vector<Entry> &entries,
-                           const Entry &newEntry,
+        virtual void split(EntrySpan<D> entries,
+                           const Entry<D> &newEntry,
                            std::vector<size_t> &group1,
                            std::vector<size_t> &group2) = 0;
         virtual std::string getName() const = 0;
     };
 
     // 线性分裂策略
-    class LinearSplitStrategy : public SplitStrategy
+    template <size_t D = DynamicDimension>
+    class LinearSplitStrategy : public SplitStrategy<D>
     {
     public:
-        void split(const std::vector<Entry> &entries,
-                   const Entry &newEntry,
+        void split(EntrySpan<D> entries,
+                   const Entry<D> &newEntry,
                    std::vector<size_t> &group1,
                    std::vector<size_t> &group2) override;
         std::string getName() const override { return "Linear"; }
     };
 
     // 二次分裂策略
-    class QuadraticSplitStrategy : public SplitStrategy
+    template <size_t D = DynamicDimension>
+    class QuadraticSplitStrategy : public SplitStrategy<D>
     {
     public:
-        void split(const std::vector<Entry> &entries,
-                   const Entry &newEntry,
+        void split(EntrySpan<D> entries,
+                   const Entry<D> &newEntry,
                    std::vector<size_t> &group1,
                    std::vector<size_t> &group2) override;
         std::string getName() const override { return "Quadratic"; }
     };
 
     // R*-tree分裂策略
-    class RStarSplitStrategy : public SplitStrategy
+    template <size_t D = DynamicDimension>
+    class RStarSplitStrategy : public SplitStrategy<D>
     {
     public:
-        void split(const std::vector<Entry> &entries,
-                   const Entry &newEntry,
+        void split(EntrySpan<D> entries,
+                   const Entry<D> &newEntry,
                    std::vector<size_t> &group1,
                    std::vector<size_t> &group2) override;
         std::string getName() const override { return "RStar"; }
     };
 
+    // Ang-Tan线性分裂：每个轴上按条目离节点MBR哪一侧更近分成两组，较小一组不少于最小填充(M/2)的轴中
+    // 选重叠最小（其次面积和最小）的一个；没有这样的轴时在节点MBR最长的轴上按中心排序后从中位切开。
+    // 通常为O(D·M)，分组比Guttman线性分裂均衡得多
+    template <size_t D = DynamicDimension>
+    class AngTanSplitStrategy : public SplitStrategy<D>
+    {
+    public:
+        void split(EntrySpan<D> entries,
+                   const Entry<D> &newEntry,
+                   std::vector<size_t> &group1,
+                   std::vector<size_t> &group2) override;
+        std::string getName() const override { return "AngTan"; }
+    };
+
+    // Revised R*-tree分裂（Beckmann & Seeger）：按周长和选轴；分割位置的目标函数在存在无重叠的分割时
+    // 取两组周长和（越小越好），否则取重叠面积，再用中间高、两端低的权重函数偏向均衡的分割。
+    // 最小填充为30%。节点不记录创建时的MBR，权重函数以节点中间为中心（论文中μ = 0的情形）
+    template <size_t D = DynamicDimension>
+    class RevisedRStarSplitStrategy : public SplitStrategy<D>
+    {
+    public:
+        void split(EntrySpan<D> entries,
+                   const Entry<D> &newEntry,
+                   std::vector<size_t> &group1,
+                   std::vector<size_t> &group2) override;
+        std::string getName() const override { return "RevisedRStar"; }
+    };
+
+    // 拓扑分裂：每个轴上按条目中心排序后在中位处切开，选两半重叠最小（其次周长和最小）的轴。
+    // 只比较每轴一个分割位置，O(D·M log M)，比R*分裂快而分组总是均衡
+    template <size_t D = DynamicDimension>
+    class TopologicalSplitStrategy : public SplitStrategy<D>
+    {
+    public:
+        void split(EntrySpan<D> entries,
+                   const Entry<D> &newEntry,
+                   std::vector<size_t> &group1,
+                   std::vector<size_t> &group2) override;
+        std::string getName() const override { return "Topological"; }
+    };
+
 } // namespace RTree
 
 #endif // RTREE_SPLIT_STRATEGY_H
\ No newline at end of file
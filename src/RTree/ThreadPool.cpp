@@ -0,0 +1,53 @@
+#include "ThreadPool.h"
+
+namespace RTree
+{
+
+    ThreadPool::ThreadPool(size_t threadCount)
+        : m_stop(false)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = 1;
+        }
+
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            m_workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        for (auto &worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]()
+                                 { return m_stop || !m_tasks.empty(); });
+                if (m_stop && m_tasks.empty())
+                {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+
+} // namespace RTree
@@ -0,0 +1,111 @@
+#ifndef RTREE_THREAD_POOL_H
+#define RTREE_THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+
+namespace RTree
+{
+
+    // 固定大小的线程池 - 任务按提交顺序由空闲线程执行
+    // 注意：任务内部不应等待同一线程池中其他任务的结果
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        size_t size() const { return m_workers.size(); }
+
+        // 提交任务，返回可等待的future
+        template <class F>
+        std::future<void> submit(F task)
+        {
+            auto packaged = std::make_shared<std::packaged_task<void()>>(task);
+            std::future<void> result = packaged->get_future();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.push([packaged]()
+                             { (*packaged)(); });
+            }
+            m_condition.notify_one();
+            return result;
+        }
+
+        // 把[0, count)分给线程池并行执行f(i)，返回前等待全部完成
+        template <class F>
+        void parallelFor(size_t count, F f)
+        {
+            std::vector<std::future<void>> futures;
+            futures.reserve(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                futures.push_back(submit([f, i]()
+                                         { f(i); }));
+            }
+            for (auto &future : futures)
+            {
+                future.get();
+            }
+        }
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::queue<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_stop;
+
+        void workerLoop();
+    };
+
+    // 并行排序：每个线程先排序一段，再逐轮两两归并
+    template <class Iter, class Compare>
+    void parallelSort(ThreadPool &pool, Iter first, Iter last, Compare comp)
+    {
+        size_t count = static_cast<size_t>(std::distance(first, last));
+        size_t chunks = std::min(pool.size(), count / 1024);
+        if (chunks <= 1)
+        {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        std::vector<Iter> bounds;
+        for (size_t i = 0; i <= chunks; i++)
+        {
+            bounds.push_back(first + count * i / chunks);
+        }
+
+        pool.parallelFor(chunks, [&](size_t i)
+                         { std::sort(bounds[i], bounds[i + 1], comp); });
+
+        for (size_t width = 1; width < chunks; width *= 2)
+        {
+            size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+            pool.parallelFor(pairs, [&](size_t p)
+                             {
+                                 size_t left = p * 2 * width;
+                                 size_t middle = std::min(left + width, chunks);
+                                 size_t right = std::min(left + 2 * width, chunks);
+                                 if (middle < right)
+                                 {
+                                     std::inplace_merge(bounds[left], bounds[middle], bounds[right], comp);
+                                 } });
+        }
+    }
+
+} // namespace RTree
+
+#endif // RTREE_THREAD_POOL_H
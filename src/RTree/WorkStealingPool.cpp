@@ -0,0 +1,118 @@
+#include "WorkStealingPool.h"
+
+namespace RTree
+{
+
+    namespace
+    {
+        // 当前线程所属的线程池及其队列下标（非工作线程为nullptr）
+        thread_local const WorkStealingPool *t_currentPool = nullptr;
+        thread_local size_t t_currentIndex = 0;
+    }
+
+    WorkStealingPool::WorkStealingPool(size_t threadCount)
+        : m_pending(0), m_nextQueue(0), m_steals(0), m_stop(false)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = 1;
+        }
+
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            m_queues.emplace_back(new WorkerQueue());
+        }
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            m_workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+        }
+        m_wakeup.notify_all();
+        for (auto &worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void WorkStealingPool::submit(std::function<void()> task)
+    {
+        size_t index = t_currentPool == this ? t_currentIndex : m_nextQueue++ % m_queues.size();
+
+        // 先计数再入队，保证取出任务时计数不会变为负数
+        m_pending++;
+        {
+            std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+            m_queues[index]->tasks.push_back(std::move(task));
+        }
+
+        // 持锁后再通知，避免与正在判断是否休眠的工作线程错过唤醒
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_wakeup.notify_one();
+    }
+
+    bool WorkStealingPool::popLocal(size_t index, std::function<void()> &task)
+    {
+        WorkerQueue &queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        m_pending--;
+        return true;
+    }
+
+    bool WorkStealingPool::steal(size_t index, std::function<void()> &task)
+    {
+        for (size_t offset = 1; offset < m_queues.size(); offset++)
+        {
+            WorkerQueue &queue = *m_queues[(index + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                m_pending--;
+                m_steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkStealingPool::workerLoop(size_t index)
+    {
+        t_currentPool = this;
+        t_currentIndex = index;
+
+        while (true)
+        {
+            std::function<void()> task;
+            if (popLocal(index, task) || steal(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wakeup.wait(lock, [this]()
+                          { return m_stop || m_pending > 0; });
+            if (m_stop && m_pending == 0)
+            {
+                return;
+            }
+        }
+    }
+
+} // namespace RTree
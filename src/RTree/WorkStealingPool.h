@@ -0,0 +1,59 @@
+#ifndef RTREE_WORK_STEALING_POOL_H
+#define RTREE_WORK_STEALING_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+
+namespace RTree
+{
+
+    // 工作窃取线程池 - 每个工作线程有自己的任务双端队列：
+    //   工作线程内提交的任务放到本线程队列尾部，并从尾部取出（LIFO，局部性好）；
+    //   空闲线程从其他线程队列的头部窃取（FIFO，取到的通常是较大的任务）。
+    // 外部线程提交的任务轮流分配到各个队列。
+    class WorkStealingPool
+    {
+    public:
+        explicit WorkStealingPool(size_t threadCount = std::thread::hardware_concurrency());
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        size_t size() const { return m_workers.size(); }
+
+        void submit(std::function<void()> task);
+
+        // 被其他线程窃取执行的任务数
+        size_t getStealCount() const { return m_steals.load(); }
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::vector<std::thread> m_workers;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wakeup;
+        std::atomic<size_t> m_pending; // 已提交但尚未被取出的任务数
+        std::atomic<size_t> m_nextQueue;
+        std::atomic<size_t> m_steals;
+        bool m_stop;
+
+        void workerLoop(size_t index);
+        bool popLocal(size_t index, std::function<void()> &task);
+        bool steal(size_t index, std::function<void()> &task);
+    };
+
+} // namespace RTree
+
+#endif // RTREE_WORK_STEALING_POOL_H
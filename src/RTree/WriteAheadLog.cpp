@@ -0,0 +1,389 @@
+#include "WriteAheadLog.h"
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace RTree
+{
+
+    namespace
+    {
+        const char WalMagic[8] = {'R', 'T', 'R', 'E', 'E', 'W', 'A', 'L'};
+        const uint32_t WalVersion = 2;
+        const uint64_t WalHeaderSize = 32; // magic + version + 保留 + 检查点序号 + 使用者的值
+        const uint64_t RecordHeaderSize = 8; // 负载长度 + CRC32
+
+        uint32_t crc32(const unsigned char *data, size_t size)
+        {
+            static const std::vector<uint32_t> table = []
+            {
+                std::vector<uint32_t> result(256);
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    uint32_t value = i;
+                    for (int bit = 0; bit < 8; bit++)
+                    {
+                        value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                    }
+                    result[i] = value;
+                }
+                return result;
+            }();
+
+            uint32_t crc = 0xFFFFFFFFu;
+            for (size_t i = 0; i < size; i++)
+            {
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            }
+            return crc ^ 0xFFFFFFFFu;
+        }
+    } // namespace
+
+    WriteAheadLog::WriteAheadLog(const std::string &path, WalOptions options)
+        : m_path(path), m_options(options), m_serial(0), m_userValue(0), m_file(nullptr),
+          m_appendedLSN(WalHeaderSize), m_durableLSN(WalHeaderSize), m_flushing(false), m_failed(false)
+    {
+        m_file = std::fopen(path.c_str(), "r+b");
+        if (!m_file)
+        {
+            m_file = std::fopen(path.c_str(), "w+b");
+            if (!m_file)
+            {
+                throw std::runtime_error("cannot create " + path);
+            }
+            writeHeader(m_file, 0, 0);
+            syncHandle(m_file);
+            syncFile(path);
+            return;
+        }
+
+        char magic[8];
+        uint32_t version = 0;
+        uint32_t reserved = 0;
+        if (std::fread(magic, 1, sizeof(magic), m_file) != sizeof(magic) ||
+            std::fread(&version, sizeof(version), 1, m_file) != 1 ||
+            std::fread(&reserved, sizeof(reserved), 1, m_file) != 1 ||
+            std::fread(&m_serial, sizeof(m_serial), 1, m_file) != 1 ||
+            std::fread(&m_userValue, sizeof(m_userValue), 1, m_file) != 1 ||
+            std::memcmp(magic, WalMagic, sizeof(magic)) != 0 || version != WalVersion)
+        {
+            std::fclose(m_file);
+            throw std::runtime_error("not a write-ahead log: " + path);
+        }
+        m_appendedLSN = m_durableLSN = recover();
+    }
+
+    WriteAheadLog::~WriteAheadLog()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            // 析构时无法报告写盘失败
+        }
+        if (m_file)
+        {
+            std::fclose(m_file);
+        }
+    }
+
+    uint64_t WriteAheadLog::recover()
+    {
+        // 逐条校验，遇到长度越界或CRC不符（崩溃时写了一半）即停止
+        std::fseek(m_file, 0, SEEK_END);
+        uint64_t fileSize = static_cast<uint64_t>(std::ftell(m_file));
+        uint64_t end = WalHeaderSize;
+        std::vector<unsigned char> payload;
+        std::fseek(m_file, static_cast<long>(end), SEEK_SET);
+        while (end + RecordHeaderSize <= fileSize)
+        {
+            uint32_t header[2];
+            if (std::fread(header, sizeof(uint32_t), 2, m_file) != 2 || header[0] > fileSize - end - RecordHeaderSize)
+            {
+                break;
+            }
+            payload.resize(header[0]);
+            if (std::fread(payload.data(), 1, payload.size(), m_file) != payload.size() ||
+                crc32(payload.data(), payload.size()) != header[1])
+            {
+                break;
+            }
+            end += RecordHeaderSize + header[0];
+        }
+
+        if (end < fileSize)
+        {
+#ifdef __linux__
+            std::fflush(m_file);
+            if (::ftruncate(::fileno(m_file), static_cast<off_t>(end)) != 0)
+            {
+                throw std::runtime_error("cannot truncate " + m_path);
+            }
+#else
+            // 没有ftruncate时把完整的前缀重写一遍
+            std::vector<unsigned char> prefix(static_cast<size_t>(end));
+            std::fseek(m_file, 0, SEEK_SET);
+            std::fread(prefix.data(), 1, prefix.size(), m_file);
+            std::fclose(m_file);
+            m_file = std::fopen(m_path.c_str(), "w+b");
+            if (!m_file || std::fwrite(prefix.data(), 1, prefix.size(), m_file) != prefix.size())
+            {
+                throw std::runtime_error("cannot truncate " + m_path);
+            }
+#endif
+            syncHandle(m_file);
+        }
+        std::fseek(m_file, static_cast<long>(end), SEEK_SET);
+        return end;
+    }
+
+    void WriteAheadLog::replay(const std::function<void(const unsigned char *, size_t)> &visitor) const
+    {
+        std::FILE *file = std::fopen(m_path.c_str(), "rb");
+        if (!file)
+        {
+            throw std::runtime_error("cannot open " + m_path);
+        }
+        // 打开时已截掉不完整的记录，读到文件末尾即可
+        std::vector<unsigned char> payload;
+        std::fseek(file, static_cast<long>(WalHeaderSize), SEEK_SET);
+        while (true)
+        {
+            uint32_t header[2];
+            if (std::fread(header, sizeof(uint32_t), 2, file) != 2)
+            {
+                break;
+            }
+            payload.resize(header[0]);
+            if (std::fread(payload.data(), 1, payload.size(), file) != payload.size())
+            {
+                break;
+            }
+            visitor(payload.data(), payload.size());
+        }
+        std::fclose(file);
+    }
+
+    uint64_t WriteAheadLog::append(const void *payload, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(payload);
+        uint32_t header[2] = {static_cast<uint32_t>(size), crc32(bytes, size)};
+        const unsigned char *headerBytes = reinterpret_cast<const unsigned char *>(header);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffer.insert(m_buffer.end(), headerBytes, headerBytes + RecordHeaderSize);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+        m_appendedLSN += RecordHeaderSize + size;
+        m_stats.records++;
+        return m_appendedLSN;
+    }
+
+    void WriteAheadLog::commit(uint64_t lsn)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_durableLSN < lsn)
+        {
+            if (m_failed)
+            {
+                throw std::runtime_error("write-ahead log failed: " + m_path);
+            }
+            if (m_flushing)
+            {
+                // 跟随者：等领导者写完再检查自己的记录是否已经落盘
+                m_flushed.wait(lock);
+                continue;
+            }
+
+            // 领导者：可选地等一会儿收集更多记录，然后把整个缓冲一次写盘
+            m_flushing = true;
+            if (m_options.groupCommitDelay.count() > 0)
+            {
+                lock.unlock();
+                std::this_thread::sleep_for(m_options.groupCommitDelay);
+                lock.lock();
+            }
+            m_writing.swap(m_buffer);
+            uint64_t target = m_appendedLSN;
+            lock.unlock();
+
+            bool ok = std::fwrite(m_writing.data(), 1, m_writing.size(), m_file) == m_writing.size() &&
+                      std::fflush(m_file) == 0;
+            if (ok && m_options.sync)
+            {
+                try
+                {
+                    syncHandle(m_file);
+                }
+                catch (const std::runtime_error &)
+                {
+                    ok = false;
+                }
+            }
+
+            lock.lock();
+            if (ok)
+            {
+                m_durableLSN = target;
+                m_stats.flushes++;
+                m_stats.bytes += m_writing.size();
+            }
+            else
+            {
+                m_failed = true;
+            }
+            m_writing.clear();
+            m_flushing = false;
+            m_flushed.notify_all();
+        }
+    }
+
+    void WriteAheadLog::flush()
+    {
+        uint64_t lsn;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            lsn = m_appendedLSN;
+        }
+        commit(lsn);
+    }
+
+    void WriteAheadLog::reset(uint64_t serial, uint64_t userValue)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_flushing || !m_buffer.empty())
+        {
+            throw std::logic_error("write-ahead log reset with unflushed records");
+        }
+
+        std::string temporary = m_path + ".tmp";
+        std::FILE *file = std::fopen(temporary.c_str(), "wb");
+        if (!file)
+        {
+            throw std::runtime_error("cannot create " + temporary);
+        }
+        try
+        {
+            writeHeader(file, serial, userValue);
+            syncHandle(file);
+        }
+        catch (...)
+        {
+            std::fclose(file);
+            throw;
+        }
+        std::fclose(file);
+
+        // rename之后新日志才生效；崩溃时看到的要么是旧日志，要么是新的空日志
+        std::fclose(m_file);
+        m_file = nullptr;
+        bool renamed = std::rename(temporary.c_str(), m_path.c_str()) == 0;
+        m_file = std::fopen(m_path.c_str(), "r+b");
+        if (!m_file)
+        {
+            m_failed = true;
+            throw std::runtime_error("cannot open " + m_path);
+        }
+        std::fseek(m_file, 0, SEEK_END);
+        if (!renamed)
+        {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("cannot replace " + m_path);
+        }
+        m_serial = serial;
+        m_userValue = userValue;
+
+        // rename只修改了目录条目：目录落盘前掉电可能回到旧日志，旧日志关联的文件此时还不能删除
+        try
+        {
+            syncDirectory(m_path);
+        }
+        catch (...)
+        {
+            m_failed = true;
+            throw;
+        }
+    }
+
+    WalStats WriteAheadLog::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void WriteAheadLog::writeHeader(std::FILE *file, uint64_t serial, uint64_t userValue)
+    {
+        uint32_t version = WalVersion;
+        uint32_t reserved = 0;
+        if (std::fwrite(WalMagic, 1, sizeof(WalMagic), file) != sizeof(WalMagic) ||
+            std::fwrite(&version, sizeof(version), 1, file) != 1 ||
+            std::fwrite(&reserved, sizeof(reserved), 1, file) != 1 ||
+            std::fwrite(&serial, sizeof(serial), 1, file) != 1 ||
+            std::fwrite(&userValue, sizeof(userValue), 1, file) != 1)
+        {
+            throw std::runtime_error("failed to write " + m_path);
+        }
+    }
+
+    void WriteAheadLog::syncHandle(std::FILE *file)
+    {
+        if (std::fflush(file) != 0)
+        {
+            throw std::runtime_error("failed to write " + m_path);
+        }
+#ifdef __linux__
+        if (::fdatasync(::fileno(file)) != 0)
+        {
+            throw std::runtime_error("failed to sync " + m_path);
+        }
+#endif
+    }
+
+    void WriteAheadLog::syncFile(const std::string &path)
+    {
+#ifdef __linux__
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0 || ::fsync(fd) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            throw std::runtime_error("failed to sync " + path);
+        }
+        ::close(fd);
+
+        // 新建或rename的文件还要让目录条目落盘
+        syncDirectory(path);
+#else
+        (void)path;
+#endif
+    }
+
+    void WriteAheadLog::syncDirectory(const std::string &path)
+    {
+#ifdef __linux__
+        size_t slash = path.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+        int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0 || ::fsync(fd) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            throw std::runtime_error("failed to sync directory " + directory);
+        }
+        ::close(fd);
+#else
+        (void)path;
+#endif
+    }
+
+} // namespace RTree
@@ -0,0 +1,99 @@
+#ifndef RTREE_WRITE_AHEAD_LOG_H
+#define RTREE_WRITE_AHEAD_LOG_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdio>
+#include <cstdint>
+
+namespace RTree
+{
+
+    // 日志的提交方式
+    struct WalOptions
+    {
+        bool sync;                                  // true: 提交时fdatasync，掉电后仍然持久；false: 只写入操作系统缓存，进程崩溃不丢失
+        std::chrono::microseconds groupCommitDelay; // 组提交的领导者在写盘前等待的时间，让更多并发提交并入同一次sync
+
+        WalOptions() : sync(true), groupCommitDelay(0) {}
+    };
+
+    // 日志的统计
+    struct WalStats
+    {
+        size_t records; // 追加的记录数
+        size_t flushes; // 写盘次数（每次把一批记录写入文件，sync模式下同时fdatasync）
+        size_t bytes;   // 写入的字节数
+
+        WalStats() : records(0), flushes(0), bytes(0) {}
+    };
+
+    // 预写日志 - 追加定长头（长度 + CRC32）加负载的记录。append只把记录放进内存缓冲，
+    // commit(lsn)等到该记录写盘后返回：第一个等待者成为领导者，把缓冲中所有记录一次写入并sync，
+    // 其余并发提交者等它完成，这样多个写线程共享一次fdatasync（组提交）。
+    // 文件头带有一个检查点序号和一个使用者的值，由使用者关联对应的检查点。打开已有日志时截掉末尾写了一半的记录。
+    class WriteAheadLog
+    {
+    public:
+        // 打开已有日志，不存在时创建序号为0的空日志；格式不符时抛出std::runtime_error
+        WriteAheadLog(const std::string &path, WalOptions options = WalOptions());
+        ~WriteAheadLog();
+
+        WriteAheadLog(const WriteAheadLog &) = delete;
+        WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+        // 按顺序对每条完整记录调用visitor(payload, size)，不能与append同时调用
+        void replay(const std::function<void(const unsigned char *, size_t)> &visitor) const;
+
+        // 追加一条记录并返回它的LSN，记录此时还在内存中。LSN单调递增，reset之后继续增长
+        uint64_t append(const void *payload, size_t size);
+        // 等到lsn之前的所有记录写盘；写盘失败时抛出std::runtime_error，之后的提交也都失败
+        void commit(uint64_t lsn);
+        // 提交目前追加的所有记录
+        void flush();
+
+        // 用序号为serial、使用者的值为userValue的空日志原子地替换当前日志（写临时文件后rename，
+        // 再让目录落盘）。返回时新日志已经持久生效，调用者可以删除旧日志关联的文件。
+        // 调用者保证期间没有append，已追加的记录应先flush
+        void reset(uint64_t serial, uint64_t userValue = 0);
+
+        uint64_t getSerial() const { return m_serial; }
+        // 与序号一起写在文件头中的值（新建的日志为0）
+        uint64_t getUserValue() const { return m_userValue; }
+        WalStats getStats() const;
+
+        // 把已写入的文件内容以及文件所在目录的条目落盘（检查点文件使用）
+        static void syncFile(const std::string &path);
+        // 把path所在目录的条目落盘（新建、rename或删除文件之后）
+        static void syncDirectory(const std::string &path);
+
+    private:
+        std::string m_path;
+        WalOptions m_options;
+        uint64_t m_serial;
+        uint64_t m_userValue;
+        std::FILE *m_file;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_flushed;
+        std::vector<unsigned char> m_buffer; // 已追加、尚未写盘的记录
+        std::vector<unsigned char> m_writing; // 领导者正在写盘的记录（与m_buffer交换，复用容量）
+        uint64_t m_appendedLSN;              // 已追加记录的末尾
+        uint64_t m_durableLSN;               // 已写盘记录的末尾
+        bool m_flushing;                     // 有领导者正在写盘
+        bool m_failed;
+        WalStats m_stats;
+
+        // 把文件截到完整记录的末尾并返回该偏移（作为初始LSN）
+        uint64_t recover();
+        void writeHeader(std::FILE *file, uint64_t serial, uint64_t userValue);
+        void syncHandle(std::FILE *file);
+    };
+
+} // namespace RTree
+
+#endif // RTREE_WRITE_AHEAD_LOG_H
@@ -3,14 +3,26 @@
 #include <vector>
 #include <random>
 #include <chrono>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cmath>
+#include <limits>
 #include "RTree/RTree.h"
+#include "RTree/QueryExecutor.h"
+#include "RTree/MappedRTree.h"
+#include "RTree/PagedRTree.h"
+#include "RTree/DurableRTree.h"
 
 using namespace RTree;
 
 // 生成随机点用于测试
-std::vector<Point> generateRandomPoints(size_t count, size_t dimension, double min, double max)
+template <size_t D>
+std::vector<Point<D>> generateRandomPoints(size_t count, size_t dimension, double min, double max)
 {
-    std::vector<Point> points;
+    std::vector<Point<D>> points;
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_real_distribution<> dis(min, max);
@@ -33,18 +45,18 @@ void testBasicOperations()
 {
     std::cout << "===== 测试基本操作 =====" << std::endl;
 
-    // 创建R树 - 使用二次分裂策略，最大条目数为16
-    RTree::RTree rtree(16, std::make_shared<QuadraticSplitStrategy>());
+    // 创建R树 - 动态维度，使用二次分裂策略，最大条目数为16
+    ::RTree::RTree<> rtree(16, std::make_shared<QuadraticSplitStrategy<>>());
 
     // 生成一些随机点
-    std::vector<Point> points = generateRandomPoints(50, 2, 0.0, 100.0);
+    std::vector<Point<>> points = generateRandomPoints<DynamicDimension>(50, 2, 0.0, 100.0);
 
     // 插入点
     auto startTime = std::chrono::high_resolution_clock::now();
     for (size_t i = 0; i < points.size(); i++)
     {
         // 创建包含点的区域
-        Region mbr(points[i]);
+        Region<> mbr(points[i]);
         // 将点的索引作为数据插入
         int *data = new int(i);
         rtree.insert(data, sizeof(int), mbr);
@@ -55,7 +67,7 @@ void testBasicOperations()
     std::cout << "插入 " << points.size() << " 个点，耗时 " << duration.count() << " ms" << std::endl;
 
     // 定义搜索区域
-    Region searchRegion;
+    Region<> searchRegion;
     searchRegion.m_low = {25.0, 25.0};
     searchRegion.m_high = {75.0, 75.0};
 
@@ -96,41 +108,88 @@ void testBasicOperations()
     }
 }
 
+// 统计节点数和平均填充率
+template <size_t D>
+void collectNodeStats(const Node<D> *node, size_t &nodeCount, size_t &entryCount)
+{
+    nodeCount++;
+    entryCount += node->getEntryCount();
+    if (!node->isLeaf())
+    {
+        for (size_t i = 0; i < node->getEntryCount(); i++)
+        {
+            collectNodeStats<D>(node->getChild(i), nodeCount, entryCount);
+        }
+    }
+}
+
+// 查询访问的节点数（每个节点视为一次页I/O）：根节点与所有MBR与query相交的子节点
+template <size_t D>
+size_t countNodeAccesses(const Node<D> *node, const Region<D> &query)
+{
+    size_t accesses = 1;
+    if (!node->isLeaf())
+    {
+        for (size_t i = 0; i < node->getEntryCount(); i++)
+        {
+            if (node->getChildMBR(i).intersectsRegion(query))
+            {
+                accesses += countNodeAccesses(node->getChild(i), query);
+            }
+        }
+    }
+    return accesses;
+}
+
 // 比较不同的分裂策略
 void compareSplitStrategies()
 {
     std::cout << "\n===== 比较分裂策略 =====" << std::endl;
 
-    // 生成随机点
-    size_t pointCount = 500;
-    std::vector<Point> points = generateRandomPoints(pointCount, 2, 0.0, 1000.0);
+    // 生成随机点与查询
+    size_t pointCount = 20000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+    std::vector<Point<2>> corners = generateRandomPoints<2>(1000, 2, 0.0, 990.0);
+    std::vector<Region<2>> queries;
+    for (const auto &corner : corners)
+    {
+        Region<2> query;
+        query.m_low = {corner.m_coords[0], corner.m_coords[1]};
+        query.m_high = {corner.m_coords[0] + 10.0, corner.m_coords[1] + 10.0};
+        queries.push_back(query);
+    }
 
     // 测试每种分裂策略
-    std::vector<std::shared_ptr<SplitStrategy>> strategies = {
-        std::make_shared<LinearSplitStrategy>(),
-        std::make_shared<QuadraticSplitStrategy>(),
-        std::make_shared<RStarSplitStrategy>()};
+    std::vector<std::shared_ptr<SplitStrategy<2>>> strategies = {
+        std::make_shared<LinearSplitStrategy<2>>(),
+        std::make_shared<QuadraticSplitStrategy<2>>(),
+        std::make_shared<RStarSplitStrategy<2>>(),
+        std::make_shared<AngTanSplitStrategy<2>>(),
+        std::make_shared<RevisedRStarSplitStrategy<2>>(),
+        std::make_shared<TopologicalSplitStrategy<2>>()};
 
     std::vector<std::string> strategyNames = {
         "Linear (线性)",
         "Quadratic (二次)",
-        "R* (R*树)"};
+        "R* (R*树)",
+        "Ang-Tan (新线性)",
+        "Revised R* (修订R*树)",
+        "Topological (拓扑)"};
 
     for (size_t i = 0; i < strategies.size(); i++)
     {
         std::cout << "\n测试 " << strategyNames[i] << " 分裂策略:" << std::endl;
 
         // 创建树
-        RTree::RTree rtree(50, strategies[i]);
+        ::RTree::RTree<2> rtree(50, strategies[i]);
 
         // 插入点并测量时间
         auto startTime = std::chrono::high_resolution_clock::now();
 
         for (size_t j = 0; j < points.size(); j++)
         {
-            Region mbr(points[j]);
-            int *data = new int(j);
-            rtree.insert(data, sizeof(int), mbr);
+            Region<2> mbr(points[j]);
+            rtree.insert(&points[j], sizeof(Point<2>), mbr);
         }
 
         auto endTime = std::chrono::high_resolution_clock::now();
@@ -138,33 +197,1162 @@ void compareSplitStrategies()
 
         std::cout << "  插入时间: " << insertDuration.count() << " ms" << std::endl;
 
-        // 定义搜索区域
-        Region searchRegion;
-        searchRegion.m_low = {250.0, 250.0};
-        searchRegion.m_high = {750.0, 750.0};
-
-        // 测量搜索时间
+        // 测量查询时间与访问的节点数
+        size_t found = 0, accesses = 0;
         startTime = std::chrono::high_resolution_clock::now();
-        std::vector<void *> results = rtree.search(searchRegion);
+        for (const auto &query : queries)
+        {
+            found += rtree.count(query);
+        }
         endTime = std::chrono::high_resolution_clock::now();
-        auto searchDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        auto searchDuration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+        for (const auto &query : queries)
+        {
+            accesses += countNodeAccesses(rtree.getRoot(), query);
+        }
 
-        std::cout << "  搜索时间: " << searchDuration.count() << " ms" << std::endl;
-        std::cout << "  找到 " << results.size() << " 个点" << std::endl;
+        std::cout << "  " << queries.size() << " 次查询时间: " << searchDuration.count() << " us" << std::endl;
+        std::cout << "  找到 " << found << " 个点，平均每次查询访问 "
+                  << static_cast<double>(accesses) / queries.size() << " 个节点" << std::endl;
 
         // 打印树的统计信息
-        std::cout << "  树高度: " << rtree.getHeight() << std::endl;
+        size_t nodeCount = 0, entryCount = 0;
+        collectNodeStats<2>(rtree.getRoot(), nodeCount, entryCount);
+        std::cout << "  树高度: " << rtree.getHeight() << "，节点数: " << nodeCount << std::endl;
         std::cout << "  数据项数量: " << rtree.getSize() << std::endl;
         std::cout << "  分裂策略: " << rtree.getSplitStrategy()->getName() << std::endl;
+    }
+}
+
+// 分裂微基准：大扇出（M = 50..400）下单次分裂的耗时，以及除以M·log2(M)后的值。
+// R*与Linear的归一化耗时应大致不变，Quadratic本身是O(M²)（选种子与逐个挑选条目）
+void benchmarkSplits()
+{
+    std::cout << "\n===== 分裂微基准 =====" << std::endl;
+
+    std::vector<std::shared_ptr<SplitStrategy<2>>> strategies = {
+        std::make_shared<LinearSplitStrategy<2>>(),
+        std::make_shared<QuadraticSplitStrategy<2>>(),
+        std::make_shared<RStarSplitStrategy<2>>(),
+        std::make_shared<AngTanSplitStrategy<2>>(),
+        std::make_shared<RevisedRStarSplitStrategy<2>>(),
+        std::make_shared<TopologicalSplitStrategy<2>>()};
+
+    const size_t sets = 64;
+    for (size_t fanout : {50, 100, 200, 400})
+    {
+        // 每组为一个满节点的条目加上一个新条目
+        std::vector<std::vector<Entry<2>>> entrySets(sets);
+        std::vector<Entry<2>> newEntries;
+        for (auto &entries : entrySets)
+        {
+            std::vector<Point<2>> corners = generateRandomPoints<2>(fanout + 1, 2, 0.0, 1000.0);
+            for (size_t i = 0; i <= fanout; i++)
+            {
+                Region<2> mbr;
+                mbr.m_low = {corners[i].m_coords[0], corners[i].m_coords[1]};
+                mbr.m_high = {corners[i].m_coords[0] + 5.0, corners[i].m_coords[1] + 5.0};
+                entries.push_back(Entry<2>(mbr, i, nullptr, 0));
+            }
+            newEntries.push_back(entries.back());
+            entries.pop_back();
+        }
+
+        std::cout << "  M = " << fanout << ":";
+        std::vector<size_t> group1, group2;
+        for (const auto &strategy : strategies)
+        {
+            size_t rounds = std::max<size_t>(1, 20000 / fanout);
+            auto startTime = std::chrono::high_resolution_clock::now();
+            for (size_t r = 0; r < rounds; r++)
+            {
+                for (size_t s = 0; s < sets; s++)
+                {
+                    strategy->split(entrySets[s], newEntries[s], group1, group2);
+                }
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - startTime).count() /
+                        (rounds * sets);
+            std::cout << "  " << strategy->getName() << " " << static_cast<size_t>(ns) << " ns（/MlogM "
+                      << ns / (fanout * std::log2(static_cast<double>(fanout))) << "）";
+        }
+        std::cout << std::endl;
+    }
+}
+
+// 同一父节点下各子节点MBR两两重叠面积之和
+template <size_t D>
+double siblingOverlap(const Node<D> *node)
+{
+    if (node->isLeaf())
+    {
+        return 0.0;
+    }
+    double overlap = 0.0;
+    for (size_t i = 0; i < node->getEntryCount(); i++)
+    {
+        for (size_t j = i + 1; j < node->getEntryCount(); j++)
+        {
+            overlap += node->getChildMBR(i).getIntersectingArea(node->getChildMBR(j));
+        }
+        overlap += siblingOverlap(node->getChild(i));
+    }
+    return overlap;
+}
+
+// 比较Guttman插入与R*插入（重叠最小的ChooseSubtree + 强制重插）在偏斜数据上的效果
+void compareInsertModes()
+{
+    std::cout << "\n===== 比较Guttman插入与R*插入 =====" << std::endl;
+
+    // 偏斜数据：点集中在少数几个簇中
+    const size_t pointCount = 100000;
+    const size_t clusterCount = 20;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> uniform(0.0, 1000.0);
+    std::normal_distribution<double> spread(0.0, 8.0);
+    std::vector<Point<2>> centers = generateRandomPoints<2>(clusterCount, 2, 0.0, 1000.0);
+    std::vector<Point<2>> points(pointCount);
+    for (size_t i = 0; i < pointCount; i++)
+    {
+        const Point<2> &center = centers[i % clusterCount];
+        points[i].m_coords = {center.m_coords[0] + spread(gen), center.m_coords[1] + spread(gen)};
+    }
+    std::vector<Region<2>> queries;
+    for (size_t i = 0; i < 2000; i++)
+    {
+        const Point<2> &center = centers[i % clusterCount];
+        double x = center.m_coords[0] + 2.0 * spread(gen), y = center.m_coords[1] + 2.0 * spread(gen);
+        Region<2> query;
+        query.m_low = {x, y};
+        query.m_high = {x + 2.0, y + 2.0};
+        queries.push_back(query);
+    }
+
+    const char *names[] = {"Guttman + Quadratic分裂", "Guttman + R*分裂     ", "R*插入 + R*分裂      "};
+    for (int mode = 0; mode < 3; mode++)
+    {
+        std::shared_ptr<SplitStrategy<2>> strategy;
+        if (mode == 0)
+        {
+            strategy = std::make_shared<QuadraticSplitStrategy<2>>();
+        }
+        else
+        {
+            strategy = std::make_shared<RStarSplitStrategy<2>>();
+        }
+        ::RTree::RTree<2> rtree(32, strategy);
+        if (mode == 2)
+        {
+            rtree.setInsertMode(InsertMode::RStar);
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (auto &point : points)
+        {
+            rtree.insert(&point, sizeof(Point<2>), Region<2>(point));
+        }
+        auto insertTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        size_t found = 0;
+        startTime = std::chrono::high_resolution_clock::now();
+        for (const auto &query : queries)
+        {
+            found += rtree.count(query);
+        }
+        auto queryTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        std::cout << "  " << names[mode] << ": 插入 " << insertTime.count() << " ms，" << queries.size() << " 次查询 "
+                  << queryTime.count() << " us（结果 " << found << "），兄弟重叠面积 " << siblingOverlap(rtree.getRoot())
+                  << "，树高 " << rtree.getHeight() << std::endl;
+    }
+}
+
+// 测试K近邻查询
+void testNearestNeighbors()
+{
+    std::cout << "\n===== 测试K近邻查询 =====" << std::endl;
+
+    size_t pointCount = 10000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+
+    ::RTree::RTree<2> rtree(32, std::make_shared<QuadraticSplitStrategy<2>>());
+    std::vector<int> ids(points.size());
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        ids[j] = static_cast<int>(j);
+        rtree.insert(&ids[j], sizeof(int), Region<2>(points[j]));
+    }
+
+    Point<2> queryPoint(500.0, 500.0);
+    size_t k = 10;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::vector<DistanceEntry> results = rtree.nearest(queryPoint, k);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+    std::cout << "距离 (500, 500) 最近的 " << k << " 个点，耗时 " << duration.count() << " us:" << std::endl;
+    for (const auto &result : results)
+    {
+        int index = *static_cast<int *>(result.data);
+        std::cout << "  点 " << index << ": (" << points[index].m_coords[0] << ", "
+                  << points[index].m_coords[1] << ")，距离 " << result.distance << std::endl;
+    }
+
+    // 增量迭代：取出距离不超过20的所有点，只展开需要的节点
+    NearestIterator<2> it = rtree.nearestIterator(queryPoint);
+    size_t withinRadius = 0;
+    while (it.hasNext() && it.next().distance <= 20.0)
+    {
+        withinRadius++;
+    }
+    std::cout << "距离不超过 20 的点: " << withinRadius << " 个，展开节点 " << it.getExpandedNodes() << " 个" << std::endl;
+}
+
+// 比较完整结果查询与访问者/计数/存在性查询的耗时
+void compareQueryModes()
+{
+    std::cout << "\n===== 比较范围查询方式 =====" << std::endl;
+
+    std::vector<Point<2>> points = generateRandomPoints<2>(100000, 2, 0.0, 1000.0);
+    std::vector<std::pair<Region<2>, void *>> items;
+    items.reserve(points.size());
+    for (auto &point : points)
+    {
+        items.push_back(std::make_pair(Region<2>(point), static_cast<void *>(&point)));
+    }
+
+    ::RTree::RTree<2> rtree(32);
+    rtree.bulkLoad(items);
+
+    std::vector<Region<2>> queries;
+    for (const auto &center : generateRandomPoints<2>(1000, 2, 0.0, 1000.0))
+    {
+        Region<2> query;
+        query.m_low = {center.m_coords[0] - 20.0, center.m_coords[1] - 20.0};
+        query.m_high = {center.m_coords[0] + 20.0, center.m_coords[1] + 20.0};
+        queries.push_back(query);
+    }
+
+    auto run = [&](const char *name, std::function<size_t(const Region<2> &)> query)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        size_t total = 0;
+        for (const auto &region : queries)
+        {
+            total += query(region);
+        }
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+        std::cout << "  " << name << ": " << duration.count() << " us, 结果 " << total << std::endl;
+    };
+
+    run("search().size() ", [&](const Region<2> &region)
+        { return rtree.search(region).size(); });
+    run("visit           ", [&](const Region<2> &region)
+        { return rtree.visit(region, [](void *)
+                             { return true; }); });
+    run("count           ", [&](const Region<2> &region)
+        { return rtree.count(region); });
+    run("exists          ", [&](const Region<2> &region)
+        { return static_cast<size_t>(rtree.exists(region)); });
+
+    // 整批查询只遍历一次树
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<void *>> batch = rtree.searchBatch(queries);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    size_t total = 0;
+    for (const auto &results : batch)
+    {
+        total += results.size();
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    std::cout << "  searchBatch     : " << duration.count() << " us, 结果 " << total << std::endl;
+}
+
+// 在工作窃取线程池上并发执行查询，统计吞吐量和延迟分布
+void testConcurrentQueries()
+{
+    std::cout << "\n===== 测试并发查询执行器 =====" << std::endl;
+
+    std::vector<Point<2>> points = generateRandomPoints<2>(100000, 2, 0.0, 1000.0);
+    std::vector<std::pair<Region<2>, void *>> items;
+    for (auto &point : points)
+    {
+        items.push_back(std::make_pair(Region<2>(point), static_cast<void *>(&point)));
+    }
+    ::RTree::RTree<2> rtree(32);
+    rtree.bulkLoad(items);
+
+    // 2/3范围查询（少量大查询）+ 1/3 K近邻查询
+    std::vector<QueryRequest<2>> requests;
+    std::vector<Point<2>> centers = generateRandomPoints<2>(6000, 2, 0.0, 1000.0);
+    for (size_t i = 0; i < centers.size(); i++)
+    {
+        const Point<2> &center = centers[i];
+        if (i % 3 == 0)
+        {
+            requests.push_back(QueryRequest<2>::nearest(center, 10));
+            continue;
+        }
+        double half = i % 100 == 1 ? 200.0 : 10.0;
+        Region<2> query;
+        query.m_low = {center.m_coords[0] - half, center.m_coords[1] - half};
+        query.m_high = {center.m_coords[0] + half, center.m_coords[1] + half};
+        requests.push_back(QueryRequest<2>::range(query));
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (const auto &request : requests)
+    {
+        if (request.type == QueryType::Range)
+        {
+            rtree.search(request.region);
+        }
+        else
+        {
+            rtree.nearest(request.point, request.k);
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto serialDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+    std::cout << "  单线程顺序执行: " << serialDuration.count() << " ms" << std::endl;
+
+    WorkStealingPool pool;
+    QueryExecutor<2> executor(rtree, pool);
+    startTime = std::chrono::high_resolution_clock::now();
+    std::vector<QueryResult> results = executor.execute(requests);
+    endTime = std::chrono::high_resolution_clock::now();
+    auto parallelDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+    std::vector<double> serviceTimes;
+    size_t splitQueries = 0;
+    for (const auto &result : results)
+    {
+        serviceTimes.push_back(result.serviceTime.count() / 1000.0);
+        if (result.parts > 1)
+        {
+            splitQueries++;
+        }
+    }
+    std::sort(serviceTimes.begin(), serviceTimes.end());
+    std::cout << "  执行器(" << pool.size() << "线程): " << parallelDuration.count() << " ms, 拆分查询 "
+              << splitQueries << " 个, 窃取任务 " << pool.getStealCount() << " 个" << std::endl;
+    std::cout << "  单查询执行耗时 p50 " << serviceTimes[serviceTimes.size() / 2] << " us, p99 "
+              << serviceTimes[serviceTimes.size() * 99 / 100] << " us" << std::endl;
+}
+
+// R-link模式：多个写线程持续插入的同时多个读线程执行范围查询
+void testConcurrentInserts(ConcurrencyMode mode, const std::string &name)
+{
+    std::cout << "\n===== 测试" << name << "并发插入与查询 =====" << std::endl;
+
+    const size_t writerCount = 2;
+    const size_t readerCount = 2;
+    const size_t perWriter = 50000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(writerCount * perWriter, 2, 0.0, 1000.0);
+
+    ::RTree::RTree<2> rtree(32);
+    rtree.setConcurrencyMode(mode);
+
+    std::atomic<bool> writing(true);
+    std::atomic<size_t> queries(0);
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> writers;
+    for (size_t w = 0; w < writerCount; w++)
+    {
+        writers.emplace_back([&, w]()
+                             {
+                                 for (size_t i = w * perWriter; i < (w + 1) * perWriter; i++)
+                                 {
+                                     rtree.insert(&points[i], sizeof(Point<2>), Region<2>(points[i]));
+                                 } });
+    }
+
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < readerCount; r++)
+    {
+        readers.emplace_back([&, r]()
+                             {
+                                 std::mt19937 gen(static_cast<unsigned>(r));
+                                 std::uniform_real_distribution<double> dis(0.0, 980.0);
+                                 while (writing)
+                                 {
+                                     Region<2> query;
+                                     double x = dis(gen), y = dis(gen);
+                                     query.m_low = {x, y};
+                                     query.m_high = {x + 20.0, y + 20.0};
+                                     rtree.count(query);
+                                     queries++;
+                                 } });
+    }
+
+    for (auto &writer : writers)
+    {
+        writer.join();
+    }
+    writing = false;
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+    Region<2> all;
+    all.m_low = {0.0, 0.0};
+    all.m_high = {1000.0, 1000.0};
+    std::cout << "  " << writerCount << " 个写线程插入 " << rtree.getSize() << " 个点，同时 " << readerCount
+              << " 个读线程完成 " << queries << " 次查询，耗时 " << duration.count() << " ms" << std::endl;
+    std::cout << "  插入完成后全范围计数: " << rtree.count(all) << "，树高度 " << rtree.getHeight() << std::endl;
+}
+
+// 预写日志：多个写线程并发插入，比较纯内存、只写日志、组提交fdatasync三种方式的吞吐，再从日志恢复
+void testDurableInserts()
+{
+    std::cout << "\n===== 测试预写日志与组提交 =====" << std::endl;
+
+    const size_t writerCount = 4;
+    const size_t perWriter = 5000;
+    const std::string basePath = "rtree_durable";
+    std::vector<Point<2>> points = generateRandomPoints<2>(writerCount * perWriter, 2, 0.0, 1000.0);
+
+    // insertRange(first, last)插入[first, last)中的点；每个写线程按batchSize分批调用，返回并发插入全部点的耗时
+    auto runWriters = [&](size_t batchSize, const std::function<void(size_t, size_t)> &insertRange)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> writers;
+        for (size_t w = 0; w < writerCount; w++)
+        {
+            writers.emplace_back([&, w]()
+                                 {
+                                     for (size_t i = w * perWriter; i < (w + 1) * perWriter; i += batchSize)
+                                     {
+                                         insertRange(i, std::min(i + batchSize, (w + 1) * perWriter));
+                                     } });
+        }
+        for (auto &writer : writers)
+        {
+            writer.join();
+        }
+        return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                          std::chrono::high_resolution_clock::now() - startTime)
+                                          .count());
+    };
+
+    // 每种配置从空树开始重复rounds轮取最快的一轮，减少机器负载抖动的影响
+    const size_t rounds = 3;
+    auto removeFiles = [&]()
+    {
+        std::remove((basePath + ".wal").c_str());
+        std::remove((basePath + ".ckpt1").c_str());
+    };
+
+    long long baseline = std::numeric_limits<long long>::max();
+    for (size_t r = 0; r < rounds; r++)
+    {
+        ::RTree::RTree<2> memory(32);
+        memory.setConcurrencyMode(ConcurrencyMode::Optimistic);
+        baseline = std::min(baseline, runWriters(1, [&](size_t first, size_t)
+                                                 { memory.insert(&points[first], sizeof(Point<2>), Region<2>(points[first])); }));
+    }
+    std::cout << "  纯内存:                 " << writerCount * perWriter * 1000000LL / std::max(baseline, 1LL) << " 次插入/秒" << std::endl;
+
+    // 逐条提交时每次插入至少一次write（sync模式还有一次fdatasync），达不到纯内存吞吐的80%；
+    // 最后一种配置每批1024条共享一次提交（sync）
+    const char *names[] = {"日志(不sync):           ", "日志(组提交sync):       ", "日志(批量1024条, sync): "};
+    for (int mode = 0; mode < 3; mode++)
+    {
+        WalOptions options;
+        options.sync = mode != 0;
+        long long elapsed = std::numeric_limits<long long>::max();
+        WalStats stats;
+        for (size_t r = 0; r < rounds; r++)
+        {
+            removeFiles();
+            DurableRTree<2> durable(basePath, 32, options);
+            long long roundTime;
+            if (mode < 2)
+            {
+                roundTime = runWriters(1, [&](size_t first, size_t)
+                                       { durable.insert(&points[first], sizeof(Point<2>), Region<2>(points[first])); });
+            }
+            else
+            {
+                roundTime = runWriters(1024, [&](size_t first, size_t last)
+                                       {
+                                           std::vector<std::pair<Region<2>, void *>> items;
+                                           for (size_t i = first; i < last; i++)
+                                           {
+                                               items.emplace_back(Region<2>(points[i]), &points[i]);
+                                           }
+                                           durable.insertBatch(items); });
+            }
+            if (roundTime < elapsed)
+            {
+                elapsed = roundTime;
+                stats = durable.getLogStats();
+            }
+        }
+        std::cout << "  " << names[mode] << writerCount * perWriter * 1000000LL / std::max(elapsed, 1LL)
+                  << " 次插入/秒，相对纯内存 " << 100.0 * baseline / std::max(elapsed, 1LL) << "%，"
+                  << stats.records << " 条记录共写盘 " << stats.flushes << " 次" << std::endl;
+    }
+
+    // 重新打开：载入检查点并重放日志（检查点之后又插入了一批）
+    {
+        DurableRTree<2> durable(basePath, 32);
+        durable.checkpoint();
+        for (size_t i = 0; i < 1000; i++)
+        {
+            durable.insert(&points[i], sizeof(Point<2>), Region<2>(points[i]));
+        }
+    }
+    auto startTime = std::chrono::high_resolution_clock::now();
+    {
+        DurableRTree<2> recovered(basePath, 32);
+        auto recoverTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+        std::cout << "  恢复 " << recovered.getTree().getSize() << " 个条目耗时 " << recoverTime.count() << " ms" << std::endl;
+    }
+    removeFiles();
+}
+
+// 快照：写线程继续插入时，读线程在快照上看到的结果保持不变
+void testSnapshots()
+{
+    std::cout << "\n===== 测试写时复制快照 =====" << std::endl;
+
+    const size_t initial = 100000;
+    const size_t extra = 50000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(initial + extra, 2, 0.0, 1000.0);
+
+    ::RTree::RTree<2> rtree(32);
+    for (size_t i = 0; i < initial; i++)
+    {
+        rtree.insert(&points[i], sizeof(Point<2>), Region<2>(points[i]));
+    }
+    size_t nodesBefore = rtree.getNodeAllocator().getLiveBlocks();
+
+    Region<2> all;
+    all.m_low = {0.0, 0.0};
+    all.m_high = {1000.0, 1000.0};
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::shared_ptr<const Snapshot<2>> snapshot = rtree.snapshot();
+    auto snapshotTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - startTime);
+
+    std::atomic<bool> writing(true);
+    std::atomic<size_t> queries(0);
+    std::atomic<size_t> mismatches(0);
+    std::thread reader([&]()
+                       {
+                           while (writing)
+                           {
+                               if (snapshot->count(all) != initial)
+                               {
+                                   mismatches++;
+                               }
+                               queries++;
+                           } });
+    for (size_t i = initial; i < initial + extra; i++)
+    {
+        rtree.insert(&points[i], sizeof(Point<2>), Region<2>(points[i]));
+    }
+    writing = false;
+    reader.join();
+
+    std::cout << "  创建快照耗时 " << snapshotTime.count() << " us；之后插入 " << extra << " 个点" << std::endl;
+    std::cout << "  快照上完成 " << queries << " 次全范围计数，结果不一致 " << mismatches << " 次；快照计数 "
+              << snapshot->count(all) << "，树计数 " << rtree.count(all) << std::endl;
+    std::cout << "  节点数: 快照前 " << nodesBefore << "，快照存在时 " << rtree.getNodeAllocator().getLiveBlocks();
+    snapshot.reset();
+    std::cout << "，释放快照后 " << rtree.getNodeAllocator().getLiveBlocks() << std::endl;
+}
+
+// 持久化：写出页文件后用mmap打开，直接在映射的页上查询
+void testPageFile()
+{
+    std::cout << "\n===== 测试页文件持久化与mmap打开 =====" << std::endl;
+
+    const size_t pointCount = 500000;
+    const std::string path = "rtree_demo.pages";
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+    std::vector<std::pair<Region<2>, void *>> items;
+    for (auto &point : points)
+    {
+        items.emplace_back(Region<2>(point), &point);
+    }
+
+    // 2D下一个4KB页最多容纳96个条目
+    ::RTree::RTree<2> rtree(96);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    rtree.bulkLoad(items);
+    auto buildTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - startTime);
 
-        // 清理内存
-        for (auto result : results)
+    startTime = std::chrono::high_resolution_clock::now();
+    rtree.save(path);
+    auto saveTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - startTime);
+
+    startTime = std::chrono::high_resolution_clock::now();
+    {
+        MappedRTree<2> mapped(path);
+        auto openTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        Region<2> searchRegion;
+        searchRegion.m_low = {250.0, 250.0};
+        searchRegion.m_high = {300.0, 300.0};
+        std::cout << "  批量装载 " << pointCount << " 个点 " << buildTime.count() << " ms，写出 "
+                  << mapped.getPageCount() << " 页 (" << mapped.getPageSize() << " 字节/页) " << saveTime.count() << " ms" << std::endl;
+        std::cout << "  mmap打开耗时 " << openTime.count() << " us；范围计数: 内存树 " << rtree.count(searchRegion)
+                  << "，映射文件 " << mapped.count(searchRegion) << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+// 测试外存R-tree：树远大于缓冲池时的命中率与I/O
+void testBufferPool()
+{
+    std::cout << "\n===== 测试缓冲池与外存R-tree =====" << std::endl;
+
+    const size_t pointCount = 200000;
+    const size_t frameCount = 1024;
+    const std::string path = "rtree_paged.pages";
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+
+    {
+        PagedRTree<2> paged(path, frameCount, 96, 2);
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            paged.insert(static_cast<id_type>(i), Region<2>(points[i]));
+        }
+        paged.flush();
+        auto insertTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        BufferPool &pool = paged.getBufferPool();
+        BufferPoolStats stats = pool.getStats();
+        std::cout << "  插入 " << pointCount << " 个点 " << insertTime.count() << " ms，文件 " << pool.getPageCount()
+                  << " 页，缓冲池 " << pool.getFrameCount() << " 帧，树高 " << paged.getHeight() << std::endl;
+        std::cout << "  插入期间: 命中 " << stats.hits << "，缺页 " << stats.misses << "，淘汰 " << stats.evictions
+                  << "，写回 " << stats.writes << "，常驻层 >= " << paged.getPinFloor() << std::endl;
+
+        const size_t queryCount = 1000;
+        std::vector<Point<2>> centers = generateRandomPoints<2>(queryCount, 2, 0.0, 990.0);
+        pool.resetStats();
+        size_t found = 0;
+        startTime = std::chrono::high_resolution_clock::now();
+        for (const auto &center : centers)
+        {
+            Region<2> query;
+            query.m_low = {center.m_coords[0], center.m_coords[1]};
+            query.m_high = {center.m_coords[0] + 10.0, center.m_coords[1] + 10.0};
+            found += paged.count(query);
+        }
+        auto queryTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+        stats = pool.getStats();
+        std::cout << "  " << queryCount << " 次范围查询 " << queryTime.count() << " ms，结果 " << found
+                  << "，每次查询缺页 " << static_cast<double>(stats.misses) / queryCount
+                  << "，命中率 " << 100.0 * stats.hits / (stats.hits + stats.misses) << "%" << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+// 比较逐条插入与批量装载的建树耗时和查询耗时
+void compareBulkLoading()
+{
+    std::cout << "\n===== 比较逐条插入与批量装载 =====" << std::endl;
+    std::cout << "  并行装载线程数: " << std::thread::hardware_concurrency() << std::endl;
+
+    size_t pointCount = 100000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+    std::vector<int> ids(points.size());
+    std::vector<std::pair<Region<2>, void *>> items;
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        ids[j] = static_cast<int>(j);
+        items.emplace_back(Region<2>(points[j]), &ids[j]);
+    }
+
+    Region<2> searchRegion;
+    searchRegion.m_low = {250.0, 250.0};
+    searchRegion.m_high = {300.0, 300.0};
+
+    ThreadPool pool;
+    const char *names[] = {"逐条插入    ", "STR批量装载 ", "并行STR装载 "};
+    for (int mode = 0; mode < 3; mode++)
+    {
+        ::RTree::RTree<2> rtree(50, std::make_shared<QuadraticSplitStrategy<2>>());
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        if (mode == 0)
+        {
+            for (const auto &item : items)
+            {
+                rtree.insert(item.second, sizeof(int), item.first);
+            }
+        }
+        else if (mode == 1)
+        {
+            rtree.bulkLoad(items);
+        }
+        else
+        {
+            rtree.bulkLoadParallel(items, pool);
+        }
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto buildDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+        startTime = std::chrono::high_resolution_clock::now();
+        size_t found = 0;
+        for (int q = 0; q < 1000; q++)
         {
-            delete static_cast<int *>(result);
+            found += rtree.search(searchRegion).size();
         }
+        endTime = std::chrono::high_resolution_clock::now();
+        auto searchDuration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+        std::cout << "  " << names[mode] << ": 建树 " << buildDuration.count()
+                  << " ms, 树高度 " << rtree.getHeight() << ", 1000次搜索 " << searchDuration.count()
+                  << " us, 找到 " << found / 1000 << " 个点" << std::endl;
     }
 }
 
+// 大量删除后的树：逐条删除与批量删除都会摘除下溢节点、重插孤儿条目并降低树高
+void testCondenseTree()
+{
+    std::cout << "\n===== 测试删除时的CondenseTree =====" << std::endl;
+
+    const size_t pointCount = 100000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+    std::vector<Point<2>> centers = generateRandomPoints<2>(2000, 2, 0.0, 980.0);
+
+    for (int batch = 0; batch < 2; batch++)
+    {
+        ::RTree::RTree<2> rtree(32);
+        for (auto &point : points)
+        {
+            rtree.insert(&point, sizeof(Point<2>), Region<2>(point));
+        }
+
+        // 从叶子收集(ID, MBR)，随机删除90%
+        std::vector<std::pair<id_type, Region<2>>> items;
+        std::vector<const Node<2> *> stack(1, rtree.getRoot());
+        while (!stack.empty())
+        {
+            const Node<2> *node = stack.back();
+            stack.pop_back();
+            for (size_t i = 0; i < node->getEntryCount(); i++)
+            {
+                if (node->isLeaf())
+                {
+                    items.push_back(std::make_pair(node->getEntry(i).m_id, node->getEntry(i).m_region));
+                }
+                else
+                {
+                    stack.push_back(node->getChild(i));
+                }
+            }
+        }
+        std::shuffle(items.begin(), items.end(), std::mt19937(3));
+        items.resize(pointCount * 9 / 10);
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        if (batch)
+        {
+            rtree.removeBatch(items);
+        }
+        else
+        {
+            for (const auto &item : items)
+            {
+                rtree.remove(item.first, item.second);
+            }
+        }
+        auto removeTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        size_t nodeCount = 0, entryCount = 0;
+        collectNodeStats<2>(rtree.getRoot(), nodeCount, entryCount);
+        size_t found = 0;
+        startTime = std::chrono::high_resolution_clock::now();
+        for (const auto &center : centers)
+        {
+            Region<2> query;
+            query.m_low = {center.m_coords[0], center.m_coords[1]};
+            query.m_high = {center.m_coords[0] + 20.0, center.m_coords[1] + 20.0};
+            found += rtree.count(query);
+        }
+        auto queryTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        std::cout << "  " << (batch ? "removeBatch" : "逐条remove ") << " 删除 " << items.size() << " 个点 "
+                  << removeTime.count() << " ms；剩余 " << rtree.getSize() << " 个点，" << nodeCount << " 个节点，平均填充 "
+                  << static_cast<double>(entryCount) / nodeCount << "，树高 " << rtree.getHeight() << "；"
+                  << centers.size() << " 次查询 " << queryTime.count() << " us（结果 " << found << "）" << std::endl;
+    }
+}
+
+// 移动对象：每轮所有对象移动一小步，比较remove + insert与自底向上的update
+void testMovingObjects()
+{
+    std::cout << "\n===== 测试移动对象的更新 =====" << std::endl;
+
+    const size_t objectCount = 50000;
+    const int rounds = 10;
+    std::vector<Point<2>> start = generateRandomPoints<2>(objectCount, 2, 0.0, 1000.0);
+    std::vector<Point<2>> velocity = generateRandomPoints<2>(objectCount, 2, -1.0, 1.0);
+    Region<2> query;
+    query.m_low = {400.0, 400.0};
+    query.m_high = {600.0, 600.0};
+
+    for (int bottomUp = 0; bottomUp < 2; bottomUp++)
+    {
+        ::RTree::RTree<2> rtree(32);
+        rtree.setIdIndex(bottomUp != 0);
+        std::vector<Point<2>> position = start;
+        std::vector<id_type> ids;
+        for (auto &point : position)
+        {
+            ids.push_back(rtree.insert(&point, sizeof(Point<2>), Region<2>(point)));
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (int round = 0; round < rounds; round++)
+        {
+            for (size_t i = 0; i < objectCount; i++)
+            {
+                Region<2> oldMbr(position[i]);
+                position[i] = Point<2>(position[i].m_coords[0] + velocity[i].m_coords[0],
+                                       position[i].m_coords[1] + velocity[i].m_coords[1]);
+                if (bottomUp)
+                {
+                    rtree.update(ids[i], Region<2>(position[i]));
+                }
+                else
+                {
+                    rtree.remove(ids[i], oldMbr);
+                    ids[i] = rtree.insert(&position[i], sizeof(Point<2>), Region<2>(position[i]));
+                }
+            }
+        }
+        auto updateTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        size_t updates = objectCount * rounds;
+        std::cout << "  " << (bottomUp ? "update        " : "remove + insert") << " " << updates << " 次移动 "
+                  << updateTime.count() << " ms（" << static_cast<size_t>(updates * 1000.0 / std::max<long long>(1, updateTime.count()))
+                  << " 次/秒），查询结果 " << rtree.count(query) << "，树高 " << rtree.getHeight() << std::endl;
+    }
+}
+
+// 互相重叠的大矩形上比较按(ID, MBR)搜索删除与按ID索引删除
+void testIdIndex()
+{
+    std::cout << "\n===== 测试ID索引删除 =====" << std::endl;
+
+    // 边长最大为空间的1/10，很多节点的MBR包含同一个矩形，findLeaf要搜索大量子树
+    const size_t rectCount = 50000;
+    std::vector<Point<2>> corners = generateRandomPoints<2>(rectCount, 2, 0.0, 1000.0);
+    std::vector<Region<2>> rects;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> side(0.0, 100.0);
+    for (const auto &corner : corners)
+    {
+        Region<2> rect;
+        rect.m_low = {corner.m_coords[0], corner.m_coords[1]};
+        rect.m_high = {corner.m_coords[0] + side(rng), corner.m_coords[1] + side(rng)};
+        rects.push_back(rect);
+    }
+
+    for (int indexed = 0; indexed < 2; indexed++)
+    {
+        ::RTree::RTree<2> rtree(32);
+        rtree.setIdIndex(indexed != 0);
+        std::vector<std::pair<id_type, Region<2>>> items;
+        for (const auto &rect : rects)
+        {
+            items.push_back(std::make_pair(rtree.insert(nullptr, 0, rect), rect));
+        }
+        std::shuffle(items.begin(), items.end(), std::mt19937(3));
+        items.resize(rectCount / 2);
+
+        size_t removed = 0;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (const auto &item : items)
+        {
+            removed += (indexed ? rtree.remove(item.first) : rtree.remove(item.first, item.second)) ? 1 : 0;
+        }
+        auto removeTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        std::cout << "  " << (indexed ? "remove(id)     " : "remove(id, MBR)") << " 删除 " << removed << " 个矩形 "
+                  << removeTime.count() << " ms，剩余 " << rtree.getSize() << " 个" << std::endl;
+    }
+}
+
+// 在同一份数据上比较Hilbert R-tree与R*分裂
+void compareHilbertRTree()
+{
+    std::cout << "\n===== 比较Hilbert R-tree与R*分裂 =====" << std::endl;
+
+    size_t pointCount = 100000;
+    size_t maxEntries = 32;
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+    std::vector<int> ids(points.size());
+    std::vector<std::pair<Region<2>, void *>> items;
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        ids[j] = static_cast<int>(j);
+        items.emplace_back(Region<2>(points[j]), &ids[j]);
+    }
+
+    Region<2> world;
+    world.m_low = {0.0, 0.0};
+    world.m_high = {1000.0, 1000.0};
+
+    // 1000个随机查询窗口
+    std::vector<Region<2>> queries;
+    std::vector<Point<2>> corners = generateRandomPoints<2>(1000, 2, 0.0, 980.0);
+    for (const auto &corner : corners)
+    {
+        Region<2> query;
+        query.m_low = {corner.m_coords[0], corner.m_coords[1]};
+        query.m_high = {corner.m_coords[0] + 20.0, corner.m_coords[1] + 20.0};
+        queries.push_back(query);
+    }
+
+    const char *names[] = {"R*分裂逐条插入   ", "Hilbert逐条插入  ", "Hilbert批量装载  "};
+    for (int mode = 0; mode < 3; mode++)
+    {
+        ::RTree::RTree<2> rtree(maxEntries, std::make_shared<RStarSplitStrategy<2>>());
+        if (mode > 0)
+        {
+            rtree.setHilbertCurve(HilbertCurve<2>(world));
+            rtree.setInsertMode(InsertMode::Hilbert);
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        if (mode < 2)
+        {
+            for (const auto &item : items)
+            {
+                rtree.insert(item.second, sizeof(int), item.first);
+            }
+        }
+        else
+        {
+            rtree.bulkLoad(items);
+        }
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto buildDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+        startTime = std::chrono::high_resolution_clock::now();
+        size_t found = 0;
+        for (const auto &query : queries)
+        {
+            found += rtree.search(query).size();
+        }
+        endTime = std::chrono::high_resolution_clock::now();
+        auto searchDuration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+        size_t nodeCount = 0, entryCount = 0;
+        collectNodeStats<2>(rtree.getRoot(), nodeCount, entryCount);
+
+        std::cout << "  " << names[mode] << ": 建树 " << buildDuration.count() << " ms, 节点 " << nodeCount
+                  << ", 填充率 " << 100.0 * entryCount / (nodeCount * maxEntries) << "%, 1000次搜索 "
+                  << searchDuration.count() << " us, 找到 " << found << " 个点" << std::endl;
+    }
+}
+
+// 比较节点布局：经纬度数据上SoA边界块的占用与查询耗时（float边界的叶子命中用double区域复核，结果相同）
+void compareFloatBounds()
+{
+    std::cout << "\n===== 比较double/float边界 =====" << std::endl;
+
+    const size_t pointCount = 200000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1.0);
+    std::vector<int> ids(points.size());
+    std::vector<std::pair<Region<2>, void *>> items;
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        ids[j] = static_cast<int>(j);
+        Region<2> location;
+        location.m_low = {points[j].m_coords[0] * 360.0 - 180.0, points[j].m_coords[1] * 180.0 - 90.0};
+        location.m_high = location.m_low;
+        items.emplace_back(location, &ids[j]);
+    }
+
+    std::vector<Region<2>> queries;
+    std::vector<Point<2>> corners = generateRandomPoints<2>(2000, 2, 0.0, 0.99);
+    for (const auto &corner : corners)
+    {
+        Region<2> query;
+        query.m_low = {corner.m_coords[0] * 360.0 - 180.0, corner.m_coords[1] * 180.0 - 90.0};
+        query.m_high = {query.m_low[0] + 2.0, query.m_low[1] + 1.0};
+        queries.push_back(query);
+    }
+
+    const NodeLayout layouts[] = {NodeLayout::Entries, NodeLayout::StructOfArrays, NodeLayout::StructOfArraysFloat};
+    const char *names[] = {"Entries      ", "double SoA   ", "float SoA    "};
+    for (int i = 0; i < 3; i++)
+    {
+        ::RTree::RTree<2> rtree(64, std::make_shared<RStarSplitStrategy<2>>(), layouts[i]);
+        rtree.bulkLoad(items);
+
+        // 这三种布局下编号0以外的块都是SoA边界块
+        const NodeAllocator &allocator = rtree.getNodeAllocator();
+        size_t boundsBytes = 0;
+        for (size_t c = 1; c < allocator.getSizeClassCount(); c++)
+        {
+            boundsBytes += allocator.getLiveBlocks(c) * allocator.getBlockSize(c);
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        size_t found = 0;
+        for (const auto &query : queries)
+        {
+            found += rtree.search(query).size();
+        }
+        auto searchDuration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        std::cout << "  " << names[i] << ": SoA边界块 " << boundsBytes / 1024 << " KB, 2000次搜索 "
+                  << searchDuration.count() << " us, 找到 " << found << " 个点" << std::endl;
+    }
+}
+
+// 比较内部节点保存完整条目与只保存子节点指针+量化编码（QR-tree）时的内部节点内存、插入和查询
+void compareQuantizedNodes()
+{
+    std::cout << "\n===== 比较量化的内部节点 =====" << std::endl;
+
+    const size_t pointCount = 200000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+    std::vector<int> ids(points.size());
+    std::vector<Region<2>> queries;
+    std::vector<Point<2>> corners = generateRandomPoints<2>(2000, 2, 0.0, 990.0);
+    for (const auto &corner : corners)
+    {
+        Region<2> query;
+        query.m_low = corner.m_coords;
+        query.m_high = {corner.m_coords[0] + 10.0, corner.m_coords[1] + 10.0};
+        queries.push_back(query);
+    }
+
+    const NodeLayout layouts[] = {NodeLayout::Entries, NodeLayout::Quantized16, NodeLayout::Quantized8};
+    const char *names[] = {"Entries    ", "Quantized16", "Quantized8 "};
+    for (int i = 0; i < 3; i++)
+    {
+        ::RTree::RTree<2> rtree(16, std::make_shared<RStarSplitStrategy<2>>(), layouts[i]);
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (size_t j = 0; j < points.size(); j++)
+        {
+            ids[j] = static_cast<int>(j);
+            rtree.insert(&ids[j], sizeof(int), Region<2>(points[j]));
+        }
+        auto insertDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        // 叶子在这几种布局下都是编号0的块，其余的块都属于内部节点
+        size_t leafCount = 0;
+        size_t internalCount = 0;
+        std::vector<const Node<2> *> stack(1, rtree.getRoot());
+        while (!stack.empty())
+        {
+            const Node<2> *node = stack.back();
+            stack.pop_back();
+            (node->isLeaf() ? leafCount : internalCount)++;
+            for (size_t c = 0; !node->isLeaf() && c < node->getEntryCount(); c++)
+            {
+                stack.push_back(node->getChild(c));
+            }
+        }
+        const NodeAllocator &allocator = rtree.getNodeAllocator();
+        size_t liveBytes = 0;
+        for (size_t c = 0; c < allocator.getSizeClassCount(); c++)
+        {
+            liveBytes += allocator.getLiveBlocks(c) * allocator.getBlockSize(c);
+        }
+        size_t internalBytes = liveBytes - leafCount * allocator.getBlockSize();
+
+        startTime = std::chrono::high_resolution_clock::now();
+        size_t found = 0;
+        for (const auto &query : queries)
+        {
+            found += rtree.count(query);
+        }
+        auto searchDuration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - startTime);
+
+        std::cout << "  " << names[i] << ": 内部节点 " << internalCount << " 个共 " << internalBytes / 1024
+                  << " KB，插入 " << insertDuration.count() << " ms，2000次计数 " << searchDuration.count()
+                  << " us，结果 " << found << std::endl;
+    }
+}
+
+// 对比同一份2D数据在动态维度与固定维度下的插入和查询耗时
+template <size_t D>
+void runDimensionMode(const std::string &name, const std::vector<Point<D>> &points, const Region<D> &searchRegion)
+{
+    ::RTree::RTree<D> rtree(50, std::make_shared<QuadraticSplitStrategy<D>>());
+    std::vector<int> ids(points.size());
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        ids[j] = static_cast<int>(j);
+        rtree.insert(&ids[j], sizeof(int), Region<D>(points[j]));
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto insertDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+    startTime = std::chrono::high_resolution_clock::now();
+    size_t found = 0;
+    for (int q = 0; q < 100; q++)
+    {
+        found += rtree.search(searchRegion).size();
+    }
+    endTime = std::chrono::high_resolution_clock::now();
+    auto searchDuration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+    std::cout << "  " << name << ": 插入 " << insertDuration.count() << " ms, 100次搜索 "
+              << searchDuration.count() << " us, 找到 " << found / 100 << " 个点" << std::endl;
+}
+
+void compareDimensionModes()
+{
+    std::cout << "\n===== 比较动态维度与固定维度 =====" << std::endl;
+
+    size_t pointCount = 20000;
+    std::vector<Point<2>> points = generateRandomPoints<2>(pointCount, 2, 0.0, 1000.0);
+    std::vector<Point<>> dynamicPoints;
+    for (const auto &p : points)
+    {
+        dynamicPoints.emplace_back(std::vector<double>(p.m_coords.begin(), p.m_coords.end()));
+    }
+
+    Region<> dynamicSearch;
+    dynamicSearch.m_low = {250.0, 250.0};
+    dynamicSearch.m_high = {750.0, 750.0};
+    Region<2> fixedSearch;
+    fixedSearch.m_low = {250.0, 250.0};
+    fixedSearch.m_high = {750.0, 750.0};
+
+    runDimensionMode<DynamicDimension>("RTree<>  (std::vector)", dynamicPoints, dynamicSearch);
+    runDimensionMode<2>("RTree<2> (std::array) ", points, fixedSearch);
+}
+
 // 主函数
 int main()
 {
@@ -177,5 +1365,60 @@ int main()
     // 比较分裂策略
     compareSplitStrategies();
 
+    // 分裂微基准
+    benchmarkSplits();
+
+    // 比较插入模式
+    compareInsertModes();
+
+    // 测试K近邻查询
+    testNearestNeighbors();
+
+    // 比较范围查询方式
+    compareQueryModes();
+
+    // 测试并发查询
+    testConcurrentQueries();
+
+    // 测试R-link并发插入
+    testConcurrentInserts(ConcurrencyMode::RLink, "R-link");
+    testConcurrentInserts(ConcurrencyMode::Optimistic, "乐观锁耦合");
+
+    // 测试预写日志
+    testDurableInserts();
+
+    // 测试快照
+    testSnapshots();
+
+    // 测试页文件持久化
+    testPageFile();
+
+    // 测试缓冲池
+    testBufferPool();
+
+    // 比较批量装载
+    compareBulkLoading();
+
+    // 比较Hilbert R-tree
+    compareHilbertRTree();
+
+    // 测试删除
+    testCondenseTree();
+
+    // 测试ID索引删除
+    testIdIndex();
+
+    // 测试移动对象的更新
+    testMovingObjects();
+
+    // 比较double/float边界
+    compareFloatBounds();
+
+    // 比较量化的内部节点
+    compareQuantizedNodes();
+
+    // 比较维度模式
+    compareDimensionModes();
+
     return 0;
 }